@@ -27,11 +27,38 @@
     
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <math.h>
 #include "../tiny-json.h"
+#include "../tiny-jsonw.h"
+#include "../tiny-json-pipeline.h"
+#include "../tiny-json-index.h"
+#include "../tiny-json-predictor.h"
+#include "../tiny-json-mmap.h"
+#include "../tiny-json-ndjson.h"
+#include "../tiny-json-aggregate.h"
+#include "../tiny-json-schema.h"
+#include "../tiny-json-inflate.h"
+#include "../tiny-json-rpc.h"
+#include "../tiny-json-shm.h"
+#include "../tiny-json-numeric.h"
+#include "../tiny-json-soa.h"
+#ifdef TINY_JSON_USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef __linux__
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#endif
 
 
 
@@ -363,6 +390,1407 @@ int badformat( void ) {
     done();
 }
 
+static int utf16( void ) {
+    json_t pool[4];
+    unsigned const qty = sizeof pool / sizeof *pool;
+
+    char str[] = "{"
+                     "\"ascii\": \"The quick brown fox jumps over the lazy dog\","
+                     "\"mixed\": \"Elu\xC3\xA8re \xE2\x82\xAC \xF0\x9D\x84\x9E.\","
+                     "\"bad\":   \"\xC0\xAF\""
+                 "}";
+    json_t const* json = json_create( str, pool, qty );
+    check( json );
+
+    uint16_t buff[64];
+    unsigned const cap = sizeof buff / sizeof *buff;
+
+    json_t const* ascii = json_getProperty( json, "ascii" );
+    check( ascii );
+    int len = json_getUtf16( ascii, buff, cap );
+    check( len == 43 );
+    char const* value = json_getValue( ascii );
+    for( int i = 0; i <= len; ++i )
+        check( buff[i] == (unsigned char)value[i] );
+
+    len = json_getUtf16( ascii, buff, 10 );
+    check( len == 43 );
+    check( buff[8] == 'k' && buff[9] == 0 );
+
+    json_t const* mixed = json_getProperty( json, "mixed" );
+    check( mixed );
+    static uint16_t const expected[] = {
+        'E', 'l', 'u', 0x00E8, 'r', 'e', ' ', 0x20AC, ' ', 0xD834, 0xDD1E, '.', 0
+    };
+    len = json_getUtf16( mixed, buff, cap );
+    check( len == 12 );
+    for( int i = 0; i <= len; ++i )
+        check( buff[i] == expected[i] );
+
+    len = json_getUtf16( mixed, buff, 11 );
+    check( len == 12 );
+    check( buff[8] == ' ' && buff[9] == 0 );
+
+    wchar_t wbuff[16];
+    len = json_getWide( mixed, wbuff, sizeof wbuff / sizeof *wbuff );
+    check( len == ( sizeof( wchar_t ) > 2 ? 11 : 12 ) );
+    check( wbuff[3] == 0x00E8 && wbuff[len] == 0 );
+
+    json_t const* bad = json_getProperty( json, "bad" );
+    check( bad );
+    check( -1 == json_getUtf16( bad, buff, cap ) );
+
+    done();
+}
+
+static int wide( void ) {
+    jsonW_t wpool[6];
+    unsigned const wqty = sizeof wpool / sizeof *wpool;
+    json_t pool[6];
+    unsigned const qty = sizeof pool / sizeof *pool;
+
+    wchar_t wstr[] = L"{\"name\":\"Eluère\",\"age\":32,\"list\":[true,-0.5]}";
+    jsonW_t const* wjson = json_createW( wstr, wpool, wqty );
+    check( wjson );
+
+    char str[] = "{\"name\":\"peter\",\"age\":32}";
+    json_t const* json = json_create( str, pool, qty );
+    check( json );
+
+    jsonW_t const* name = json_getPropertyW( wjson, L"name" );
+    check( name );
+    check( JSON_TEXT == json_getTypeW( name ) );
+    check( !wcscmp( L"Eluère", json_getValueW( name ) ) );
+    check( !wcscmp( L"name", json_getNameW( name ) ) );
+
+    jsonW_t const* age = json_getPropertyW( wjson, L"age" );
+    check( age );
+    check( JSON_INTEGER == json_getTypeW( age ) );
+    check( 32 == json_getIntegerW( age ) );
+    check( json_getInteger( json_getProperty( json, "age" ) ) == json_getIntegerW( age ) );
+
+    jsonW_t const* list = json_getPropertyW( wjson, L"list" );
+    check( list );
+    jsonW_t const* element = json_getChildW( list );
+    check( element );
+    check( true == json_getBooleanW( element ) );
+    element = json_getSiblingW( element );
+    check( element );
+    check( -0.5 == json_getRealW( element ) );
+    check( !json_getSiblingW( element ) );
+
+    check( !wcscmp( L"32", json_getPropertyValueW( wjson, L"age" ) ) );
+    check( !strcmp( "peter", json_getPropertyValue( json, "name" ) ) );
+
+    done();
+}
+
+static int arena( void ) {
+    json_t mem[16];
+    jsonArena_t shared;
+    json_arenaInit( &shared, mem, sizeof mem / sizeof *mem );
+    check( 0 == json_arenaUsed( &shared ) );
+
+    jsonArenaPool_t apool0, apool1;
+    jsonPool_t* pool0 = json_arenaPoolInit( &apool0, &shared, 4 );
+    jsonPool_t* pool1 = json_arenaPoolInit( &apool1, &shared, 4 );
+
+    char str0[] = "{\"a\":1,\"b\":[true,false]}";
+    json_t const* json0 = json_createWithPool( str0, pool0 );
+    check( json0 );
+    check( 8 == json_arenaUsed( &shared ) );
+
+    char str1[] = "{\"c\":\"text\"}";
+    json_t const* json1 = json_createWithPool( str1, pool1 );
+    check( json1 );
+    check( 12 == json_arenaUsed( &shared ) );
+
+    char str2[] = "{\"d\":null}";
+    json_t const* json2 = json_createWithPool( str2, pool0 );
+    check( json2 );
+    check( 12 == json_arenaUsed( &shared ) );
+
+    check( 1 == json_getInteger( json_getProperty( json0, "a" ) ) );
+    check( !strcmp( "text", json_getPropertyValue( json1, "c" ) ) );
+    check( JSON_NULL == json_getType( json_getProperty( json2, "d" ) ) );
+    json_t const* b = json_getProperty( json0, "b" );
+    check( b );
+    check( false == json_getBoolean( json_getSibling( json_getChild( b ) ) ) );
+
+    char str3[] = "{\"e\":[1,2,3,4,5,6,7,8]}";
+    check( !json_createWithPool( str3, pool1 ) );
+    check( 16 == json_arenaUsed( &shared ) );
+    int i;
+    for( i = 0; i < 3; ++i ) {
+        char str[] = "{\"f\":1}";
+        check( !json_createWithPool( str, i % 2 ? pool0 : pool1 ) );
+    }
+    check( 16 == shared.nextFree );
+
+    json_arenaReset( &shared );
+    check( 0 == json_arenaUsed( &shared ) );
+    pool1 = json_arenaPoolInit( &apool1, &shared, 0 );
+    char str4[] = "{\"e\":[1,2,3,4,5,6,7,8]}";
+    check( json_createWithPool( str4, pool1 ) );
+    check( 16 == json_arenaUsed( &shared ) );
+
+    done();
+}
+
+static int destroyed = 0;
+
+static void destroyDoc( jsonDoc_t* doc ) {
+    ++destroyed;
+    doc->root = NULL;
+}
+
+static int document( void ) {
+    json_t mem[4];
+    jsonArena_t shared;
+    json_arenaInit( &shared, mem, sizeof mem / sizeof *mem );
+    jsonArenaPool_t apool;
+    jsonPool_t* pool = json_arenaPoolInit( &apool, &shared, 0 );
+
+    jsonDoc_t doc;
+    char bad[] = "{\"a\":}";
+    check( !json_docCreate( &doc, bad, pool, destroyDoc ) );
+
+    char str[] = "{\"a\":\"b\"}";
+    json_t const* root = json_docCreate( &doc, str, pool, destroyDoc );
+    check( root );
+    check( root == json_docRoot( &doc ) );
+    check( !strcmp( "b", json_getPropertyValue( json_docRoot( &doc ), "a" ) ) );
+
+    json_docRetain( &doc );
+    json_docRetain( &doc );
+    json_docRelease( &doc );
+    json_docRelease( &doc );
+    check( 0 == destroyed );
+    json_docRelease( &doc );
+    check( 1 == destroyed );
+    check( !json_docRoot( &doc ) );
+
+    done();
+}
+
+struct stream {
+    int read;
+    int consumed;
+    int errors;
+};
+
+static size_t streamRead( void* ctx, char* buf, size_t cap ) {
+    struct stream* stream = ctx;
+    if ( stream->read == 1000 ) return 0;
+    int const n = stream->read++;
+    if ( n % 100 == 99 ) return snprintf( buf, cap, "{\"n\":%d", n );
+    if ( n % 100 == 98 ) return snprintf( buf, cap, "{\"n\":%d,\"s\":\"%*s\"}", n, (int)cap, "" );
+    if ( n % 100 == 97 ) {
+        int const head = snprintf( 0, 0, "{\"n\":%d,\"s\":\"", n );
+        return snprintf( buf, cap + 1, "{\"n\":%d,\"s\":\"%*s\"}", n, (int)cap - head - 2, "" );
+    }
+    return snprintf( buf, cap, "{\"n\":%d,\"list\":[%d,%d]}", n, n, -n );
+}
+
+static void streamConsume( void* ctx, json_t const* json ) {
+    struct stream* stream = ctx;
+    int const n = stream->consumed++;
+    if ( n % 100 >= 98 ) {
+        if ( json ) ++stream->errors;
+        return;
+    }
+    if ( !json ) {
+        ++stream->errors;
+        return;
+    }
+    json_t const* property = json_getProperty( json, "n" );
+    if ( !property || json_getInteger( property ) != n ) ++stream->errors;
+}
+
+static int pipeline( void ) {
+    struct stream stream = { 0, 0, 0 };
+    jsonPipeline_t const pipeline = {
+        .parsers = 3,
+        .depth = 4,
+        .bufferSize = 64,
+        .poolSize = 5,
+        .ctx = &stream,
+        .read = streamRead,
+        .consume = streamConsume
+    };
+    check( 0 == json_pipelineRun( &pipeline ) );
+    check( 1000 == stream.read );
+    check( 1000 == stream.consumed );
+    check( 0 == stream.errors );
+    done();
+}
+
+static bool equal( json_t const* a, json_t const* b ) {
+    for( ; a && b; a = json_getSibling( a ), b = json_getSibling( b ) ) {
+        if ( json_getType( a ) != json_getType( b ) ) return false;
+        char const* aname = json_getName( a );
+        char const* bname = json_getName( b );
+        if ( !aname != !bname || ( aname && strcmp( aname, bname ) ) ) return false;
+        jsonType_t const type = json_getType( a );
+        if ( type == JSON_OBJ || type == JSON_ARRAY ) {
+            if ( !equal( json_getChild( a ), json_getChild( b ) ) ) return false;
+        }
+        else if ( strcmp( json_getValue( a ), json_getValue( b ) ) ) return false;
+    }
+    return !a && !b;
+}
+
+static bool sameAsCreate( char const* text, unsigned int threads ) {
+    size_t const len = strlen( text );
+    char* const str0 = malloc( len + 1 );
+    char* const str1 = malloc( len + 1 );
+    json_t* const mem0 = malloc( ( len / 2 + 2 ) * sizeof( json_t ) );
+    json_t* const mem1 = malloc( ( len / 2 + 2 ) * sizeof( json_t ) );
+    memcpy( str0, text, len + 1 );
+    memcpy( str1, text, len + 1 );
+    jsonIndex_t index;
+    bool result = false;
+    if ( !json_indexBuild( &index, str1, len, threads ) ) {
+        jsonArena_t shared;
+        json_arenaInit( &shared, mem1, len / 2 + 2 );
+        jsonArenaPool_t apool;
+        json_t const* json0 = json_create( str0, mem0, len / 2 + 2 );
+        json_t const* json1 = json_createWithIndex( str1, index.pos, index.qty,
+                                  json_arenaPoolInit( &apool, &shared, 0 ) );
+        result = !json0 == !json1 && ( !json0 || equal( json0, json1 ) );
+        json_indexFree( &index );
+    }
+    free( mem1 );
+    free( mem0 );
+    free( str1 );
+    free( str0 );
+    return result;
+}
+
+static int structuralIndex( void ) {
+    static char const* const texts[] = {
+        "{}", " [ ] ", "{\"a\":[]}", "{\"a\":[{},{}]}", "[1,2,[3,4],{\"x\":-5e3}]",
+        "{\"a\" : \"\\tThis text: \\\"Hello\\\".\\n\", \"b\" :true , \"c\":null}",
+        "{\"max\":9223372036854775807,\"min\":-9223372036854775808,\"r\":0.5}",
+        "{\"qwerty\":false,}", "{\"a\":[0,]}", "{,\"a\":1, , \"b\":2,,,,}",
+        "{\"var\":true} text outside json", "[\"a\\\\\",\"b\"]", "[\"\\u00e8\"]",
+        "{\"var:true}", "{\"var\":tr}", "{\"var\":true", "{\"var\":truep}",
+        "{\"var\":0s}", "{\"var\":9223372036854775808}", "{\"var\":,9}", "{\"var\":}",
+        "{\"var\":,}", "{\"a\" x :1}", "{\"a\":{} x}", "[1 2]", "{\"a\":1:2}", "[1,]]",
+        "{\"a\":\"b\" \"c\"}", "[{]}", "x{}", "{\"a\":\"\\x\"}", "[\"a\"b]", "{1:2}"
+    };
+    unsigned int i;
+    for( i = 0; i < sizeof texts / sizeof *texts; ++i )
+        check( sameAsCreate( texts[i], 1 ) );
+
+    enum { items = 40000 };
+    char* const big = malloc( items * 40 + 16 );
+    check( big );
+    char* ptr = big;
+    *ptr++ = '[';
+    for( i = 0; i < items; ++i )
+        ptr += sprintf( ptr, "{\"k\\\"%u\":[%u,\"\\\\\",true]},", i, i );
+    strcpy( ptr - 1, "]" );
+    bool const same = sameAsCreate( big, 4 );
+    free( big );
+    check( same );
+
+    done();
+}
+
+static int parent( void ) {
+#ifdef TINY_JSON_USE_PARENT
+    json_t pool[8];
+    unsigned const qty = sizeof pool / sizeof *pool;
+    char str[] = "{\"a\":{\"b\":[1,{\"c\":null}]},\"d\":true}";
+    json_t const* json = json_create( str, pool, qty );
+    check( json );
+    check( !json_getParent( json ) );
+    check( 0 == json_getDepth( json ) );
+
+    json_t const* a = json_getProperty( json, "a" );
+    json_t const* b = json_getProperty( a, "b" );
+    json_t const* one = json_getChild( b );
+    json_t const* obj = json_getSibling( one );
+    json_t const* c = json_getProperty( obj, "c" );
+    json_t const* d = json_getProperty( json, "d" );
+    check( a && b && one && obj && c && d );
+
+    check( json_getParent( c ) == obj );
+    check( json_getParent( obj ) == b );
+    check( json_getParent( one ) == b );
+    check( json_getParent( b ) == a );
+    check( json_getParent( a ) == json );
+    check( json_getParent( d ) == json );
+    check( 4 == json_getDepth( c ) );
+    check( 3 == json_getDepth( obj ) );
+    check( 1 == json_getDepth( d ) );
+
+    unsigned int levels = 0;
+    for( json_t const* i = c; i; i = json_getParent( i ) ) ++levels;
+    check( levels == json_getDepth( c ) + 1 );
+#endif
+    done();
+}
+
+static int span( void ) {
+#ifdef TINY_JSON_USE_SPAN
+    json_t pool[12];
+    unsigned const qty = sizeof pool / sizeof *pool;
+    char const original[] = "{ \"route\": \"a\", \"payload\": { \"x\": [1, \"two\\n\", {}], \"y\": null }, \"z\": 3 }";
+    char str[ sizeof original ];
+    memcpy( str, original, sizeof original );
+    json_t const* json = json_create( str, pool, qty );
+    check( json );
+
+    size_t length;
+    char const* begin = json_getSpan( json, &length );
+    check( begin == str );
+    check( length == sizeof original - 1 );
+    check( 8 == json_getDescendants( json ) );
+
+    json_t const* payload = json_getProperty( json, "payload" );
+    check( payload );
+    begin = json_getSpan( payload, &length );
+    char const expected[] = "{ \"x\": [1, \"two\\n\", {}], \"y\": null }";
+    check( length == sizeof expected - 1 );
+    check( !memcmp( original + ( begin - str ), expected, length ) );
+    check( 5 == json_getDescendants( payload ) );
+    check( payload + json_getDescendants( payload ) + 1 == json_getProperty( json, "z" ) );
+
+    json_t const* x = json_getProperty( payload, "x" );
+    check( x );
+    check( 3 == json_getDescendants( x ) );
+    json_t const* empty = json_getSibling( json_getSibling( json_getChild( x ) ) );
+    check( empty );
+    begin = json_getSpan( empty, &length );
+    check( 2 == length && !memcmp( original + ( begin - str ), "{}", 2 ) );
+    check( 0 == json_getDescendants( empty ) );
+#endif
+    done();
+}
+
+static bool childrenTogether( json_t const* json ) {
+    json_t const* child;
+    for( child = json_getChild( json ); child; child = json_getSibling( child ) ) {
+        json_t const* sibling = json_getSibling( child );
+        if ( sibling && sibling != child + 1 ) return false;
+        jsonType_t const type = json_getType( child );
+        if ( ( type == JSON_OBJ || type == JSON_ARRAY ) && !childrenTogether( child ) )
+            return false;
+    }
+    return true;
+}
+
+static int compact( void ) {
+    json_t pool[16];
+    unsigned const qty = sizeof pool / sizeof *pool;
+    char str[] = "{\"a\":{\"b\":[1,{\"c\":null},2]},\"d\":[true,[]],\"e\":\"f\"}";
+    json_t const* json = json_create( str, pool, qty );
+    check( json );
+    check( !childrenTogether( json ) );
+
+    json_t mem[16];
+    jsonArena_t arena;
+    json_arenaInit( &arena, mem, sizeof mem / sizeof *mem );
+    jsonArenaPool_t apool;
+    json_t const* copy = json_compact( json, json_arenaPoolInit( &apool, &arena, 4 ) );
+    check( copy == mem );
+    check( equal( json, copy ) );
+    check( childrenTogether( copy ) );
+    check( json_arenaUsed( &arena ) == 12 );
+#ifdef TINY_JSON_USE_PARENT
+    json_t const* c = json_getProperty( json_getSibling( json_getChild(
+        json_getProperty( json_getProperty( copy, "a" ), "b" ) ) ), "c" );
+    check( c );
+    check( 4 == json_getDepth( c ) );
+    check( json_getParent( json_getParent( json_getParent( c ) ) ) == json_getProperty( copy, "a" ) );
+#endif
+
+    json_arenaInit( &arena, mem, 10 );
+    check( !json_compact( json, json_arenaPoolInit( &apool, &arena, 1 ) ) );
+    done();
+}
+
+static int extract( void ) {
+    json_t pool[16];
+    unsigned const qty = sizeof pool / sizeof *pool;
+    char str[] = "{\"id\":7,\"auth\":{\"user\":\"pe\\\"ter\",\"roles\":[\"a\",\"b\"],\"ok\":true}}";
+    json_t const* json = json_create( str, pool, qty );
+    check( json );
+    json_t const* auth = json_getProperty( json, "auth" );
+    check( auth );
+
+    size_t const size = json_extractSize( auth );
+    check( size == 6 * sizeof( json_t ) + sizeof "auth" + sizeof "user" + sizeof "pe\"ter"
+                   + sizeof "roles" + sizeof "a" + sizeof "b" + sizeof "ok" + sizeof "true" );
+    json_t* const block = malloc( size );
+    check( block );
+    check( !json_extract( auth, block, size - 1 ) );
+    json_t const* copy = json_extract( auth, block, size );
+    check( copy == block );
+    check( equal( auth, copy ) );
+    memset( str, 0, sizeof str );
+    memset( pool, 0, sizeof pool );
+    check( !strcmp( json_getName( copy ), "auth" ) );
+    check( !strcmp( json_getPropertyValue( copy, "user" ), "pe\"ter" ) );
+    json_t const* roles = json_getProperty( copy, "roles" );
+    check( roles && JSON_ARRAY == json_getType( roles ) );
+    check( !strcmp( json_getValue( json_getSibling( json_getChild( roles ) ) ), "b" ) );
+    check( json_getBoolean( json_getProperty( copy, "ok" ) ) );
+    free( block );
+
+    json_t one[2];
+    char num[] = "[-12]";
+    json = json_create( num, one, 2 );
+    check( json );
+    size_t const small = sizeof( json_t ) + sizeof "-12";
+    json_t const* item = json_getChild( json );
+    check( json_extractSize( item ) == small );
+    json_t* const mem = malloc( small );
+    copy = json_extract( item, mem, small );
+    check( copy && -12 == json_getInteger( copy ) && !json_getName( copy ) );
+    free( mem );
+    done();
+}
+
+static int predictor( void ) {
+    jsonPredictor_t predictor;
+    json_predictorInit( &predictor );
+    check( 52 == json_predictorSize( &predictor, 100, 0.99 ) );
+
+    unsigned int i;
+    for( i = 0; i < 100; ++i ) {
+        char str[] = "{\"a\":[1,2,3],\"b\":{\"c\":true}}";
+        size_t const len = strlen( str );
+        unsigned int qty;
+        json_t* const mem = json_predictorAlloc( &predictor, len, 0.99, &qty );
+        check( mem );
+        check( qty <= len / 2 + 2 );
+        json_t const* json = json_create( str, mem, qty );
+        check( json );
+        check( 7 == json_predictorCount( json ) );
+        json_predictorRecord( &predictor, len, json_predictorCount( json ), qty );
+        free( mem );
+    }
+    check( 100 == predictor.parses );
+    check( 1 == predictor.oversized );
+    check( 0 == predictor.undersized );
+    check( 9 == json_predictorSize( &predictor, 30, 0.99 ) );
+    check( 152 == json_predictorSize( &predictor, 600, 0.5 ) );
+
+    for( i = 0; i < 4; ++i ) json_predictorRecord( &predictor, 100, 40, 50 );
+    check( 42 == json_predictorSize( &predictor, 100, 1.0 ) );
+    check( 27 == json_predictorSize( &predictor, 100, 0.9 ) );
+
+    json_predictorFailure( &predictor, 100, 30 );
+    check( 1 == predictor.undersized );
+    check( 52 == json_predictorSize( &predictor, 100, 1.0 ) );
+
+    json_predictorInit( &predictor );
+    json_predictorRecord( &predictor, 300000007, 100000019, 0 );
+    check( 100000021 == json_predictorSize( &predictor, 300000007, 1.0 ) );
+    done();
+}
+
+static unsigned int releases;
+static void countRelease( jsonPool_t* pool ) {
+    (void)pool;
+    ++releases;
+}
+
+static int lifecycle( void ) {
+    json_t mem[6];
+    jsonStatsPool_t spool;
+    jsonPoolEx_t* const pool = json_statsPoolInit( &spool, mem, sizeof mem / sizeof *mem );
+
+    char str0[] = "{\"a\":[1,2,3]}";
+    json_t const* json = json_createWithPoolEx( str0, pool );
+    check( json && 5 == spool.used );
+    char str1[] = "[true]";
+    json = json_createWithPoolEx( str1, pool );
+    check( json == mem && 2 == spool.used );
+    check( json_getBoolean( json_getChild( json ) ) );
+    char str2[] = "{\"a\":[1,2,3,4,5,6]}";
+    check( !json_createWithPoolEx( str2, pool ) );
+    char str3[] = "{\"a\":}";
+    check( !json_createWithPoolEx( str3, pool ) );
+    check( 4 == spool.parses );
+    check( 2 == spool.failures );
+    check( 6 == spool.peak );
+
+    spool.pool.size = offsetof( jsonPoolEx_t, onFailure );
+    char str4[] = "{\"a\":}";
+    check( !json_createWithPoolEx( str4, pool ) );
+    check( 5 == spool.parses );
+    check( 2 == spool.failures );
+
+    spool.pool.release = countRelease;
+    json_poolRelease( pool );
+    check( 1 == releases );
+    done();
+}
+
+static int mapArena( void ) {
+    jsonMapArena_t marena;
+    check( !json_mapArenaCreate( &marena, 10000000, true ) );
+    check( marena.bytes >= 10000000 * sizeof( json_t ) );
+    jsonArenaPool_t apool;
+    jsonPool_t* pool = json_arenaPoolInit( &apool, &marena.arena, 0 );
+    unsigned int i;
+    for( i = 0; i < 1000; ++i ) {
+        char str[] = "{\"a\":[1,2,{\"b\":null}]}";
+        json_t const* json = json_createWithPool( str, pool );
+        check( json );
+        json_t const* obj = json_getSibling( json_getSibling( json_getChild( json_getProperty( json, "a" ) ) ) );
+        check( obj && JSON_NULL == json_getType( json_getProperty( obj, "b" ) ) );
+    }
+    check( json_arenaUsed( &marena.arena ) == 6016 );
+    json_mapArenaReset( &marena );
+    check( 0 == json_arenaUsed( &marena.arena ) );
+    pool = json_arenaPoolInit( &apool, &marena.arena, 0 );
+    char str[] = "[true]";
+    json_t const* json = json_createWithPool( str, pool );
+    check( json == marena.arena.mem );
+    check( json_getBoolean( json_getChild( json ) ) );
+    json_mapArenaDestroy( &marena );
+    done();
+}
+
+static int base64( void ) {
+    char str[] = "{\"short\":\"aGVsbG8=\",\"nopad\":\"aGVsbG8\",\"empty\":\"\","
+                 "\"long\":\"VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4=\","
+                 "\"bad\":\"aGVs*G8=\",\"one\":\"aGVsb\",\"num\":5}";
+    json_t pool[10];
+    unsigned const qty = sizeof pool / sizeof *pool;
+    json_t const* json = json_create( str, pool, qty );
+    check( json );
+
+    char out[64];
+    check( 5 == json_getBase64( json_getProperty( json, "short" ), out, sizeof out ) );
+    check( !memcmp( out, "hello", 5 ) );
+    check( 5 == json_getBase64( json_getProperty( json, "nopad" ), out, sizeof out ) );
+    check( !memcmp( out, "hello", 5 ) );
+    check( -1 == json_getBase64( json_getProperty( json, "short" ), out, 4 ) );
+    check( 0 == json_getBase64( json_getProperty( json, "empty" ), out, 0 ) );
+    check( -1 == json_getBase64( json_getProperty( json, "bad" ), out, sizeof out ) );
+    check( -1 == json_getBase64( json_getProperty( json, "one" ), out, sizeof out ) );
+    check( -1 == json_getBase64( json_getProperty( json, "num" ), out, sizeof out ) );
+
+    static char const fox[] = "The quick brown fox jumps over the lazy dog.";
+    json_t const* property = json_getProperty( json, "long" );
+    check( sizeof fox - 1 == json_getBase64( property, out, sizeof out ) );
+    check( !memcmp( out, fox, sizeof fox - 1 ) );
+    char* const value = (char*)json_getValue( property );
+    check( sizeof fox - 1 == json_getBase64( property, value, strlen( value ) ) );
+    check( !memcmp( value, fox, sizeof fox - 1 ) );
+    done();
+}
+
+static int timestampAndUUID( void ) {
+    char str[] = "{\"t0\":\"1970-01-01T00:00:00Z\",\"t1\":\"2024-02-29T13:45:00.123456789Z\","
+                 "\"t2\":\"2024-02-29T15:45:00.123456789+02:00\",\"t3\":\"1969-12-31t23:59:59.5z\","
+                 "\"t4\":\"2023-02-29T00:00:00Z\",\"t5\":\"2024-01-01T24:00:00Z\",\"t6\":\"2024-01-01T00:00:00\","
+                 "\"u0\":\"123e4567-e89b-12d3-A456-426614174000\",\"u1\":\"123e4567-e89b-12d3-a456-42661417400g\","
+                 "\"u2\":\"123e4567e89b-12d3-a456-4266141740001\"}";
+    json_t pool[12];
+    unsigned const qty = sizeof pool / sizeof *pool;
+    json_t const* json = json_create( str, pool, qty );
+    check( json );
+
+    int64_t ns = -1;
+    check( 0 == json_getTimestamp( json_getProperty( json, "t0" ), &ns ) && 0 == ns );
+    check( 0 == json_getTimestamp( json_getProperty( json, "t1" ), &ns ) );
+    check( INT64_C(1709214300123456789) == ns );
+    check( 0 == json_getTimestamp( json_getProperty( json, "t2" ), &ns ) );
+    check( INT64_C(1709214300123456789) == ns );
+    check( 0 == json_getTimestamp( json_getProperty( json, "t3" ), &ns ) && -500000000 == ns );
+    check( -1 == json_getTimestamp( json_getProperty( json, "t4" ), &ns ) );
+    check( -1 == json_getTimestamp( json_getProperty( json, "t5" ), &ns ) );
+    check( -1 == json_getTimestamp( json_getProperty( json, "t6" ), &ns ) );
+
+    static uint8_t const expected[16] = { 0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3,
+                                          0xa4, 0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x00 };
+    uint8_t uuid[16];
+    check( 0 == json_getUUID( json_getProperty( json, "u0" ), uuid ) );
+    check( !memcmp( uuid, expected, sizeof uuid ) );
+    check( -1 == json_getUUID( json_getProperty( json, "u1" ), uuid ) );
+    check( -1 == json_getUUID( json_getProperty( json, "u2" ), uuid ) );
+    done();
+}
+
+static int formatNumbers( void ) {
+    static struct { double value; char const* text; } const reals[] = {
+        { 0.1, "0.1" }, { 0.1 + 0.2, "0.30000000000000004" }, { 1.0, "1.0" },
+        { -0.0, "-0.0" }, { -2.5, "-2.5" }, { 1e21, "1e21" }, { 1e-7, "1e-7" },
+        { 0.000001, "0.000001" }, { 5e-324, "5e-324" },
+        { 1.7976931348623157e308, "1.7976931348623157e308" }
+    };
+    char out[32];
+    unsigned int i;
+    for( i = 0; i < sizeof reals / sizeof *reals; ++i ) {
+        check( (int)strlen( reals[i].text ) == json_formatReal( reals[i].value, out, sizeof out ) );
+        check( !strcmp( out, reals[i].text ) );
+    }
+    check( -1 == json_formatReal( 1.5, out, 3 ) );
+
+    check( 20 == json_formatInteger( INT64_MIN, out, sizeof out ) );
+    check( !strcmp( out, "-9223372036854775808" ) );
+    check( 1 == json_formatInteger( 0, out, sizeof out ) && !strcmp( out, "0" ) );
+    check( 3 == json_formatInteger( 100, out, sizeof out ) && !strcmp( out, "100" ) );
+    check( -1 == json_formatInteger( 100, out, 3 ) );
+
+    char str[] = "[1.25e3,-7,0.1]";
+    json_t pool[4];
+    json_t const* json = json_create( str, pool, sizeof pool / sizeof *pool );
+    check( json );
+    json_t const* number;
+    for( number = json_getChild( json ); number; number = json_getSibling( number ) ) {
+        char text[32];
+        if ( json_getType( number ) == JSON_REAL )
+            check( 0 < json_formatReal( json_getReal( number ), text, sizeof text ) );
+        else
+            check( 0 < json_formatInteger( json_getInteger( number ), text, sizeof text ) );
+        json_t textPool[2];
+        char array[40];
+        sprintf( array, "[%s]", text );
+        json_t const* back = json_create( array, textPool, 2 );
+        check( back && json_getType( json_getChild( back ) ) == json_getType( number ) );
+        if ( json_getType( number ) == JSON_REAL )
+            check( json_getReal( json_getChild( back ) ) == json_getReal( number ) );
+        else
+            check( json_getInteger( json_getChild( back ) ) == json_getInteger( number ) );
+    }
+    done();
+}
+
+static int ndjsonLine( void* ctx, json_t const* json, char const* line, size_t len, jsonBuffer_t* out ) {
+    (void)ctx;
+    (void)line;
+    (void)len;
+    if ( !json ) return json_bufferAppend( out, "-,", 2 );
+    json_t const* n = json_getProperty( json, "n" );
+    if ( !n ) return -1;
+    char const* value = json_getValue( n );
+    if ( json_bufferAppend( out, value, strlen( value ) ) ) return -1;
+    return json_bufferAppend( out, ",", 1 );
+}
+
+static int ndjsonEmit( void* ctx, char const* data, size_t len ) {
+    return json_bufferAppend( (jsonBuffer_t*)ctx, data, len );
+}
+
+static int ndjson( void ) {
+    jsonBuffer_t text = { 0, 0, 0 };
+    jsonBuffer_t expected = { 0, 0, 0 };
+    int i;
+    for( i = 0; i < 1000; ++i ) {
+        char line[64];
+        int len = i % 100 == 7 ? sprintf( line, "{\"n\":%d\n", i )
+                : i % 100 == 9 ? sprintf( line, "  \n" )
+                : sprintf( line, "{\"n\":%d,\"pad\":[%*d]}\n", i, i % 30, 1 );
+        check( 0 == json_bufferAppend( &text, line, (size_t)len ) );
+        len = i % 100 == 7 ? sprintf( line, "-," ) : i % 100 == 9 ? 0 : sprintf( line, "%d,", i );
+        check( 0 == json_bufferAppend( &expected, line, (size_t)len ) );
+    }
+    text.len -= 1;
+    unsigned int const threads[] = { 0, 4 };
+    for( i = 0; i < 2; ++i ) {
+        jsonBuffer_t out = { 0, 0, 0 };
+        jsonNdjson_t const config = {
+            .threads = threads[i],
+            .batchSize = 256,
+            .ctx = &out,
+            .process = ndjsonLine,
+            .emit = ndjsonEmit
+        };
+        check( 0 == json_ndjsonRun( &config, text.data, text.len ) );
+        check( out.len == expected.len && !memcmp( out.data, expected.data, out.len ) );
+        free( out.data );
+    }
+    char const stop[] = "{\"n\":1}\n{\"m\":2}\n{\"n\":3}";
+    jsonBuffer_t out = { 0, 0, 0 };
+    jsonNdjson_t const config = { 4, 8, &out, ndjsonLine, ndjsonEmit };
+    check( -1 == json_ndjsonRun( &config, stop, sizeof stop - 1 ) );
+    free( out.data );
+    free( expected.data );
+    free( text.data );
+    done();
+}
+
+static int prefilterLine( void* ctx, json_t const* json, char const* line, size_t len, jsonBuffer_t* out ) {
+    (void)ctx;
+    (void)line;
+    (void)len;
+    if ( !json ) return json_bufferAppend( out, "-,", 2 );
+    char const* level = json_getPropertyValue( json, "level" );
+    if ( !level || strcmp( level, "error" ) ) return 0;
+    return ndjsonLine( ctx, json, line, len, out );
+}
+
+static int prefilter( void ) {
+    jsonBuffer_t text = { 0, 0, 0 };
+    jsonBuffer_t expected = { 0, 0, 0 };
+    int i;
+    for( i = 0; i < 2000; ++i ) {
+        static char const* const levels[] = { "info", "error", "debug", "warn" };
+        char line[96];
+        int len = i % 7 == 3 ? sprintf( line, "{\"n\":%d,\"msg\":\"error\",\"level\":\"info\"}\n", i )
+                : i % 500 == 1 ? sprintf( line, "{\"n\":%d,\"level\":\"error\"\n", i )
+                : sprintf( line, "{\"n\":%d,\"level\" : \"%s\"}\n", i, levels[ i % 4 ] );
+        check( 0 == json_bufferAppend( &text, line, (size_t)len ) );
+        len = i % 7 == 3 ? 0 : i % 500 == 1 ? sprintf( line, "-," )
+            : i % 4 == 1 ? sprintf( line, "%d,", i ) : 0;
+        check( 0 == json_bufferAppend( &expected, line, (size_t)len ) );
+    }
+    check( 0 == json_bufferAppend( &text, "{\"n\":2000,\"level\":\"error\"}", 26 ) );
+    check( 0 == json_bufferAppend( &expected, "2000,", 5 ) );
+    char const* const patterns[] = { "\"error\"", "\"level\"" };
+    unsigned int const threads[] = { 0, 3 };
+    for( i = 0; i < 2; ++i ) {
+        jsonBuffer_t out = { 0, 0, 0 };
+        jsonNdjson_t const config = {
+            .threads = threads[i],
+            .batchSize = 300,
+            .ctx = &out,
+            .process = prefilterLine,
+            .emit = ndjsonEmit,
+            .patterns = patterns,
+            .patternQty = 2
+        };
+        check( 0 == json_ndjsonRun( &config, text.data, text.len ) );
+        check( out.len == expected.len && !memcmp( out.data, expected.data, out.len ) );
+        free( out.data );
+    }
+    free( expected.data );
+    free( text.data );
+    done();
+}
+
+static int groupBy( void ) {
+    jsonBuffer_t text = { 0, 0, 0 };
+    int i;
+    for( i = 0; i < 6000; ++i ) {
+        char line[128];
+        int const len = i % 1000 == 999 ? sprintf( line, "{\"host\":\n" )
+                      : i % 3 == 2 ? sprintf( line, "{\"user\":\"u%d\",\"req\":{\"bytes\":%d}}\n", i % 500, i )
+                      : sprintf( line, "{\"host\":\"h%d\",\"level\":%s,\"req\":{\"bytes\":%d.5},\"user\":\"u%d\"}\n",
+                                 i % 2, i % 3 ? "\"error\"" : "10", i, i % 700 );
+        check( 0 == json_bufferAppend( &text, line, (size_t)len ) );
+    }
+    char const* const keys[] = { "host", "level" };
+    jsonAggregate_t const aggregates[] = {
+        { JSON_COUNT, 0 }, { JSON_SUM, "req.bytes" }, { JSON_MIN, "req.bytes" },
+        { JSON_MAX, "req.bytes" }, { JSON_DISTINCT, "user" }, { JSON_MIN, "nothing" }
+    };
+    unsigned int const threads[] = { 0, 4 };
+    for( i = 0; i < 2; ++i ) {
+        jsonGroupBy_t const config = {
+            .threads = threads[i],
+            .keys = keys,
+            .keyQty = 2,
+            .aggregates = aggregates,
+            .aggregateQty = 6
+        };
+        jsonGroups_t groups;
+        check( 0 == json_groupBy( &config, text.data, text.len, &groups ) );
+        check( 6 == groups.invalid );
+        check( 5994 == groups.lines );
+        check( 5 == groups.qty );
+        check( !json_groupKey( &groups, 0, 0 ) && !json_groupKey( &groups, 0, 1 ) );
+        check( JSON_NULL == groups.types[0] );
+        check( 1998 == json_groupValue( &groups, 0, 0 ) );
+        check( 2.0 == json_groupValue( &groups, 0, 2 ) );
+        check( 5996.0 == json_groupValue( &groups, 0, 3 ) );
+        double const distinct = json_groupValue( &groups, 0, 4 );
+        check( distinct > 475.0 && distinct < 525.0 );
+        check( isnan( json_groupValue( &groups, 0, 5 ) ) );
+        check( !strcmp( "h0", json_groupKey( &groups, 1, 0 ) ) );
+        check( !strcmp( "error", json_groupKey( &groups, 1, 1 ) ) );
+        check( JSON_TEXT == groups.types[3] );
+        check( !strcmp( "h0", json_groupKey( &groups, 2, 0 ) ) );
+        check( !strcmp( "10", json_groupKey( &groups, 2, 1 ) ) );
+        check( JSON_INTEGER == groups.types[5] );
+        check( !strcmp( "h1", json_groupKey( &groups, 4, 0 ) ) );
+        check( 1000 == json_groupValue( &groups, 2, 0 ) );
+        check( 0.5 == json_groupValue( &groups, 2, 2 ) );
+        check( 5994.5 == json_groupValue( &groups, 2, 3 ) );
+        double sum = 0;
+        int j;
+        for( j = 0; j < 6000; j += 6 ) sum += j + 0.5;
+        check( sum == json_groupValue( &groups, 2, 1 ) );
+        json_groupsFree( &groups );
+    }
+    text.len = 0;
+    for( i = 0; i < 30; ++i ) {
+        char line[64];
+        int const len = sprintf( line, "{\"k\":%d,\"v\":%d}\n", i % 3, i % 10 );
+        check( 0 == json_bufferAppend( &text, line, (size_t)len ) );
+    }
+    jsonAggregate_t const few[] = { { JSON_DISTINCT, "v" } };
+    for( i = 0; i < 2; ++i ) {
+        jsonGroupBy_t const config = {
+            .threads = threads[i],
+            .keys = keys,
+            .keyQty = 0,
+            .aggregates = few,
+            .aggregateQty = 1
+        };
+        jsonGroups_t groups;
+        check( 0 == json_groupBy( &config, text.data, text.len, &groups ) );
+        check( 1 == groups.qty );
+        double const distinct = json_groupValue( &groups, 0, 0 );
+        check( distinct > 9.5 && distinct < 10.5 );
+        json_groupsFree( &groups );
+    }
+    free( text.data );
+    done();
+}
+
+static int schema( void ) {
+    jsonBuffer_t text = { 0, 0, 0 };
+    int i;
+    for( i = 0; i < 3000; ++i ) {
+        char line[128];
+        int const len = i == 1500 ? sprintf( line, "[1,\n" )
+                      : i % 2 ? sprintf( line, "{\"id\":%d,\"tags\":[%s],\"name\":null}\n", i, i % 3 ? "\"a\",\"b\"" : "" )
+                      : sprintf( line, "{\"id\":%d.5,\"name\":\"%.*s\"}\n", -i, i % 5, "\xc3\xa9xyzw" );
+        check( 0 == json_bufferAppend( &text, line, (size_t)len ) );
+    }
+    unsigned int const threads[] = { 0, 4 };
+    for( i = 0; i < 2; ++i ) {
+        jsonSchema_t result;
+        json_schemaInit( &result );
+        check( 0 == json_schemaInfer( &result, threads[i], text.data, text.len ) );
+        check( 2999 == result.documents );
+        check( 1 == result.invalid );
+        check( 6 == result.maxProperties );
+        jsonSchemaNode_t const* root = result.root;
+        check( root && 2999 == root->types[ JSON_OBJ ] );
+        jsonSchemaNode_t const* id = root->fields;
+        check( id && !strcmp( id->name, "id" ) && 2999 == id->count );
+        check( 1500 == id->types[ JSON_INTEGER ] && 1499 == id->types[ JSON_REAL ] );
+        check( -2998.5 == id->minimum && 2999 == id->maximum );
+        jsonSchemaNode_t const* name = id->next;
+        check( name && !strcmp( name->name, "name" ) );
+        jsonSchemaNode_t const* tags = name->next;
+        check( tags && !strcmp( tags->name, "tags" ) && !tags->next );
+        check( 1500 == name->types[ JSON_NULL ] && 1499 == name->types[ JSON_TEXT ] );
+        check( 0 == name->minLength && 3 == name->maxLength );
+        check( 1500 == tags->count && 0 == tags->minItems && 2 == tags->maxItems );
+        check( tags->items && 2000 == tags->items->types[ JSON_TEXT ] );
+        json_schemaFree( &result );
+        check( !result.root );
+    }
+    char str[] = "{\"a\":[1,2.5],\"b\":{\"c\":true}}";
+    json_t pool[8];
+    json_t const* json = json_create( str, pool, 8 );
+    check( json );
+    jsonSchema_t one, other;
+    json_schemaInit( &one );
+    json_schemaInit( &other );
+    check( 0 == json_schemaAdd( &one, json ) );
+    char str2[] = "{\"b\":{\"d\":\"x\\\"\"},\"a\":null}";
+    json = json_create( str2, pool, 8 );
+    check( json );
+    check( 0 == json_schemaAdd( &other, json ) );
+    check( 0 == json_schemaMerge( &one, &other ) );
+    check( !other.root && 0 == other.documents );
+    jsonBuffer_t out = { 0, 0, 0 };
+    check( 0 == json_schemaWrite( &one, &out ) && 0 == json_bufferAppend( &out, "", 1 ) );
+    static char const expected[] =
+        "{\"$schema\":\"https://json-schema.org/draft/2020-12/schema\",\"x-documents\":2,"
+        "\"x-invalid\":0,\"x-properties\":10,\"x-maxProperties\":6,\"type\":\"object\",\"x-count\":2,"
+        "\"properties\":{\"a\":{\"type\":[\"array\",\"null\"],\"x-count\":2,\"minItems\":2,\"maxItems\":2,"
+        "\"items\":{\"type\":\"number\",\"x-count\":2,\"minimum\":1,\"maximum\":2.5}},"
+        "\"b\":{\"type\":\"object\",\"x-count\":2,\"properties\":{\"c\":{\"type\":\"boolean\",\"x-count\":1},"
+        "\"d\":{\"type\":\"string\",\"x-count\":1,\"minLength\":2,\"maxLength\":2}},\"required\":[]}},"
+        "\"required\":[\"a\",\"b\"]}";
+    check( !strcmp( out.data, expected ) );
+    free( out.data );
+    json_schemaFree( &one );
+    free( text.data );
+    done();
+}
+
+struct compressed {
+    unsigned char const* data;
+    size_t len;
+    size_t pos;
+};
+
+static size_t compressedRead( void* ctx, void* buf, size_t cap ) {
+    struct compressed* const src = (struct compressed*)ctx;
+    size_t len = src->pos % 7 * 100 + 1;
+    if ( len > cap ) len = cap;
+    if ( len > src->len - src->pos ) len = src->len - src->pos;
+    memcpy( buf, src->data + src->pos, len );
+    src->pos += len;
+    return len;
+}
+
+static int inflateStream( void* data, size_t len, char const* expected, unsigned int threads ) {
+    struct compressed src = { (unsigned char const*)data, len, 0 };
+    jsonBuffer_t out = { 0, 0, 0 };
+    jsonInflate_t const config = { 512, &src, compressedRead };
+    jsonNdjson_t const ndjson = {
+        .threads = threads,
+        .batchSize = 200,
+        .ctx = &out,
+        .process = ndjsonLine,
+        .emit = ndjsonEmit
+    };
+    int result = json_inflateRun( &config, &ndjson );
+    if ( !result && ( out.len != strlen( expected ) || ( out.len && memcmp( out.data, expected, out.len ) ) ) ) result = 1;
+    free( out.data );
+    return result;
+}
+
+static int compressed( void ) {
+    jsonBuffer_t text = { 0, 0, 0 };
+    jsonBuffer_t expected = { 0, 0, 0 };
+    int i;
+    for( i = 0; i < 3000; ++i ) {
+        char line[1200];
+        int len = sprintf( line, "{\"n\":%d,\"pad\":\"%*s\"}\n", i, i % 1000 == 5 ? 1100 : i % 10, "" );
+        if ( i % 700 == 3 ) line[ len - 3 ] = ',';
+        check( 0 == json_bufferAppend( &text, line, (size_t)len ) );
+        len = i % 700 == 3 ? sprintf( line, "-," ) : sprintf( line, "%d,", i );
+        check( 0 == json_bufferAppend( &expected, line, (size_t)len + ( i == 2999 ) ) );
+    }
+    expected.data[ expected.len - 1 ] = '\0';
+    --text.len;
+    check( JSON_PLAIN == json_inflateFormat( text.data, text.len ) );
+    check( json_inflateSupported( JSON_PLAIN ) );
+    check( 0 == inflateStream( text.data, text.len, expected.data, 0 ) );
+    check( 0 == inflateStream( text.data, text.len, expected.data, 3 ) );
+    check( 0 == inflateStream( text.data, 0, "", 3 ) );
+#ifdef TINY_JSON_USE_ZLIB
+    size_t const cap = text.len + 1024;
+    unsigned char* const gz = malloc( cap );
+    check( gz );
+    size_t len = 0;
+    size_t const half = text.len / 2;
+    for( i = 0; i < 2; ++i ) {
+        /* Two gzip members. */
+        z_stream zlib;
+        memset( &zlib, 0, sizeof zlib );
+        check( Z_OK == deflateInit2( &zlib, 6, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY ) );
+        zlib.next_in = (Bytef*)text.data + ( i ? half : 0 );
+        zlib.avail_in = (uInt)( i ? text.len - half : half );
+        zlib.next_out = gz + len;
+        zlib.avail_out = (uInt)( cap - len );
+        check( Z_STREAM_END == deflate( &zlib, Z_FINISH ) );
+        len += zlib.total_out;
+        deflateEnd( &zlib );
+    }
+    check( JSON_GZIP == json_inflateFormat( gz, len ) );
+    check( 0 == inflateStream( gz, len, expected.data, 0 ) );
+    check( 0 == inflateStream( gz, len, expected.data, 4 ) );
+    check( -1 == inflateStream( gz, len - 10, expected.data, 4 ) );
+    gz[ len / 2 ] ^= 0x55;
+    check( -1 == inflateStream( gz, len, expected.data, 2 ) );
+    free( gz );
+#endif
+    free( expected.data );
+    free( text.data );
+    done();
+}
+
+static int rpcAdd( void* ctx, json_t const* params, jsonBuffer_t* out ) {
+    (void)ctx;
+    if ( !params || json_getType( params ) != JSON_ARRAY ) return JSON_RPC_INVALID_PARAMS;
+    int64_t total = 0;
+    json_t const* child;
+    for( child = json_getChild( params ); child; child = json_getSibling( child ) )
+        total += json_getInteger( child );
+    char text[32];
+    int const len = json_formatInteger( total, text, sizeof text );
+    return json_bufferAppend( out, text, (size_t)len ) ? JSON_RPC_INTERNAL_ERROR : 0;
+}
+
+static int rpcFail( void* ctx, json_t const* params, jsonBuffer_t* out ) {
+    (void)params;
+    ++*(int*)ctx;
+    json_bufferAppend( out, "Bad \"luck\"", 10 );
+    return -32000;
+}
+
+static int rpcHandle( jsonRpc_t* rpc, jsonRpcPool_t* pool, char const* request, char const* expected ) {
+    char* const text = malloc( strlen( request ) + 1 );
+    jsonBuffer_t out = { 0, 0, 0 };
+    strcpy( text, request );
+    int result = json_rpcHandle( rpc, text, pool, &out );
+    if ( !result ) result = out.len != strlen( expected ) || ( out.len && memcmp( out.data, expected, out.len ) );
+    free( out.data );
+    free( text );
+    return result;
+}
+
+#ifdef __linux__
+struct rpcServer {
+    jsonRpc_t* rpc;
+    int listener;
+    sig_atomic_t volatile stop;
+    int result;
+};
+
+static void* rpcServe( void* arg ) {
+    struct rpcServer* const server = arg;
+    server->result = json_rpcServe( server->rpc, server->listener, &server->stop );
+    return 0;
+}
+#endif
+
+static int rpc( void ) {
+    static char names[40][8];
+    jsonRpcMethod_t methods[42];
+    int i;
+    for( i = 0; i < 40; ++i ) {
+        sprintf( names[i], "m%d", i * 7 );
+        methods[i] = (jsonRpcMethod_t){ names[i], rpcAdd };
+    }
+    methods[40] = (jsonRpcMethod_t){ "add", rpcAdd };
+    methods[41] = (jsonRpcMethod_t){ "fail", rpcFail };
+    int failures = 0;
+    jsonRpc_t rpc;
+    check( 0 == json_rpcInit( &rpc, methods, 42, 0, &failures ) );
+    for( i = 0; i < 42; ++i )
+        check( methods + i == json_rpcFind( &rpc, methods[i].name ) );
+    check( !json_rpcFind( &rpc, "m1" ) );
+    check( !json_rpcFind( &rpc, "" ) );
+    methods[1].name = "m0";
+    jsonRpc_t duplicated;
+    check( -1 == json_rpcInit( &duplicated, methods, 2, 0, 0 ) );
+    methods[1].name = names[1];
+
+    jsonRpcPool_t pool;
+    json_rpcPoolInit( &pool );
+    check( 0 == rpcHandle( &rpc, &pool, "{\"jsonrpc\":\"2.0\",\"method\":\"add\",\"params\":[1,2],\"id\":\"a\\\"\"}",
+                                        "{\"jsonrpc\":\"2.0\",\"result\":3,\"id\":\"a\\\"\"}" ) );
+    check( 0 == rpcHandle( &rpc, &pool, "{\"jsonrpc\":\"2.0\",\"method\":\"add\",\"params\":[1,2]}", "" ) );
+    check( 0 == rpcHandle( &rpc, &pool, "{\"jsonrpc\":\"2.0\",\"method\":\"add\",\"id\":1.5}",
+                                        "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params\"},\"id\":1.5}" ) );
+    check( 0 == rpcHandle( &rpc, &pool, "{\"jsonrpc\":\"2.0\",\"method\":\"fail\",\"id\":null}",
+                                        "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32000,\"message\":\"Bad \\\"luck\\\"\"},\"id\":null}" ) );
+    check( 0 == rpcHandle( &rpc, &pool, "{\"jsonrpc\":\"2.0\",\"method\":\"fail\"}", "" ) );
+    check( 2 == failures );
+    check( 0 == rpcHandle( &rpc, &pool, "{\"jsonrpc\":\"2.0\",\"method\":\"m1\",\"id\":2}",
+                                        "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32601,\"message\":\"Method not found\"},\"id\":2}" ) );
+    check( 0 == rpcHandle( &rpc, &pool, "{\"jsonrpc\":\"2.0\",\"method\":\"m1\"}", "" ) );
+    check( 0 == rpcHandle( &rpc, &pool, "{\"jsonrpc\":\"2.0\",\"method\":1,\"id\":3}",
+                                        "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32600,\"message\":\"Invalid Request\"},\"id\":3}" ) );
+    check( 0 == rpcHandle( &rpc, &pool, "{\"method\":\"add\",\"id\":[]}",
+                                        "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32600,\"message\":\"Invalid Request\"},\"id\":null}" ) );
+    check( 0 == rpcHandle( &rpc, &pool, "{\"jsonrpc\":\"2.0\",",
+                                        "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32700,\"message\":\"Parse error\"},\"id\":null}" ) );
+    check( 0 == rpcHandle( &rpc, &pool, "[]",
+                                        "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32600,\"message\":\"Invalid Request\"},\"id\":null}" ) );
+    check( 0 == rpcHandle( &rpc, &pool, "[{\"jsonrpc\":\"2.0\",\"method\":\"add\",\"params\":[]}]", "" ) );
+    check( 0 == rpcHandle( &rpc, &pool, "[1,{\"jsonrpc\":\"2.0\",\"method\":\"m7\",\"params\":[5],\"id\":4}]",
+                                        "[{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32600,\"message\":\"Invalid Request\"},\"id\":null},"
+                                        "{\"jsonrpc\":\"2.0\",\"result\":5,\"id\":4}]" ) );
+    json_rpcFree( &rpc );
+
+    /* A batch large enough to grow the pool, handled by three threads. */
+    check( 0 == json_rpcInit( &rpc, methods, 42, 3, &failures ) );
+    jsonBuffer_t batch = { 0, 0, 0 };
+    jsonBuffer_t expected = { 0, 0, 0 };
+    check( 0 == json_bufferAppend( &batch, "[", 1 ) );
+    check( 0 == json_bufferAppend( &expected, "[", 1 ) );
+    for( i = 0; i < 500; ++i ) {
+        char text[128];
+        int len = sprintf( text, "%s{\"jsonrpc\":\"2.0\",\"method\":\"%s\",\"params\":[%d,%d]%s}",
+                           i ? "," : "", i % 3 ? "add" : names[ i % 40 ], i, i, i % 5 ? ",\"id\":1" : "" );
+        check( 0 == json_bufferAppend( &batch, text, (size_t)len ) );
+        if ( !( i % 5 ) ) continue;
+        len = sprintf( text, "%s{\"jsonrpc\":\"2.0\",\"result\":%d,\"id\":1}", expected.len > 1 ? "," : "", 2 * i );
+        check( 0 == json_bufferAppend( &expected, text, (size_t)len ) );
+    }
+    check( 0 == json_bufferAppend( &batch, "]", 2 ) );
+    check( 0 == json_bufferAppend( &expected, "]", 2 ) );
+    check( 0 == rpcHandle( &rpc, &pool, batch.data, expected.data ) );
+    check( 0 == rpcHandle( &rpc, &pool, batch.data, expected.data ) );
+
+#ifdef __linux__
+    /* The same requests through a Unix socket, the batch split in two sends. */
+    struct sockaddr_un addr;
+    memset( &addr, 0, sizeof addr );
+    addr.sun_family = AF_UNIX;
+    sprintf( addr.sun_path, "/tmp/tiny-json-rpc-%ld.sock", (long)getpid() );
+    unlink( addr.sun_path );
+    struct rpcServer server = { &rpc, socket( AF_UNIX, SOCK_STREAM, 0 ), 0, -1 };
+    check( server.listener >= 0 );
+    check( 0 == bind( server.listener, (struct sockaddr*)&addr, sizeof addr ) );
+    check( 0 == listen( server.listener, 4 ) );
+    pthread_t thread;
+    check( 0 == pthread_create( &thread, 0, rpcServe, &server ) );
+    int const client = socket( AF_UNIX, SOCK_STREAM, 0 );
+    check( 0 == connect( client, (struct sockaddr*)&addr, sizeof addr ) );
+    batch.data[ batch.len - 1 ] = '\n';
+    check( 100 == write( client, batch.data, 100 ) );
+    check( (ssize_t)batch.len - 100 == write( client, batch.data + 100, batch.len - 100 ) );
+    char const request[] = "\r\n{\"jsonrpc\":\"2.0\",\"method\":\"add\",\"params\":[7],\"id\":9}";
+    check( sizeof request - 1 == write( client, request, sizeof request - 1 ) );
+    shutdown( client, SHUT_WR );
+    jsonBuffer_t received = { 0, 0, 0 };
+    for(;;) {
+        char chunk[4096];
+        ssize_t const n = read( client, chunk, sizeof chunk );
+        check( n >= 0 );
+        if ( !n ) break;
+        check( 0 == json_bufferAppend( &received, chunk, (size_t)n ) );
+    }
+    close( client );
+    expected.data[ expected.len - 1 ] = '\n';
+    check( 0 == json_bufferAppend( &expected, "{\"jsonrpc\":\"2.0\",\"result\":7,\"id\":9}\n", 36 ) );
+    check( received.len == expected.len && !memcmp( received.data, expected.data, expected.len ) );
+    __atomic_store_n( &server.stop, 1, __ATOMIC_RELEASE );
+    pthread_join( thread, 0 );
+    check( 0 == server.result );
+    close( server.listener );
+    unlink( addr.sun_path );
+    free( received.data );
+#endif
+    free( expected.data );
+    free( batch.data );
+    json_rpcPoolFree( &pool );
+    json_rpcFree( &rpc );
+    done();
+}
+
+#ifdef __linux__
+static int shmConsume( char const* name, int qty ) {
+    jsonShm_t shm;
+    check( 0 == json_shmOpen( &shm, name ) );
+    jsonShmDoc_t const* doc;
+    int i;
+    for( i = 0; i < qty; ++i ) {
+        check( 0 == json_shmReceive( &shm, &doc, 5000 ) );
+        jsonShmNode_t const* const root = json_shmRoot( doc );
+        jsonShmNode_t const* const n = json_shmProperty( doc, root, "n" );
+        check( n && JSON_INTEGER == json_shmType( n ) && i == atoi( json_shmValue( doc, n ) ) );
+        jsonShmNode_t const* const pad = json_shmProperty( doc, root, "pad" );
+        check( pad && JSON_TEXT == json_shmType( pad ) && strlen( json_shmValue( doc, pad ) ) == (size_t)i % 50 );
+        json_shmRelease( &shm );
+    }
+    check( -1 == json_shmReceive( &shm, &doc, 5000 ) );
+    json_shmClose( &shm );
+    done();
+}
+#endif
+
+static int shm( void ) {
+#ifdef __linux__
+    char name[64];
+    sprintf( name, "/tiny-json-test-%ld", (long)getpid() );
+    jsonShm_t producer;
+    check( -1 == json_shmCreate( &producer, name, 3, 1024 ) );
+    check( 0 == json_shmCreate( &producer, name, 4, 1024 ) );
+    jsonShm_t consumer;
+    check( -1 == json_shmCreate( &consumer, name, 4, 1024 ) );
+    check( 0 == json_shmOpen( &consumer, name ) );
+    check( consumer.base != producer.base );
+
+    char const text[] = "{\"a\":[1,true,\"x\\ny\"],\"b\":{},\"c\":null}";
+    check( 0 == json_shmPublish( &producer, text, sizeof text - 1, 0 ) );
+    check( -1 == json_shmPublish( &producer, "{\"a\":", 5, 0 ) );
+    char big[1024];
+    memset( big, ' ', sizeof big );
+    big[0] = '{';
+    big[ sizeof big - 1 ] = '}';
+    check( -1 == json_shmPublish( &producer, big, sizeof big, 0 ) );
+    jsonShmDoc_t const* doc;
+    check( 0 == json_shmReceive( &consumer, &doc, 0 ) );
+    jsonShmDoc_t const* none;
+    check( 1 == json_shmReceive( &consumer, &none, 10 ) );
+    check( sizeof text - 1 == doc->len && 7 == doc->qty );
+    jsonShmNode_t const* const root = json_shmRoot( doc );
+    check( JSON_OBJ == json_shmType( root ) && !json_shmName( doc, root ) );
+    jsonShmNode_t const* node = json_shmChild( doc, root );
+    check( node && !strcmp( "a", json_shmName( doc, node ) ) && JSON_ARRAY == json_shmType( node ) );
+    node = json_shmChild( doc, node );
+    check( node && JSON_INTEGER == json_shmType( node ) && !strcmp( "1", json_shmValue( doc, node ) ) );
+    node = json_shmSibling( doc, node );
+    check( node && JSON_BOOLEAN == json_shmType( node ) && !strcmp( "true", json_shmValue( doc, node ) ) );
+    node = json_shmSibling( doc, node );
+    check( node && JSON_TEXT == json_shmType( node ) && !strcmp( "x\ny", json_shmValue( doc, node ) ) );
+    check( !json_shmSibling( doc, node ) );
+    node = json_shmProperty( doc, root, "b" );
+    check( node && JSON_OBJ == json_shmType( node ) && !json_shmChild( doc, node ) );
+    node = json_shmProperty( doc, root, "c" );
+    check( node && JSON_NULL == json_shmType( node ) && !json_shmSibling( doc, node ) );
+    check( !json_shmProperty( doc, root, "d" ) );
+    json_shmRelease( &consumer );
+    json_shmClose( &consumer );
+
+    /* Another process consumes through a ring shorter than the stream. */
+    pid_t const pid = fork();
+    check( pid >= 0 );
+    if ( !pid ) _exit( shmConsume( name, 1000 ) ? 1 : 0 );
+    int i;
+    for( i = 0; i < 1000; ++i ) {
+        char line[128];
+        int const len = sprintf( line, "{\"n\":%d,\"pad\":\"%*s\"}", i, i % 50, "" );
+        check( 0 == json_shmPublish( &producer, line, (size_t)len, 5000 ) );
+    }
+    json_shmFinish( &producer );
+    int status;
+    check( pid == waitpid( pid, &status, 0 ) );
+    check( WIFEXITED( status ) && 0 == WEXITSTATUS( status ) );
+    json_shmClose( &producer );
+    json_shmUnlink( name );
+    check( -1 == json_shmOpen( &consumer, name ) );
+#endif
+    done();
+}
+
+static int numeric( void ) {
+    jsonBuffer_t text = { 0, 0, 0 };
+    check( 0 == json_bufferAppend( &text, "{\"a\":[", 6 ) );
+    double sum = 0;
+    int i;
+    for( i = 0; i < 1000; ++i ) {
+        static char const* const formats[] = { "%d", "%d.25", "-%d.5e-1", "%d.0000000000000000000001" };
+        char number[64];
+        int len = sprintf( number, formats[ i % 4 ], i );
+        sum += strtod( number, 0 );
+        if ( i ) check( 0 == json_bufferAppend( &text, ",", 1 ) );
+        check( 0 == json_bufferAppend( &text, number, (size_t)len ) );
+        if ( i % 100 == 7 ) check( 0 == json_bufferAppend( &text, ",null", 5 ) );
+    }
+    char const tail[] = "],\"b\":[1,\"x\"],\"c\":[],\"d\":[2.5,-1,4E2,0.125]}";
+    check( 0 == json_bufferAppend( &text, tail, sizeof tail ) );
+    size_t const qty = text.len / 2 + 2;
+    json_t* const mem = malloc( qty * sizeof( json_t ) );
+    check( mem );
+    json_t const* const root = json_create( text.data, mem, (unsigned int)qty );
+    check( root );
+    json_t const* const a = json_getProperty( root, "a" );
+    json_t const* const b = json_getProperty( root, "b" );
+    json_t const* const c = json_getProperty( root, "c" );
+    json_t const* const d = json_getProperty( root, "d" );
+    double value, min, max;
+    size_t count;
+    check( 0 == json_arraySum( a, JSON_SKIP, &value, &count ) );
+    check( 1000 == count && fabs( value - sum ) <= 1e-12 * fabs( sum ) );
+    check( -1 == json_arraySum( a, JSON_FAIL, &value, &count ) );
+    check( -1 == json_arraySum( root, JSON_SKIP, &value, &count ) );
+    check( 0 == json_arraySum( c, JSON_FAIL, &value, &count ) && 0 == value && 0 == count );
+    check( 0 == json_arraySum( d, JSON_FAIL, &value, 0 ) && 401.625 == value );
+    check( 0 == json_arrayMean( d, JSON_FAIL, &value ) && 401.625 / 4 == value );
+    check( -1 == json_arrayMean( c, JSON_SKIP, &value ) );
+    check( 0 == json_arrayMean( b, JSON_SKIP, &value ) && 1 == value );
+    check( 0 == json_arrayMinMax( d, JSON_FAIL, &min, &max ) && -1 == min && 400 == max );
+    check( 0 == json_arrayMinMax( a, JSON_SKIP, &min, &max ) && -99.85 == min && 999 == max );
+    check( -1 == json_arrayMinMax( c, JSON_SKIP, &min, &max ) );
+    size_t counts[4];
+    size_t outside;
+    check( 0 == json_arrayHistogram( d, JSON_FAIL, -1, 3, 4, counts, &outside ) );
+    check( 1 == counts[0] && 1 == counts[1] && 0 == counts[2] && 1 == counts[3] && 1 == outside );
+    check( -1 == json_arrayHistogram( d, JSON_FAIL, 3, 3, 4, counts, &outside ) );
+    check( 0 == json_arrayHistogram( d, JSON_SKIP, -1, 400, 1, counts, 0 ) && 4 == counts[0] );
+    double const few[] = { 0.5, 1.5, 2.5 };
+    check( 3 == json_numbersHistogram( few, 3, 0, 3, 0, counts ) );
+    check( 3 == json_numbersHistogram( few, 3, 3, 0, 4, counts ) );
+    check( 3 == json_numbersHistogram( few, 3, 0, HUGE_VAL, 4, counts ) && 4 == counts[0] );
+
+    jsonNumbers_t numbers;
+    memset( &numbers, 0, sizeof numbers );
+    check( -1 == json_numbersLoad( &numbers, a, JSON_FAIL ) );
+    check( 0 == json_numbersLoad( &numbers, a, JSON_SKIP ) );
+    check( 1000 == numbers.qty && 10 == numbers.skipped );
+    check( fabs( json_numbersSum( numbers.values, numbers.qty ) - sum ) <= 1e-12 * fabs( sum ) );
+    check( 1.25 == numbers.values[1] && -0.25 == numbers.values[2] );
+    for( i = 0; i < 7; ++i ) {
+        json_numbersMinMax( numbers.values + i, 5 + (size_t)i, &min, &max );
+        double low = HUGE_VAL, high = -HUGE_VAL;
+        size_t j;
+        for( j = (size_t)i; j < 5 + 2 * (size_t)i; ++j ) {
+            if ( numbers.values[j] < low ) low = numbers.values[j];
+            if ( numbers.values[j] > high ) high = numbers.values[j];
+        }
+        check( low == min && high == max );
+    }
+    check( 0 == json_numbersLoad( &numbers, d, JSON_FAIL ) && 4 == numbers.qty && 0 == numbers.skipped );
+    json_numbersFree( &numbers );
+    free( mem );
+    free( text.data );
+    done();
+}
+
+static int soaSame( jsonSoa_t const* soa, uint32_t index, json_t const* json ) {
+    jsonType_t const type = json_getType( json );
+    check( type == json_soaType( soa, index ) );
+    check( json_getName( json ) == json_soaName( soa, index ) );
+    if ( type != JSON_OBJ && type != JSON_ARRAY ) {
+        check( json_getValue( json ) == json_soaValue( soa, index ) );
+        check( !json_soaChild( soa, index ) && index + 1 == json_soaEnd( soa, index ) );
+        done();
+    }
+    uint32_t child = json_soaChild( soa, index );
+    json_t const* node;
+    for( node = json_getChild( json ); node; node = json_getSibling( node ) ) {
+        check( child );
+        check( 0 == soaSame( soa, child, node ) );
+        child = json_soaSibling( soa, child );
+    }
+    check( !child );
+    done();
+}
+
+static int soa( void ) {
+    jsonBuffer_t text = { 0, 0, 0 };
+    check( 0 == json_bufferAppend( &text, "[", 1 ) );
+    int i;
+    for( i = 0; i < 3000; ++i ) {
+        static char const* const values[] = { "null", "\"x\"", "1", "{\"a\":null,\"b\":[true,2.5]}", "[]", "{}" };
+        char element[64];
+        int const len = sprintf( element, "%s%s", i ? "," : "", values[ i * 7 % 11 % 6 ] );
+        check( 0 == json_bufferAppend( &text, element, (size_t)len ) );
+    }
+    check( 0 == json_bufferAppend( &text, "]", 2 ) );
+    size_t const qty = text.len / 2 + 2;
+    json_t* const mem = malloc( qty * sizeof( json_t ) );
+    check( mem );
+    json_t const* const root = json_create( text.data, mem, (unsigned int)qty );
+    check( root );
+    jsonSoa_t soa;
+    memset( &soa, 0, sizeof soa );
+    check( 0 == json_soaBuild( &soa, root, text.data ) );
+    check( 0 == soaSame( &soa, 0, root ) );
+    check( soa.qty == json_soaEnd( &soa, 0 ) );
+    for( i = 0; i < 200; ++i ) {
+        uint32_t const first = (uint32_t)( i * 37 % 500 );
+        uint32_t const end = first + (uint32_t)( i * i % ( soa.qty - first ) );
+        jsonType_t const type = (jsonType_t)( i % 8 );
+        size_t expected = 0;
+        uint32_t j;
+        for( j = first; j < end; ++j )
+            expected += json_soaType( &soa, j ) == type;
+        check( expected == json_soaCount( &soa, type, first, end ) );
+    }
+    size_t found = 0;
+    uint32_t index;
+    for( index = json_soaFind( &soa, JSON_NULL, 0 ); index < soa.qty; index = json_soaFind( &soa, JSON_NULL, index + 1 ) ) {
+        check( JSON_NULL == json_soaType( &soa, index ) );
+        ++found;
+    }
+    check( found == json_soaCount( &soa, JSON_NULL, 0, soa.qty ) && found > 500 );
+    check( soa.qty == json_soaFind( &soa, JSON_NULL, soa.qty ) );
+
+    char small[] = "{\"k\":[]}";
+    json_t const* const other = json_create( small, mem, (unsigned int)qty );
+    check( other );
+    check( 0 == json_soaBuild( &soa, other, small ) );
+    check( 2 == soa.qty && JSON_OBJ == json_soaType( &soa, 0 ) && 1 == json_soaChild( &soa, 0 ) );
+    check( !strcmp( "k", json_soaName( &soa, 1 ) ) && !json_soaChild( &soa, 1 ) && !json_soaSibling( &soa, 1 ) );
+    check( soa.qty == json_soaFind( &soa, JSON_TEXT, 0 ) );
+    json_soaFree( &soa );
+    free( mem );
+    free( text.data );
+    done();
+}
 
 // --------------------------------------------------------- Execute tests: ---
 
@@ -374,6 +1802,31 @@ int main( void ) {
         { array,       "Array"                  },
         { badformat,   "Bad format"             },
         { goodformats, "Formats"                },
+        { utf16,       "UTF-16 transcoding"     },
+        { wide,        "Wide characters"        },
+        { arena,       "Shared arena"           },
+        { document,    "Shared document"        },
+        { pipeline,    "Pipeline"               },
+        { structuralIndex, "Structural index"   },
+        { parent,      "Parent and depth"       },
+        { span,        "Span of containers"     },
+        { compact,     "Compact copy"           },
+        { extract,     "Extract a subtree"      },
+        { predictor,   "Pool size predictor"    },
+        { lifecycle,   "Pool lifecycle"         },
+        { mapArena,    "Virtual memory arena"   },
+        { base64,      "Base64 values"          },
+        { timestampAndUUID, "Timestamps and UUIDs" },
+        { formatNumbers, "Number formatting"    },
+        { ndjson,      "Parallel NDJSON"        },
+        { prefilter,   "NDJSON prefilter"       },
+        { groupBy,     "Group-by aggregation"   },
+        { schema,      "Schema inference"       },
+        { compressed,  "Compressed streams"     },
+        { rpc,         "JSON-RPC dispatcher"    },
+        { shm,         "Shared-memory transport" },
+        { numeric,     "Numeric arrays"         },
+        { soa,         "Struct-of-arrays scans" },
     };
     return test_suit( tests, sizeof tests / sizeof *tests );
 }
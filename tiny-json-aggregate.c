@@ -0,0 +1,618 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <math.h>
+#include "tiny-json-aggregate.h"
+
+/** Number of registers of an estimator of distinct values. */
+#define REGISTERS ( 1u << JSON_DISTINCT_BITS )
+
+/** Number of registers set that an estimator keeps in its sparse form. */
+#define SPARSE_MAX ( REGISTERS / 16 )
+
+/** Initial number of slots of a hash table. */
+#define MIN_SLOTS 64
+
+/** Step of a path: the name of a field or the index of an element. */
+typedef struct step_s {
+    char* name;            /**< Name of the field.                         */
+    long index;            /**< Index of the element or -1 if not a number.*/
+} step_t;
+
+/** Path compiled from its dotted text. */
+typedef struct path_s {
+    step_t* steps;
+    unsigned int qty;
+} path_t;
+
+/** Group of a hash table. Its key is the value of each key path encoded as
+  * a tag, the type plus one or zero if it is missing, and its text ended
+  * with a null character. */
+typedef struct group_s {
+    uint64_t hash;         /**< Hash of the encoded key.                   */
+    size_t key;            /**< Offset of the encoded key in the storage.  */
+    size_t len;            /**< Length of the encoded key.                 */
+} group_t;
+
+/** Estimator of distinct values. It starts as a list of the registers set,
+  * each one with its index in the high bits and its value in the low byte,
+  * and becomes an array of all the registers when the list is full. */
+typedef struct estimator_s {
+    uint32_t* sparse;      /**< Registers set while there are few.         */
+    uint8_t* dense;        /**< All the registers or null pointer.         */
+    unsigned int qty;      /**< Number of entries of sparse.               */
+    unsigned int cap;      /**< Capacity of sparse.                        */
+} estimator_t;
+
+struct job_s;
+
+/** Hash table of the groups of a thread. */
+typedef struct table_s {
+    struct job_s* job;     /**< The group-by.                              */
+    group_t* groups;       /**< The groups in the order they were found.   */
+    size_t qty;            /**< Number of groups.                          */
+    size_t cap;            /**< Capacity of the arrays of the groups.      */
+    size_t* slots;         /**< Open addressing. Index of a group plus one.*/
+    size_t mask;           /**< Number of slots minus one.                 */
+    jsonBuffer_t keys;     /**< Storage of the encoded keys.               */
+    jsonBuffer_t scratch;  /**< Encoded key of the current line.           */
+    double* acc;           /**< Accumulators, one per aggregate and group. */
+    estimator_t* distinct; /**< Estimators, one per distinct aggregate.    */
+    unsigned long lines;   /**< Number of lines aggregated.                */
+    unsigned long invalid; /**< Number of lines that are not valid JSON.   */
+    struct table_s* next;  /**< Next table of a finished thread.           */
+} table_t;
+
+/** State of a group-by. */
+typedef struct job_s {
+    jsonGroupBy_t const* config;
+    path_t* keys;          /**< Compiled paths of the keys.                */
+    path_t* paths;         /**< Compiled paths of the aggregates.          */
+    unsigned int distinctQty; /**< Number of distinct aggregates.          */
+    table_t* tables;       /**< Tables of the threads that finished.       */
+    pthread_mutex_t mutex; /**< It protects the list of tables.            */
+} job_t;
+
+/** Compile a dotted path.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int compile( path_t* path, char const* text ) {
+    path->qty = 0;
+    path->steps = 0;
+    if ( !text || !*text ) return 0;
+    unsigned int max = 1;
+    char const* ptr;
+    for( ptr = text; *ptr; ++ptr ) max += *ptr == '.';
+    path->steps = (step_t*)malloc( max * sizeof( step_t ) );
+    if ( !path->steps ) return -1;
+    for( ptr = text;; ++ptr ) {
+        size_t const len = strcspn( ptr, "." );
+        step_t* const step = path->steps + path->qty;
+        step->name = (char*)malloc( len + 1 );
+        if ( !step->name ) return -1;
+        memcpy( step->name, ptr, len );
+        step->name[ len ] = '\0';
+        ++path->qty;
+        size_t digits = 0;
+        while( digits < len && isdigit( (unsigned char)ptr[ digits ] ) ) ++digits;
+        step->index = len && digits == len ? strtol( step->name, 0, 10 ) : -1;
+        ptr += len;
+        if ( !*ptr ) return 0;
+    }
+}
+
+/** Free the memory of a compiled path. */
+static void freePath( path_t* path ) {
+    unsigned int i;
+    for( i = 0; i < path->qty; ++i )
+        free( path->steps[i].name );
+    free( path->steps );
+}
+
+/** Get the property of a path.
+  * @return The property or null pointer if the path is missing. */
+static json_t const* resolve( json_t const* json, path_t const* path ) {
+    unsigned int i;
+    for( i = 0; json && i < path->qty; ++i ) {
+        step_t const* const step = path->steps + i;
+        jsonType_t const type = json_getType( json );
+        if ( type == JSON_OBJ ) json = json_getProperty( json, step->name );
+        else if ( type == JSON_ARRAY && step->index >= 0 ) {
+            long n;
+            for( json = json_getChild( json ), n = step->index; json && n; --n )
+                json = json_getSibling( json );
+        }
+        else return 0;
+    }
+    return json;
+}
+
+/** Get the text of a property as it is stored in a key. */
+static char const* keyText( json_t const* json ) {
+    jsonType_t const type = json_getType( json );
+    if ( type == JSON_OBJ ) return "{}";
+    if ( type == JSON_ARRAY ) return "[]";
+    return json_getValue( json );
+}
+
+/** Hash characters with FNV-1a and mix the result so that its high bits,
+  * used by the estimators, are as good as its low bits. */
+static uint64_t hashBytes( unsigned int seed, char const* data, size_t len ) {
+    uint64_t hash = UINT64_C( 0xcbf29ce484222325 ) ^ seed;
+    size_t i;
+    for( i = 0; i < len; ++i )
+        hash = ( hash ^ (unsigned char)data[i] ) * UINT64_C( 0x100000001b3 );
+    hash ^= hash >> 33;
+    hash *= UINT64_C( 0xff51afd7ed558ccd );
+    hash ^= hash >> 33;
+    hash *= UINT64_C( 0xc4ceb9fe1a85ec53 );
+    return hash ^ ( hash >> 33 );
+}
+
+/** Double the slots of a hash table.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int grow( table_t* table ) {
+    size_t const mask = 2 * table->mask + 1;
+    size_t* const slots = (size_t*)calloc( mask + 1, sizeof( size_t ) );
+    if ( !slots ) return -1;
+    size_t i;
+    for( i = 0; i < table->qty; ++i ) {
+        size_t slot = table->groups[i].hash & mask;
+        while( slots[ slot ] ) slot = ( slot + 1 ) & mask;
+        slots[ slot ] = i + 1;
+    }
+    free( table->slots );
+    table->slots = slots;
+    table->mask = mask;
+    return 0;
+}
+
+/** Add a group to a hash table with its accumulators initialized.
+  * @return The index of the group or -1 if there was not enough memory. */
+static long addGroup( table_t* table, char const* key, size_t len, uint64_t hash ) {
+    job_t const* const job = table->job;
+    unsigned int const aggregateQty = job->config->aggregateQty;
+    size_t const distinctQty = job->distinctQty;
+    if ( table->qty == table->cap ) {
+        size_t const cap = table->cap ? 2 * table->cap : 16;
+        group_t* const groups = (group_t*)realloc( table->groups, cap * sizeof( group_t ) );
+        if ( !groups ) return -1;
+        table->groups = groups;
+        double* const acc = (double*)realloc( table->acc, ( cap * aggregateQty + 1 ) * sizeof( double ) );
+        if ( !acc ) return -1;
+        table->acc = acc;
+        estimator_t* const estimators = (estimator_t*)realloc( table->distinct, ( cap * distinctQty + 1 ) * sizeof( estimator_t ) );
+        if ( !estimators ) return -1;
+        table->distinct = estimators;
+        table->cap = cap;
+    }
+    group_t* const group = table->groups + table->qty;
+    group->hash = hash;
+    group->key = table->keys.len;
+    group->len = len;
+    if ( json_bufferAppend( &table->keys, key, len ) ) return -1;
+    double* const acc = table->acc + table->qty * aggregateQty;
+    unsigned int i;
+    for( i = 0; i < aggregateQty; ++i ) {
+        jsonAggregateType_t const type = job->config->aggregates[i].type;
+        acc[i] = type == JSON_MIN || type == JSON_MAX ? NAN : 0.0;
+    }
+    memset( table->distinct + table->qty * distinctQty, 0, distinctQty * sizeof( estimator_t ) );
+    return (long)table->qty++;
+}
+
+/** Get the group of a key, adding it if it is new.
+  * @return The index of the group or -1 if there was not enough memory. */
+static long findGroup( table_t* table, char const* key, size_t len, uint64_t hash ) {
+    if ( 2 * ( table->qty + 1 ) > table->mask + 1 && grow( table ) ) return -1;
+    size_t slot;
+    for( slot = hash & table->mask; table->slots[ slot ]; slot = ( slot + 1 ) & table->mask ) {
+        group_t const* const group = table->groups + table->slots[ slot ] - 1;
+        if ( group->hash == hash && group->len == len && !memcmp( table->keys.data + group->key, key, len ) )
+            return (long)( table->slots[ slot ] - 1 );
+    }
+    long const index = addGroup( table, key, len, hash );
+    if ( index >= 0 ) table->slots[ slot ] = (size_t)index + 1;
+    return index;
+}
+
+/** Raise a register of an estimator to a value.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int raiseRegister( estimator_t* estimator, uint32_t index, uint8_t rank ) {
+    unsigned int i;
+    if ( estimator->dense ) {
+        if ( estimator->dense[ index ] < rank ) estimator->dense[ index ] = rank;
+        return 0;
+    }
+    for( i = 0; i < estimator->qty; ++i ) {
+        if ( estimator->sparse[i] >> 8 != index ) continue;
+        if ( ( estimator->sparse[i] & 0xff ) < rank ) estimator->sparse[i] = index << 8 | rank;
+        return 0;
+    }
+    if ( estimator->qty == SPARSE_MAX ) {
+        uint8_t* const dense = (uint8_t*)calloc( REGISTERS, 1 );
+        if ( !dense ) return -1;
+        for( i = 0; i < estimator->qty; ++i )
+            dense[ estimator->sparse[i] >> 8 ] = (uint8_t)estimator->sparse[i];
+        free( estimator->sparse );
+        estimator->sparse = 0;
+        estimator->qty = 0;
+        estimator->cap = 0;
+        estimator->dense = dense;
+        return raiseRegister( estimator, index, rank );
+    }
+    if ( estimator->qty == estimator->cap ) {
+        unsigned int const cap = estimator->cap ? 2 * estimator->cap : 4;
+        uint32_t* const sparse = (uint32_t*)realloc( estimator->sparse, cap * sizeof( uint32_t ) );
+        if ( !sparse ) return -1;
+        estimator->sparse = sparse;
+        estimator->cap = cap;
+    }
+    estimator->sparse[ estimator->qty++ ] = index << 8 | rank;
+    return 0;
+}
+
+/** Add a value to an estimator of distinct values. The first bits of its
+  * hash select a register that keeps the longest run of zeros seen after them.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int addDistinct( estimator_t* estimator, json_t const* json ) {
+    char const* const text = keyText( json );
+    uint64_t const hash = hashBytes( json_getType( json ), text, strlen( text ) );
+    uint64_t const rest = ( hash << JSON_DISTINCT_BITS ) | ( UINT64_C( 1 ) << ( JSON_DISTINCT_BITS - 1 ) );
+    uint8_t const rank = (uint8_t)( __builtin_clzll( rest ) + 1 );
+    return raiseRegister( estimator, (uint32_t)( hash >> ( 64 - JSON_DISTINCT_BITS ) ), rank );
+}
+
+/** Merge an estimator into another.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int mergeEstimator( estimator_t* dst, estimator_t const* src ) {
+    uint32_t i;
+    if ( src->dense ) {
+        for( i = 0; i < REGISTERS; ++i )
+            if ( src->dense[i] && raiseRegister( dst, i, src->dense[i] ) ) return -1;
+        return 0;
+    }
+    for( i = 0; i < src->qty; ++i )
+        if ( raiseRegister( dst, src->sparse[i] >> 8, (uint8_t)src->sparse[i] ) ) return -1;
+    return 0;
+}
+
+/** Free the memory of an estimator. */
+static void freeEstimator( estimator_t* estimator ) {
+    free( estimator->sparse );
+    free( estimator->dense );
+}
+
+/** Get the estimation of the number of distinct values of an estimator.
+  * HyperLogLog with linear counting for small cardinalities. */
+static double estimate( estimator_t const* estimator ) {
+    double const m = REGISTERS;
+    double sum = 0.0;
+    unsigned int zeros = 0;
+    unsigned int i;
+    if ( estimator->dense ) {
+        for( i = 0; i < REGISTERS; ++i ) {
+            sum += ldexp( 1.0, -(int)estimator->dense[i] );
+            zeros += !estimator->dense[i];
+        }
+    }
+    else {
+        zeros = REGISTERS - estimator->qty;
+        sum = zeros;
+        for( i = 0; i < estimator->qty; ++i )
+            sum += ldexp( 1.0, -(int)( estimator->sparse[i] & 0xff ) );
+    }
+    double const raw = 0.7213 / ( 1.0 + 1.079 / m ) * m * m / sum;
+    if ( raw <= 2.5 * m && zeros ) return round( m * log( m / zeros ) );
+    return round( raw );
+}
+
+/** Accumulate a line in the table of the thread. It is called from the threads. */
+static int accumulate( void* ctx, json_t const* json, char const* line, size_t len, jsonBuffer_t* out ) {
+    table_t* const table = (table_t*)ctx;
+    job_t const* const job = table->job;
+    jsonGroupBy_t const* const config = job->config;
+    (void)line;
+    (void)len;
+    (void)out;
+    if ( !json ) {
+        ++table->invalid;
+        return 0;
+    }
+    table->scratch.len = 0;
+    unsigned int i;
+    for( i = 0; i < config->keyQty; ++i ) {
+        json_t const* const value = resolve( json, job->keys + i );
+        char const tag = value ? (char)( json_getType( value ) + 1 ) : 0;
+        char const* const text = value ? keyText( value ) : "";
+        if ( json_bufferAppend( &table->scratch, &tag, 1 ) ) return -1;
+        if ( json_bufferAppend( &table->scratch, text, strlen( text ) + 1 ) ) return -1;
+    }
+    char const* const key = table->scratch.data;
+    size_t const keyLen = table->scratch.len;
+    long const index = findGroup( table, key, keyLen, hashBytes( 0, key, keyLen ) );
+    if ( index < 0 ) return -1;
+    ++table->lines;
+    double* const acc = table->acc + (size_t)index * config->aggregateQty;
+    estimator_t* estimator = table->distinct + (size_t)index * job->distinctQty;
+    for( i = 0; i < config->aggregateQty; ++i ) {
+        jsonAggregateType_t const type = config->aggregates[i].type;
+        if ( type == JSON_COUNT ) {
+            acc[i] += 1.0;
+            continue;
+        }
+        json_t const* const value = resolve( json, job->paths + i );
+        jsonType_t const valueType = value ? json_getType( value ) : JSON_OBJ;
+        if ( type == JSON_DISTINCT ) {
+            if ( valueType != JSON_OBJ && valueType != JSON_ARRAY && addDistinct( estimator, value ) ) return -1;
+            ++estimator;
+            continue;
+        }
+        if ( valueType != JSON_INTEGER && valueType != JSON_REAL ) continue;
+        double const number = json_getReal( value );
+        if ( type == JSON_SUM ) acc[i] += number;
+        else if ( type == JSON_MIN ) acc[i] = fmin( acc[i], number );
+        else acc[i] = fmax( acc[i], number );
+    }
+    return 0;
+}
+
+/** Free the memory of a hash table. */
+static void freeTable( table_t* table ) {
+    size_t const estimators = table->qty * table->job->distinctQty;
+    size_t i;
+    for( i = 0; i < estimators; ++i )
+        freeEstimator( table->distinct + i );
+    free( table->scratch.data );
+    free( table->keys.data );
+    free( table->distinct );
+    free( table->acc );
+    free( table->slots );
+    free( table->groups );
+    free( table );
+}
+
+/** Create the hash table of a thread. */
+static void* tableCreate( void* ctx ) {
+    table_t* const table = (table_t*)calloc( 1, sizeof( table_t ) );
+    if ( !table ) return 0;
+    table->job = (job_t*)ctx;
+    table->mask = MIN_SLOTS - 1;
+    table->slots = (size_t*)calloc( MIN_SLOTS, sizeof( size_t ) );
+    if ( table->slots ) return table;
+    free( table );
+    return 0;
+}
+
+/** Keep the hash table of a thread that finished to merge it. */
+static void tableDone( void* ctx, void* local ) {
+    job_t* const job = (job_t*)ctx;
+    table_t* const table = (table_t*)local;
+    pthread_mutex_lock( &job->mutex );
+    table->next = job->tables;
+    job->tables = table;
+    pthread_mutex_unlock( &job->mutex );
+}
+
+/** Merge a hash table into another.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int merge( table_t* dst, table_t const* src ) {
+    job_t const* const job = dst->job;
+    jsonGroupBy_t const* const config = job->config;
+    size_t const distinctQty = job->distinctQty;
+    size_t i;
+    for( i = 0; i < src->qty; ++i ) {
+        group_t const* const group = src->groups + i;
+        long const index = findGroup( dst, src->keys.data + group->key, group->len, group->hash );
+        if ( index < 0 ) return -1;
+        double* const acc = dst->acc + (size_t)index * config->aggregateQty;
+        double const* const from = src->acc + i * config->aggregateQty;
+        unsigned int j;
+        for( j = 0; j < config->aggregateQty; ++j ) {
+            jsonAggregateType_t const type = config->aggregates[j].type;
+            if ( type == JSON_MIN ) acc[j] = fmin( acc[j], from[j] );
+            else if ( type == JSON_MAX ) acc[j] = fmax( acc[j], from[j] );
+            else acc[j] += from[j];
+        }
+        estimator_t* const estimator = dst->distinct + (size_t)index * distinctQty;
+        estimator_t const* const fromEstimator = src->distinct + i * distinctQty;
+        size_t k;
+        for( k = 0; k < distinctQty; ++k )
+            if ( mergeEstimator( estimator + k, fromEstimator + k ) ) return -1;
+    }
+    dst->lines += src->lines;
+    dst->invalid += src->invalid;
+    return 0;
+}
+
+/** Reference to an encoded key to sort the groups. */
+typedef struct sortKey_s {
+    char const* key;
+    size_t len;
+    size_t index;
+} sortKey_t;
+
+/** Compare two encoded keys value by value. Missing values go first and
+  * numbers are compared by value. */
+static int compareKeys( void const* a, void const* b ) {
+    sortKey_t const* const ka = (sortKey_t const*)a;
+    sortKey_t const* const kb = (sortKey_t const*)b;
+    size_t pos = 0;
+    while( pos < ka->len ) {
+        char const* const ta = ka->key + pos;
+        char const* const tb = kb->key + pos;
+        int const typeA = ta[0] - 1;
+        int const typeB = tb[0] - 1;
+        bool const numberA = typeA == JSON_INTEGER || typeA == JSON_REAL;
+        bool const numberB = typeB == JSON_INTEGER || typeB == JSON_REAL;
+        int order;
+        if ( numberA && numberB ) {
+            double const va = strtod( ta + 1, 0 );
+            double const vb = strtod( tb + 1, 0 );
+            order = va < vb ? -1 : va > vb;
+            if ( !order ) order = strcmp( ta + 1, tb + 1 );
+        }
+        else if ( typeA != typeB ) order = typeA < typeB ? -1 : 1;
+        else order = strcmp( ta + 1, tb + 1 );
+        if ( order ) return order;
+        size_t const lenA = strlen( ta + 1 ) + 2;
+        size_t const lenB = strlen( tb + 1 ) + 2;
+        if ( lenA != lenB ) return lenA < lenB ? -1 : 1;
+        pos += lenA;
+    }
+    return 0;
+}
+
+/** Build the result of a group-by from the merged hash table.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int result( table_t* table, jsonGroups_t* groups ) {
+    job_t const* const job = table->job;
+    jsonGroupBy_t const* const config = job->config;
+    size_t const qty = table->qty;
+    groups->qty = qty;
+    groups->keyQty = config->keyQty;
+    groups->aggregateQty = config->aggregateQty;
+    groups->lines = table->lines;
+    groups->invalid = table->invalid;
+    groups->keys = (char const**)malloc( ( qty * config->keyQty + 1 ) * sizeof( char const* ) );
+    groups->types = (jsonType_t*)malloc( ( qty * config->keyQty + 1 ) * sizeof( jsonType_t ) );
+    groups->values = (double*)malloc( ( qty * config->aggregateQty + 1 ) * sizeof( double ) );
+    groups->text = table->keys.data;
+    table->keys.data = 0;
+    sortKey_t* const order = (sortKey_t*)malloc( ( qty + 1 ) * sizeof( sortKey_t ) );
+    if ( !groups->keys || !groups->types || !groups->values || !order ) {
+        free( order );
+        return -1;
+    }
+    size_t i;
+    for( i = 0; i < qty; ++i ) {
+        order[i].key = groups->text + table->groups[i].key;
+        order[i].len = table->groups[i].len;
+        order[i].index = i;
+    }
+    qsort( order, qty, sizeof *order, compareKeys );
+    for( i = 0; i < qty; ++i ) {
+        char const* key = order[i].key;
+        unsigned int k;
+        for( k = 0; k < config->keyQty; ++k ) {
+            size_t const at = i * config->keyQty + k;
+            groups->keys[ at ] = key[0] ? key + 1 : 0;
+            groups->types[ at ] = key[0] ? (jsonType_t)( key[0] - 1 ) : JSON_NULL;
+            key += strlen( key + 1 ) + 2;
+        }
+        size_t const index = order[i].index;
+        estimator_t const* estimator = table->distinct + index * job->distinctQty;
+        for( k = 0; k < config->aggregateQty; ++k ) {
+            double value = table->acc[ index * config->aggregateQty + k ];
+            if ( config->aggregates[k].type == JSON_DISTINCT ) {
+                value = estimate( estimator++ );
+            }
+            groups->values[ i * config->aggregateQty + k ] = value;
+        }
+    }
+    free( order );
+    return 0;
+}
+
+/* Group the lines of an NDJSON text and compute the aggregates of each group. */
+int json_groupBy( jsonGroupBy_t const* config, char const* text, size_t len, jsonGroups_t* groups ) {
+    memset( groups, 0, sizeof *groups );
+    job_t job;
+    job.config = config;
+    job.tables = 0;
+    job.distinctQty = 0;
+    job.keys = (path_t*)calloc( config->keyQty + 1, sizeof( path_t ) );
+    job.paths = (path_t*)calloc( config->aggregateQty + 1, sizeof( path_t ) );
+    int error = !job.keys || !job.paths;
+    unsigned int i;
+    for( i = 0; !error && i < config->keyQty; ++i )
+        error = compile( job.keys + i, config->keys[i] );
+    for( i = 0; !error && i < config->aggregateQty; ++i ) {
+        jsonAggregate_t const* const aggregate = config->aggregates + i;
+        job.distinctQty += aggregate->type == JSON_DISTINCT;
+        if ( aggregate->type != JSON_COUNT ) error = compile( job.paths + i, aggregate->path );
+    }
+    if ( !error ) {
+        pthread_mutex_init( &job.mutex, 0 );
+        jsonNdjson_t const ndjson = {
+            .threads = config->threads,
+            .ctx = &job,
+            .process = accumulate,
+            .patterns = config->patterns,
+            .patternQty = config->patternQty,
+            .threadStart = tableCreate,
+            .threadEnd = tableDone
+        };
+        error = json_ndjsonRun( &ndjson, text, len );
+        pthread_mutex_destroy( &job.mutex );
+    }
+    table_t* const merged = job.tables;
+    if ( !merged ) error = -1;
+    table_t* table;
+    for( table = merged ? merged->next : 0; table; ) {
+        if ( !error ) error = merge( merged, table );
+        table_t* const next = table->next;
+        freeTable( table );
+        table = next;
+    }
+    if ( !error ) error = result( merged, groups );
+    if ( merged ) freeTable( merged );
+    for( i = 0; job.keys && i < config->keyQty; ++i )
+        freePath( job.keys + i );
+    for( i = 0; job.paths && i < config->aggregateQty; ++i )
+        freePath( job.paths + i );
+    free( job.paths );
+    free( job.keys );
+    if ( !error ) return 0;
+    json_groupsFree( groups );
+    return -1;
+}
+
+/* Free the memory of the result of a group-by. */
+void json_groupsFree( jsonGroups_t* groups ) {
+    free( groups->keys );
+    free( groups->types );
+    free( groups->values );
+    free( groups->text );
+    memset( groups, 0, sizeof *groups );
+}
@@ -0,0 +1,143 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_AGGREGATE_H_
+#define	_TINY_JSON_AGGREGATE_H_
+
+#ifdef TINY_JSON_USE_WCHAR
+#error "tiny-json-aggregate.h works with char strings only, it cannot be used when TINY_JSON_USE_WCHAR is defined."
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "tiny-json.h"
+#include "tiny-json-ndjson.h"
+
+/** @defgroup tinyJsonAggregate Group-by aggregation of NDJSON texts.
+  * The lines of an NDJSON text are grouped by the values of some paths and
+  * counted, summed and so on in a single pass. Each thread of
+  * json_ndjsonRun() accumulates into its own hash table and the tables are
+  * merged at the end, so the threads never wait for each other. Only the
+  * paths of the keys and of the aggregates are looked up in each line.
+  * POSIX threads only.
+  * @{ */
+
+/** Number of registers of the estimator of distinct values is 2 to this
+  * power. The standard error of the estimations is about 1.04 / sqrt( 2048 ),
+  * 2.3%. An estimator keeps only the registers set, 4 bytes each, until 128
+  * are set, and then takes 2 KB. So each distinct aggregate takes at most
+  * 2 KB per group and thread, and much less in the groups with few values. */
+#define JSON_DISTINCT_BITS 11
+
+/** Kinds of aggregates. */
+typedef enum {
+    JSON_COUNT,    /**< Number of lines of the group.                      */
+    JSON_SUM,      /**< Sum of the numbers. Other values are ignored.      */
+    JSON_MIN,      /**< Minimum of the numbers. NaN if there are none.     */
+    JSON_MAX,      /**< Maximum of the numbers. NaN if there are none.     */
+    JSON_DISTINCT  /**< Approximate number of distinct primitive values.   */
+} jsonAggregateType_t;
+
+/** An aggregate to compute for each group. */
+typedef struct jsonAggregate_s {
+    jsonAggregateType_t type;
+    char const* path;      /**< Path of the values, f.i. "request.bytes" or
+                                "items.0.price". Ignored by JSON_COUNT.    */
+} jsonAggregate_t;
+
+/** Configuration of a group-by. */
+typedef struct jsonGroupBy_s {
+    unsigned int threads;  /**< Number of threads. See jsonNdjson_t.       */
+    char const* const* keys; /**< Paths of the values that define a group. */
+    unsigned int keyQty;   /**< Number of keys. Zero for a single group.   */
+    jsonAggregate_t const* aggregates; /**< Aggregates of each group.      */
+    unsigned int aggregateQty; /**< Number of aggregates.                  */
+    char const* const* patterns; /**< Optional prefilter. See jsonNdjson_t. */
+    unsigned int patternQty; /**< Number of patterns.                      */
+} jsonGroupBy_t;
+
+/** Result of a group-by. The groups are sorted by their keys. */
+typedef struct jsonGroups_s {
+    size_t qty;            /**< Number of groups.                          */
+    unsigned int keyQty;   /**< Number of keys per group.                  */
+    unsigned int aggregateQty; /**< Number of aggregates per group.        */
+    /** Values of the keys, keyQty per group. Texts without quotation marks,
+      * other primitives as written, f.i. "42" or "true", and objects and
+      * arrays as "{}" and "[]". Null pointer if the path is missing. */
+    char const** keys;
+    jsonType_t* types;     /**< Types of the keys. JSON_NULL if missing.   */
+    double* values;        /**< Results of the aggregates, aggregateQty per group. */
+    unsigned long lines;   /**< Number of lines aggregated.                */
+    unsigned long invalid; /**< Number of lines that are not valid JSON.   */
+    char* text;            /**< Storage of the keys.                       */
+} jsonGroups_t;
+
+/** Group the lines of an NDJSON text and compute the aggregates of each group.
+  * The memory is proportional to the number of groups times the number of
+  * threads, see JSON_DISTINCT_BITS for the distinct aggregates.
+  * @param config The configuration.
+  * @param text The text. It is not modified.
+  * @param len Length of the text.
+  * @param groups The handler of the result. Free it with json_groupsFree().
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory or threads. */
+int json_groupBy( jsonGroupBy_t const* config, char const* text, size_t len, jsonGroups_t* groups );
+
+/** Get the value of a key of a group.
+  * @param groups The result of a group-by.
+  * @param group Index of the group.
+  * @param key Index of the key.
+  * @return The value. See jsonGroups_t. */
+static inline char const* json_groupKey( jsonGroups_t const* groups, size_t group, unsigned int key ) {
+    return groups->keys[ group * groups->keyQty + key ];
+}
+
+/** Get the result of an aggregate of a group.
+  * @param groups The result of a group-by.
+  * @param group Index of the group.
+  * @param aggregate Index of the aggregate.
+  * @return The result. */
+static inline double json_groupValue( jsonGroups_t const* groups, size_t group, unsigned int aggregate ) {
+    return groups->values[ group * groups->aggregateQty + aggregate ];
+}
+
+/** Free the memory of the result of a group-by.
+  * @param groups The handler of the result. */
+void json_groupsFree( jsonGroups_t* groups );
+
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_AGGREGATE_H_ */
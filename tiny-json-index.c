@@ -0,0 +1,288 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "tiny-json-index.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define TINY_JSON_SSE2
+#endif
+
+/** Minimum length of a chunk. Shorter texts are not split. */
+#define MIN_CHUNK ( 64 * 1024 )
+
+/** Structure to handle the part of the text classified by one thread. */
+typedef struct chunk_s {
+    char const* str;       /**< The whole text.                            */
+    size_t begin;          /**< Position of the first character.           */
+    size_t end;            /**< Position after the last character.         */
+    pthread_t thread;      /**< The thread that classifies the chunk.      */
+    bool started;          /**< The thread was created.                    */
+    /* First pass, independent of the previous chunks: */
+    size_t lead;           /**< Length of the leading run of backslashes.  */
+    bool leadQuote;        /**< The character after it is a quotation mark.*/
+    size_t quotes;         /**< Quotation marks not escaped after it.      */
+    bool escOut;           /**< The first character of the next chunk is escaped. */
+    /* State at the first character, resolved by the prefix pass: */
+    bool escaped;          /**< The first character is escaped.            */
+    bool inString;         /**< The first character is within a string.    */
+    /* Second pass: */
+    size_t* pos;           /**< Positions of the structural characters.    */
+    size_t qty;            /**< Number of positions.                       */
+    size_t cap;            /**< Capacity of the array of positions.        */
+    bool failed;           /**< There was not enough memory.               */
+    /* Merge: */
+    size_t* out;           /**< Destination of the positions in the index. */
+} chunk_t;
+
+#ifdef TINY_JSON_SSE2
+/** Get a mask of the bytes of a vector that are equal to a character. */
+#define match( vector, ch ) _mm_cmpeq_epi8( (vector), _mm_set1_epi8( ch ) )
+#endif
+
+/** Get the position of the next quotation mark or backslash.
+  * @param str The text.
+  * @param pos Position to start the search.
+  * @param end Position to stop the search.
+  * @return The position found or end if not found. */
+static size_t nextQuote( char const* str, size_t pos, size_t end ) {
+#ifdef TINY_JSON_SSE2
+    for( ; pos + 16 <= end; pos += 16 ) {
+        __m128i const v = _mm_loadu_si128( (__m128i const*)( str + pos ) );
+        int const mask = _mm_movemask_epi8( _mm_or_si128( match( v, '\"' ), match( v, '\\' ) ) );
+        if ( mask ) return pos + (size_t)__builtin_ctz( (unsigned int)mask );
+    }
+#endif
+    for( ; pos < end; ++pos )
+        if ( str[pos] == '\"' || str[pos] == '\\' )
+            return pos;
+    return end;
+}
+
+/** Get the position of the next structural character, quotation mark or backslash.
+  * @param str The text.
+  * @param pos Position to start the search.
+  * @param end Position to stop the search.
+  * @return The position found or end if not found. */
+static size_t nextStructural( char const* str, size_t pos, size_t end ) {
+#ifdef TINY_JSON_SSE2
+    for( ; pos + 16 <= end; pos += 16 ) {
+        __m128i const v = _mm_loadu_si128( (__m128i const*)( str + pos ) );
+        /* '[' and ']' are '{' and '}' without the bit 0x20. */
+        __m128i const braces = _mm_or_si128( v, _mm_set1_epi8( 0x20 ) );
+        __m128i const any = _mm_or_si128(
+            _mm_or_si128( _mm_or_si128( match( braces, '{' ), match( braces, '}' ) ),
+                          _mm_or_si128( match( v, ':' ), match( v, ',' ) ) ),
+            _mm_or_si128( match( v, '\"' ), match( v, '\\' ) ) );
+        int const mask = _mm_movemask_epi8( any );
+        if ( mask ) return pos + (size_t)__builtin_ctz( (unsigned int)mask );
+    }
+#endif
+    for( ; pos < end; ++pos )
+        if ( str[pos] && strchr( "{}[]:,\"\\", str[pos] ) )
+            return pos;
+    return end;
+}
+
+/** First pass. Count the quotation marks that are not escaped and get the
+  * runs of backslashes at both ends, that depend on the previous chunk.
+  * @param arg The handler of the chunk.
+  * @return Null pointer. */
+static void* countQuotes( void* arg ) {
+    chunk_t* const chunk = (chunk_t*)arg;
+    char const* const str = chunk->str;
+    size_t const end = chunk->end;
+    size_t pos = chunk->begin;
+    while( pos < end && str[pos] == '\\' ) ++pos;
+    chunk->lead = pos - chunk->begin;
+    chunk->leadQuote = false;
+    chunk->quotes = 0;
+    chunk->escOut = false;
+    if ( pos == end ) return 0;
+    chunk->leadQuote = str[pos] == '\"';
+    for( ++pos;; ) {
+        pos = nextQuote( str, pos, end );
+        if ( pos == end ) return 0;
+        if ( str[pos] == '\"' ) {
+            ++chunk->quotes;
+            ++pos;
+            continue;
+        }
+        size_t const run = pos;
+        while( pos < end && str[pos] == '\\' ) ++pos;
+        bool const odd = ( pos - run ) & 1;
+        if ( pos == end ) {
+            chunk->escOut = odd;
+            return 0;
+        }
+        if ( odd ) ++pos;
+    }
+}
+
+/** Add a position to the structural characters of a chunk.
+  * @param chunk The handler of the chunk.
+  * @param pos The position.
+  * @return true or false if there was memory or not. */
+static bool addPosition( chunk_t* chunk, size_t pos ) {
+    if ( chunk->qty == chunk->cap ) {
+        size_t const cap = chunk->cap ? 2 * chunk->cap : 1024;
+        size_t* const tmp = (size_t*)realloc( chunk->pos, cap * sizeof *tmp );
+        if ( !tmp ) return false;
+        chunk->pos = tmp;
+        chunk->cap = cap;
+    }
+    chunk->pos[ chunk->qty++ ] = pos;
+    return true;
+}
+
+/** Second pass. Get the positions of the structural characters of a chunk
+  * once its state at the first character is known.
+  * @param arg The handler of the chunk.
+  * @return Null pointer. */
+static void* findStructurals( void* arg ) {
+    chunk_t* const chunk = (chunk_t*)arg;
+    char const* const str = chunk->str;
+    size_t const end = chunk->end;
+    size_t pos = chunk->begin;
+    bool inString = chunk->inString;
+    if ( chunk->escaped ) ++pos;
+    while( pos < end ) {
+        pos = inString ? nextQuote( str, pos, end ): nextStructural( str, pos, end );
+        if ( pos == end ) return 0;
+        if ( str[pos] == '\\' ) {
+            pos += 2;
+            continue;
+        }
+        if ( str[pos] == '\"' ) inString = !inString;
+        if ( !addPosition( chunk, pos ) ) {
+            chunk->failed = true;
+            return 0;
+        }
+        ++pos;
+    }
+    return 0;
+}
+
+/** Merge. Copy the positions of a chunk into the index.
+  * @param arg The handler of the chunk.
+  * @return Null pointer. */
+static void* copyPositions( void* arg ) {
+    chunk_t* const chunk = (chunk_t*)arg;
+    if ( chunk->qty ) memcpy( chunk->out, chunk->pos, chunk->qty * sizeof *chunk->pos );
+    return 0;
+}
+
+/** Run a pass over all the chunks, one thread each. The first chunk is done
+  * by the calling thread, and so are the chunks whose thread failed to start.
+  * @param chunks Array of chunks.
+  * @param qty Number of chunks.
+  * @param pass The function of the pass. */
+static void runPass( chunk_t* chunks, unsigned int qty, void* (*pass)( void* ) ) {
+    unsigned int i;
+    for( i = 1; i < qty; ++i )
+        chunks[i].started = !pthread_create( &chunks[i].thread, 0, pass, chunks + i );
+    pass( chunks );
+    for( i = 1; i < qty; ++i ) {
+        if ( chunks[i].started ) pthread_join( chunks[i].thread, 0 );
+        else pass( chunks + i );
+    }
+}
+
+/* Build the structural index of a JSON text. */
+int json_indexBuild( jsonIndex_t* index, char const* str, size_t len, unsigned int threads ) {
+    index->pos = 0;
+    index->qty = 0;
+    size_t qty = len / MIN_CHUNK;
+    if ( qty > threads ) qty = threads;
+    if ( !qty ) qty = 1;
+    chunk_t* const chunks = (chunk_t*)calloc( qty, sizeof *chunks );
+    if ( !chunks ) return -1;
+    size_t i;
+    for( i = 0; i < qty; ++i ) {
+        chunks[i].str = str;
+        chunks[i].begin = len / qty * i;
+        chunks[i].end = i + 1 == qty ? len : len / qty * ( i + 1 );
+    }
+
+    runPass( chunks, (unsigned int)qty, countQuotes );
+
+    bool escaped = false;
+    bool inString = false;
+    for( i = 0; i < qty; ++i ) {
+        chunk_t* const chunk = chunks + i;
+        chunk->escaped = escaped;
+        chunk->inString = inString;
+        size_t const length = chunk->end - chunk->begin;
+        if ( chunk->lead == length ) {
+            escaped ^= length & 1;
+            continue;
+        }
+        bool const leadEscaped = ( chunk->lead + escaped ) & 1;
+        size_t const quotes = chunk->quotes + ( chunk->leadQuote && !leadEscaped );
+        inString ^= quotes & 1;
+        escaped = chunk->escOut;
+    }
+
+    runPass( chunks, (unsigned int)qty, findStructurals );
+
+    size_t total = 0;
+    bool failed = false;
+    for( i = 0; i < qty; ++i ) {
+        failed |= chunks[i].failed;
+        total += chunks[i].qty;
+    }
+    if ( !failed ) index->pos = (size_t*)malloc( ( total ? total : 1 ) * sizeof *index->pos );
+    if ( index->pos ) {
+        size_t offset = 0;
+        for( i = 0; i < qty; ++i ) {
+            chunks[i].out = index->pos + offset;
+            offset += chunks[i].qty;
+        }
+        runPass( chunks, (unsigned int)qty, copyPositions );
+        index->qty = total;
+    }
+
+    for( i = 0; i < qty; ++i )
+        free( chunks[i].pos );
+    free( chunks );
+    return index->pos ? 0 : -1;
+}
+
+/* Free the memory of a structural index. */
+void json_indexFree( jsonIndex_t* index ) {
+    free( index->pos );
+    index->pos = 0;
+    index->qty = 0;
+}
@@ -0,0 +1,73 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_INDEX_H_
+#define	_TINY_JSON_INDEX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "tiny-json.h"
+
+/** @defgroup tinyJsonIndex Parallel structural indexer.
+  * The text of a huge document is split into chunks that are classified by
+  * several threads. The state of each chunk (in or out of a string, escaped
+  * first character) is resolved with a prefix pass over the parity of the
+  * quotation marks and backslashes, and the positions found by the threads
+  * are merged into one index for json_createWithIndex(). POSIX threads only.
+  * @{ */
+
+/** Structural index of a JSON text. */
+typedef struct jsonIndex_s {
+    size_t* pos;           /**< Positions of the structural characters.    */
+    size_t qty;            /**< Number of positions.                       */
+} jsonIndex_t;
+
+/** Build the structural index of a JSON text.
+  * @param index The handler of the index to build.
+  * @param str The JSON text. It is not modified.
+  * @param len Length of the text.
+  * @param threads Number of threads. Zero or one indexes in the calling thread.
+  * @retval 0 if success. The index must be freed with json_indexFree().
+  * @retval -1 if there was not enough memory. */
+int json_indexBuild( jsonIndex_t* index, char const* str, size_t len, unsigned int threads );
+
+/** Free the memory of a structural index.
+  * @param index The handler of the index. */
+void json_indexFree( jsonIndex_t* index );
+
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_INDEX_H_ */
@@ -0,0 +1,357 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "tiny-json-inflate.h"
+
+#ifdef TINY_JSON_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef TINY_JSON_USE_ZSTD
+#include <zstd.h>
+#endif
+
+/** Default size of a window of decompressed text. */
+#define WINDOW_SIZE ( 4 * 1024 * 1024 )
+
+/** Size of the buffer of compressed bytes. */
+#define INPUT_SIZE ( 128 * 1024 )
+
+/** State of the decompression of a stream. */
+typedef struct decoder_s {
+    jsonInflate_t const* config;
+    jsonCompression_t format;
+    unsigned char* in;     /**< Buffer of compressed bytes.                */
+    size_t pos;            /**< Position of the next byte to decode.       */
+    size_t len;            /**< Number of bytes in the buffer.             */
+    bool eof;              /**< The read callback returned zero.           */
+    bool boundary;         /**< Between two gzip members or zstd frames.   */
+    bool finished;         /**< All the stream was decoded.                */
+#ifdef TINY_JSON_USE_ZLIB
+    z_stream zlib;
+    bool zlibReady;        /**< The zlib stream was initialized.           */
+#endif
+#ifdef TINY_JSON_USE_ZSTD
+    ZSTD_DStream* zstd;
+#endif
+} decoder_t;
+
+/** Window of decompressed text. */
+typedef struct window_s {
+    char* data;
+    size_t cap;            /**< Size of the window.                        */
+    size_t len;            /**< Length of the complete lines handed over.  */
+    bool full;             /**< It waits to be processed.                  */
+} window_t;
+
+/** State shared by the two threads. It is protected by the mutex. */
+typedef struct job_s {
+    decoder_t decoder;     /**< Only used by the decompression thread.     */
+    window_t windows[2];
+    bool end;              /**< No more windows will be handed over.       */
+    bool error;            /**< The stream is corrupt or there was not enough memory. */
+    bool stop;             /**< The processing stopped.                    */
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} job_t;
+
+/* Get the format of a stream from its first bytes. */
+jsonCompression_t json_inflateFormat( void const* data, size_t len ) {
+    unsigned char const* const bytes = (unsigned char const*)data;
+    if ( len >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b ) return JSON_GZIP;
+    if ( len >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 && bytes[2] == 0x2f && bytes[3] == 0xfd ) return JSON_ZSTD;
+    return JSON_PLAIN;
+}
+
+/* Check whether a format can be decompressed by this build. */
+int json_inflateSupported( jsonCompression_t format ) {
+#ifdef TINY_JSON_USE_ZLIB
+    if ( format == JSON_GZIP ) return 1;
+#endif
+#ifdef TINY_JSON_USE_ZSTD
+    if ( format == JSON_ZSTD ) return 1;
+#endif
+    return format == JSON_PLAIN;
+}
+
+/** Read the first bytes of a stream and prepare the decompression of its format.
+  * @retval 0 if success.
+  * @retval -1 if the format is not supported or there was not enough memory. */
+static int decoderInit( decoder_t* decoder, jsonInflate_t const* config ) {
+    memset( decoder, 0, sizeof *decoder );
+    decoder->config = config;
+    decoder->boundary = true;
+    decoder->in = (unsigned char*)malloc( INPUT_SIZE );
+    if ( !decoder->in ) return -1;
+    while( decoder->len < 4 && !decoder->eof ) {
+        size_t const len = config->read( config->ctx, decoder->in + decoder->len, INPUT_SIZE - decoder->len );
+        decoder->eof = !len;
+        decoder->len += len;
+    }
+    decoder->format = json_inflateFormat( decoder->in, decoder->len );
+    if ( !json_inflateSupported( decoder->format ) ) return -1;
+#ifdef TINY_JSON_USE_ZLIB
+    if ( decoder->format == JSON_GZIP ) {
+        if ( inflateInit2( &decoder->zlib, 15 + 32 ) != Z_OK ) return -1;
+        decoder->zlibReady = true;
+    }
+#endif
+#ifdef TINY_JSON_USE_ZSTD
+    if ( decoder->format == JSON_ZSTD ) {
+        decoder->zstd = ZSTD_createDStream();
+        if ( !decoder->zstd || ZSTD_isError( ZSTD_initDStream( decoder->zstd ) ) ) return -1;
+    }
+#endif
+    return 0;
+}
+
+/** Free the resources of the decompression. */
+static void decoderFree( decoder_t* decoder ) {
+#ifdef TINY_JSON_USE_ZLIB
+    if ( decoder->zlibReady ) inflateEnd( &decoder->zlib );
+#endif
+#ifdef TINY_JSON_USE_ZSTD
+    if ( decoder->zstd ) ZSTD_freeDStream( decoder->zstd );
+#endif
+    free( decoder->in );
+}
+
+/** Decompress text until a buffer is full or the stream ends.
+  * @param decoder The state of the decompression.
+  * @param out The buffer.
+  * @param cap Size of the buffer.
+  * @param produced Pointer to store the length of the text. If it is less
+  *        than cap the stream has ended.
+  * @retval 0 if success.
+  * @retval -1 if the stream is corrupt or truncated. */
+static int decode( decoder_t* decoder, char* out, size_t cap, size_t* produced ) {
+    jsonInflate_t const* const config = decoder->config;
+    size_t done = 0;
+    while( done < cap && !decoder->finished ) {
+        if ( decoder->pos == decoder->len && !decoder->eof ) {
+            decoder->pos = 0;
+            decoder->len = config->read( config->ctx, decoder->in, INPUT_SIZE );
+            decoder->eof = !decoder->len;
+        }
+        size_t const avail = decoder->len - decoder->pos;
+        if ( !avail && decoder->eof ) {
+            if ( !decoder->boundary ) return -1;
+            decoder->finished = true;
+            break;
+        }
+        if ( decoder->format == JSON_PLAIN ) {
+            size_t const len = avail < cap - done ? avail : cap - done;
+            memcpy( out + done, decoder->in + decoder->pos, len );
+            decoder->pos += len;
+            done += len;
+            continue;
+        }
+#ifdef TINY_JSON_USE_ZLIB
+        if ( decoder->format == JSON_GZIP ) {
+            z_stream* const zlib = &decoder->zlib;
+            zlib->next_in = decoder->in + decoder->pos;
+            zlib->avail_in = (uInt)avail;
+            zlib->next_out = (Bytef*)out + done;
+            zlib->avail_out = (uInt)( cap - done < UINT32_MAX ? cap - done : UINT32_MAX );
+            int const ret = inflate( zlib, Z_NO_FLUSH );
+            size_t const consumed = avail - zlib->avail_in;
+            size_t const len = (size_t)( (char*)zlib->next_out - ( out + done ) );
+            decoder->pos += consumed;
+            done += len;
+            if ( ret == Z_STREAM_END ) {
+                /* Another member may follow. */
+                decoder->boundary = true;
+                if ( inflateReset( zlib ) != Z_OK ) return -1;
+            }
+            else if ( ret == Z_OK || ( ret == Z_BUF_ERROR && !consumed && !len ) ) {
+                if ( consumed || len ) decoder->boundary = false;
+            }
+            else return -1;
+            continue;
+        }
+#endif
+#ifdef TINY_JSON_USE_ZSTD
+        if ( decoder->format == JSON_ZSTD ) {
+            ZSTD_inBuffer input = { decoder->in, decoder->len, decoder->pos };
+            ZSTD_outBuffer output = { out, cap, done };
+            size_t const ret = ZSTD_decompressStream( decoder->zstd, &output, &input );
+            if ( ZSTD_isError( ret ) ) return -1;
+            decoder->pos = input.pos;
+            done = output.pos;
+            /* Zero when a frame was completely decoded and flushed. */
+            decoder->boundary = !ret;
+            continue;
+        }
+#endif
+        return -1;
+    }
+    *produced = done;
+    return 0;
+}
+
+/** Get the length of the complete lines of a text.
+  * @return Position after its last end of line or zero if there is none. */
+static size_t completeLines( char const* text, size_t len ) {
+    while( len && text[ len - 1 ] != '\n' ) --len;
+    return len;
+}
+
+/** Make sure a window has at least a size.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int reserve( window_t* window, size_t cap ) {
+    if ( window->cap >= cap ) return 0;
+    char* const data = (char*)realloc( window->data, cap );
+    if ( !data ) return -1;
+    window->data = data;
+    window->cap = cap;
+    return 0;
+}
+
+/** Decompression thread. It fills a window while the other one is processed
+  * and hands it over with its complete lines.
+  * @param arg The handler of the job.
+  * @return Null pointer. */
+static void* decompressThread( void* arg ) {
+    job_t* const job = (job_t*)arg;
+    unsigned int current = 0;
+    size_t carry = 0;
+    bool error = false;
+    for(;;) {
+        window_t* const window = job->windows + current;
+        size_t produced;
+        if ( decode( &job->decoder, window->data + carry, window->cap - carry, &produced ) ) {
+            error = true;
+            break;
+        }
+        size_t const filled = carry + produced;
+        bool const last = filled < window->cap;
+        size_t const complete = last ? filled : completeLines( window->data, filled );
+        if ( !complete && !last ) {
+            /* A line does not fit in the window. */
+            carry = filled;
+            if ( reserve( window, 2 * window->cap ) ) {
+                error = true;
+                break;
+            }
+            continue;
+        }
+        window_t* const next = job->windows + ( current ^ 1 );
+        size_t const tail = filled - complete;
+        if ( !last ) {
+            pthread_mutex_lock( &job->mutex );
+            while( next->full && !job->stop )
+                pthread_cond_wait( &job->cond, &job->mutex );
+            bool const stop = job->stop;
+            pthread_mutex_unlock( &job->mutex );
+            if ( stop ) break;
+            if ( reserve( next, 2 * tail ) ) {
+                error = true;
+                break;
+            }
+            memcpy( next->data, window->data + complete, tail );
+        }
+        pthread_mutex_lock( &job->mutex );
+        window->len = complete;
+        window->full = true;
+        job->end = last;
+        pthread_cond_broadcast( &job->cond );
+        pthread_mutex_unlock( &job->mutex );
+        if ( last ) break;
+        carry = tail;
+        current ^= 1;
+    }
+    pthread_mutex_lock( &job->mutex );
+    job->error = error;
+    job->end = true;
+    pthread_cond_broadcast( &job->cond );
+    pthread_mutex_unlock( &job->mutex );
+    return 0;
+}
+
+/** Process the windows in order as they are handed over.
+  * @retval 0 if success.
+  * @retval -1 if the processing stopped. */
+static int processWindows( job_t* job, jsonNdjson_t const* ndjson ) {
+    unsigned int current = 0;
+    for(;;) {
+        window_t* const window = job->windows + current;
+        pthread_mutex_lock( &job->mutex );
+        while( !window->full && !job->end )
+            pthread_cond_wait( &job->cond, &job->mutex );
+        bool const ready = window->full;
+        pthread_mutex_unlock( &job->mutex );
+        if ( !ready ) return 0;
+        if ( window->len && json_ndjsonRun( ndjson, window->data, window->len ) ) return -1;
+        pthread_mutex_lock( &job->mutex );
+        window->full = false;
+        pthread_cond_broadcast( &job->cond );
+        pthread_mutex_unlock( &job->mutex );
+        current ^= 1;
+    }
+}
+
+/* Decompress a stream and process its lines. */
+int json_inflateRun( jsonInflate_t const* config, jsonNdjson_t const* ndjson ) {
+    size_t const windowSize = config->windowSize ? config->windowSize : WINDOW_SIZE;
+    job_t job;
+    memset( job.windows, 0, sizeof job.windows );
+    job.end = false;
+    job.error = false;
+    job.stop = false;
+    int result = -1;
+    if ( !decoderInit( &job.decoder, config )
+         && !reserve( job.windows, windowSize ) && !reserve( job.windows + 1, windowSize ) ) {
+        pthread_mutex_init( &job.mutex, 0 );
+        pthread_cond_init( &job.cond, 0 );
+        pthread_t thread;
+        if ( !pthread_create( &thread, 0, decompressThread, &job ) ) {
+            result = processWindows( &job, ndjson );
+            pthread_mutex_lock( &job.mutex );
+            job.stop = true;
+            pthread_cond_broadcast( &job.cond );
+            pthread_mutex_unlock( &job.mutex );
+            pthread_join( thread, 0 );
+            if ( job.error ) result = -1;
+        }
+        pthread_cond_destroy( &job.cond );
+        pthread_mutex_destroy( &job.mutex );
+    }
+    decoderFree( &job.decoder );
+    free( job.windows[0].data );
+    free( job.windows[1].data );
+    return result;
+}
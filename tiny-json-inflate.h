@@ -0,0 +1,98 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_INFLATE_H_
+#define	_TINY_JSON_INFLATE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "tiny-json.h"
+#include "tiny-json-ndjson.h"
+
+/** @defgroup tinyJsonInflate Compressed NDJSON streams.
+  * A compressed stream is decompressed by a second thread into two windows
+  * that are reused all along. While the lines of one window are processed
+  * with json_ndjsonRun() the next window is being decompressed, and the
+  * incomplete line at the end of a window is moved to the start of the next
+  * one. gzip needs zlib and TINY_JSON_USE_ZLIB defined, zstd needs libzstd
+  * and TINY_JSON_USE_ZSTD defined. Streams that are not compressed are
+  * always accepted. POSIX threads only.
+  * @{ */
+
+/** Formats of the streams. */
+typedef enum {
+    JSON_PLAIN,            /**< Not compressed.                            */
+    JSON_GZIP,             /**< gzip, concatenated members included.       */
+    JSON_ZSTD              /**< Zstandard, concatenated frames included.   */
+} jsonCompression_t;
+
+/** Configuration of the decompression of a stream. */
+typedef struct jsonInflate_s {
+    size_t windowSize;     /**< Size of each window. Zero for 4 MB. A window
+                                grows if a line does not fit.              */
+    void* ctx;             /**< Context passed to read.                    */
+    /** Read the next bytes of the compressed stream. It may be called from
+      * another thread than the one that calls json_inflateRun().
+      * @param ctx The context.
+      * @param buf Buffer to store the bytes.
+      * @param cap Size of buf.
+      * @return Number of bytes read, zero at the end of the stream. */
+    size_t (*read)( void* ctx, void* buf, size_t cap );
+} jsonInflate_t;
+
+/** Get the format of a stream from its first bytes.
+  * @param data The first bytes of the stream.
+  * @param len Number of bytes. Four are enough.
+  * @return The format. */
+jsonCompression_t json_inflateFormat( void const* data, size_t len );
+
+/** Check whether a format can be decompressed by this build.
+  * @param format The format.
+  * @return Whether it is supported. */
+int json_inflateSupported( jsonCompression_t format );
+
+/** Decompress a stream and process its lines.
+  * @param config The configuration of the decompression.
+  * @param ndjson The configuration of the processing of the lines.
+  * @retval 0 when all the lines have been processed.
+  * @retval -1 if the format is not supported, the stream is corrupt or
+  *         truncated, a callback stopped the processing or there was not
+  *         enough memory or threads. */
+int json_inflateRun( jsonInflate_t const* config, jsonNdjson_t const* ndjson );
+
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_INFLATE_H_ */
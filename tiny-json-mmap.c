@@ -0,0 +1,90 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#define _DEFAULT_SOURCE
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <stdint.h>
+#include "tiny-json-mmap.h"
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
+/** Size of a transparent huge page. The mapping is aligned to it. */
+#define HUGE_PAGE ( 2u * 1024u * 1024u )
+
+/** Round a length up to a multiple of a power of two. */
+static size_t roundUp( size_t len, size_t align ) {
+    return ( len + align - 1 ) & ~( align - 1 );
+}
+
+/* Reserve the virtual memory of an arena. */
+int json_mapArenaCreate( jsonMapArena_t* marena, unsigned int qty, bool hugePages ) {
+    size_t const bytes = roundUp( (size_t)qty * sizeof( json_t ), HUGE_PAGE );
+    size_t const reserved = bytes + HUGE_PAGE;
+    void* const map = mmap( 0, reserved, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+    if ( map == MAP_FAILED ) return -1;
+    uintptr_t const begin = (uintptr_t)map;
+    uintptr_t const base = roundUp( begin, HUGE_PAGE );
+    if ( base > begin ) munmap( map, base - begin );
+    size_t const tail = begin + reserved - ( base + bytes );
+    if ( tail ) munmap( (void*)( base + bytes ), tail );
+#ifdef MADV_HUGEPAGE
+    if ( hugePages ) madvise( (void*)base, bytes, MADV_HUGEPAGE );
+#else
+    (void)hugePages;
+#endif
+    marena->base = (void*)base;
+    marena->bytes = bytes;
+    json_arenaInit( &marena->arena, marena->base, qty );
+    return 0;
+}
+
+/* Free all the json properties of an arena and return its pages. */
+void json_mapArenaReset( jsonMapArena_t* marena ) {
+    size_t const page = (size_t)sysconf( _SC_PAGESIZE );
+    size_t touched = roundUp( json_arenaUsed( &marena->arena ) * sizeof( json_t ), page );
+    if ( touched > marena->bytes ) touched = marena->bytes;
+    if ( touched ) madvise( marena->base, touched, MADV_DONTNEED );
+    json_arenaReset( &marena->arena );
+}
+
+/* Release the virtual memory of an arena. */
+void json_mapArenaDestroy( jsonMapArena_t* marena ) {
+    munmap( marena->base, marena->bytes );
+    marena->base = 0;
+    marena->bytes = 0;
+}
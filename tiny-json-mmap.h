@@ -0,0 +1,79 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_MMAP_H_
+#define	_TINY_JSON_MMAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "tiny-json.h"
+
+/** @defgroup tinyJsonMmap Arenas of virtual memory.
+  * For documents of millions of properties the arena is reserved as virtual
+  * memory with mmap(), so the pages are only committed when a parser touches
+  * them, and it can be backed by transparent huge pages to reduce the misses
+  * of the TLB when the tree is traversed. POSIX only.
+  * @{ */
+
+/** Structure to handle an arena of json properties in virtual memory. */
+typedef struct jsonMapArena_s {
+    jsonArena_t arena;     /**< The arena to take the pools of the threads from. */
+    void* base;            /**< Start of the mapping.                      */
+    size_t bytes;          /**< Length of the mapping.                     */
+} jsonMapArena_t;
+
+/** Reserve the virtual memory of an arena.
+  * @param marena The handler of the arena.
+  * @param qty Maximum number of json properties.
+  * @param hugePages Ask for transparent huge pages with madvise().
+  * @retval 0 if success. The arena must be released with json_mapArenaDestroy().
+  * @retval -1 if the address space could not be reserved. */
+int json_mapArenaCreate( jsonMapArena_t* marena, unsigned int qty, bool hugePages );
+
+/** Free all the json properties of an arena at once and return its pages to
+  * the system with madvise( MADV_DONTNEED ). The same restrictions of
+  * json_arenaReset() apply.
+  * @param marena The handler of the arena. */
+void json_mapArenaReset( jsonMapArena_t* marena );
+
+/** Release the virtual memory of an arena.
+  * @param marena The handler of the arena. */
+void json_mapArenaDestroy( jsonMapArena_t* marena );
+
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_MMAP_H_ */
@@ -0,0 +1,419 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "tiny-json-ndjson.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define TINY_JSON_SSE2
+#endif
+
+/** Default size of a batch of lines. */
+#define BATCH_SIZE ( 1024 * 1024 )
+
+/** Number of batches in flight per thread. It bounds the memory of the outputs. */
+#define WINDOW 4
+
+/** Initial number of json properties of the pool of a thread. */
+#define POOL_SIZE 256
+
+/** Output of a batch waiting to be written. */
+typedef struct batch_s {
+    jsonBuffer_t out;      /**< Output of the lines of the batch.          */
+    size_t index;          /**< Sequence number of the batch.              */
+    bool done;             /**< All its lines were processed.              */
+} batch_t;
+
+/** State shared by the threads. It is protected by the mutex. */
+typedef struct job_s {
+    jsonNdjson_t const* ndjson;
+    char const* text;      /**< The whole text.                            */
+    size_t len;            /**< Length of the text.                        */
+    size_t batchSize;      /**< Approximate size of a batch.               */
+    size_t offset;         /**< Start of the next batch to take.           */
+    size_t taken;          /**< Number of batches taken.                   */
+    size_t emitted;        /**< Number of batches written.                 */
+    unsigned int window;   /**< Number of batches in flight.               */
+    batch_t* batches;      /**< Ring of batches in flight.                 */
+    bool stop;             /**< A callback or an allocation failed.        */
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} job_t;
+
+/** Resources of a thread reused for all its lines. */
+typedef struct worker_s {
+    char* line;            /**< Copy of the line to parse in place.        */
+    size_t cap;            /**< Size of the copy.                          */
+    json_t* mem;           /**< Pool of json properties.                   */
+    unsigned int qty;      /**< Length of the pool.                        */
+    void* ctx;             /**< Context passed to process.                 */
+} worker_t;
+
+/** Initialize the resources of a thread and create its context.
+  * @retval 0 if success.
+  * @retval -1 if threadStart failed. */
+static int workerInit( worker_t* worker, jsonNdjson_t const* ndjson ) {
+    worker->line = 0;
+    worker->cap = 0;
+    worker->mem = 0;
+    worker->qty = 0;
+    worker->ctx = ndjson->threadStart ? ndjson->threadStart( ndjson->ctx ) : ndjson->ctx;
+    return worker->ctx || !ndjson->threadStart ? 0 : -1;
+}
+
+/** Free the resources of a thread and close its context. */
+static void workerFree( worker_t* worker, jsonNdjson_t const* ndjson ) {
+    if ( ndjson->threadEnd && ( worker->ctx || !ndjson->threadStart ) )
+        ndjson->threadEnd( ndjson->ctx, worker->ctx );
+    free( worker->mem );
+    free( worker->line );
+}
+
+/* Append characters to a buffer. */
+int json_bufferAppend( jsonBuffer_t* buffer, char const* data, size_t len ) {
+    if ( !len ) return 0;
+    if ( buffer->cap - buffer->len < len ) {
+        size_t cap = buffer->cap ? buffer->cap : 256;
+        while( cap - buffer->len < len ) cap *= 2;
+        char* const data2 = (char*)realloc( buffer->data, cap );
+        if ( !data2 ) return -1;
+        buffer->data = data2;
+        buffer->cap = cap;
+    }
+    memcpy( buffer->data + buffer->len, data, len );
+    buffer->len += len;
+    return 0;
+}
+
+/* Append a string to a buffer as a JSON string. */
+int json_bufferAppendString( jsonBuffer_t* buffer, char const* str, size_t len ) {
+    if ( json_bufferAppend( buffer, "\"", 1 ) ) return -1;
+    char const* const end = str + len;
+    char const* run = str;
+    for( ; str < end; ++str ) {
+        unsigned char const ch = (unsigned char)*str;
+        if ( ch >= 0x20 && ch != '\"' && ch != '\\' ) continue;
+        if ( json_bufferAppend( buffer, run, (size_t)( str - run ) ) ) return -1;
+        char escape[8];
+        int const n = ch == '\"' || ch == '\\' ? sprintf( escape, "\\%c", ch ) : sprintf( escape, "\\u%04x", ch );
+        if ( json_bufferAppend( buffer, escape, (size_t)n ) ) return -1;
+        run = str + 1;
+    }
+    if ( json_bufferAppend( buffer, run, (size_t)( str - run ) ) ) return -1;
+    return json_bufferAppend( buffer, "\"", 1 );
+}
+
+/** Check whether a line has only blanks. */
+static bool isBlankLine( char const* line, size_t len ) {
+    size_t i;
+    for( i = 0; i < len; ++i )
+        if ( line[i] != ' ' && line[i] != '\t' && line[i] != '\r' )
+            return false;
+    return true;
+}
+
+/** Parse a line, growing the pool until it is enough for the line.
+  * @param worker The resources of the thread.
+  * @param line The line. It is not modified.
+  * @param len Length of the line.
+  * @param json Pointer to store the root or null pointer if it is not valid.
+  * @retval 0 if the line was parsed or it is not valid.
+  * @retval -1 if there was not enough memory. */
+static int parseLine( worker_t* worker, char const* line, size_t len, json_t const** json ) {
+    if ( worker->cap < len + 1 ) {
+        size_t cap = worker->cap ? worker->cap : 256;
+        while( cap < len + 1 ) cap *= 2;
+        char* const copy = (char*)realloc( worker->line, cap );
+        if ( !copy ) return -1;
+        worker->line = copy;
+        worker->cap = cap;
+    }
+    size_t const worst = len / 2 + 2;
+    for(;;) {
+        if ( worker->qty ) {
+            memcpy( worker->line, line, len );
+            worker->line[ len ] = '\0';
+            *json = json_create( worker->line, worker->mem, worker->qty );
+            if ( *json || worker->qty >= worst ) return 0;
+        }
+        size_t qty = worker->qty ? 2 * (size_t)worker->qty : POOL_SIZE;
+        if ( qty > worst ) qty = worst;
+        json_t* const mem = (json_t*)realloc( worker->mem, qty * sizeof( json_t ) );
+        if ( !mem ) return -1;
+        worker->mem = mem;
+        worker->qty = (unsigned int)qty;
+    }
+}
+
+/** Find a string in a text. With SSE2 the first and the last characters of
+  * the string are compared at 16 positions at a time and only the positions
+  * where both match are compared whole.
+  * @param text The text.
+  * @param len Length of the text.
+  * @param pattern The string to search.
+  * @param plen Length of the string.
+  * @return Pointer to the first occurrence or null pointer if not found. */
+static char const* findPattern( char const* text, size_t len, char const* pattern, size_t plen ) {
+    if ( !plen ) return text;
+    if ( len < plen ) return 0;
+    size_t const last = len - plen;
+    size_t pos = 0;
+#ifdef TINY_JSON_SSE2
+    __m128i const first = _mm_set1_epi8( pattern[0] );
+    __m128i const final = _mm_set1_epi8( pattern[ plen - 1 ] );
+    for( ; pos + 16 <= last + 1; pos += 16 ) {
+        __m128i const a = _mm_loadu_si128( (__m128i const*)( text + pos ) );
+        __m128i const b = _mm_loadu_si128( (__m128i const*)( text + pos + plen - 1 ) );
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(
+            _mm_and_si128( _mm_cmpeq_epi8( a, first ), _mm_cmpeq_epi8( b, final ) ) );
+        while( mask ) {
+            char const* const candidate = text + pos + (size_t)__builtin_ctz( mask );
+            if ( plen <= 2 || !memcmp( candidate + 1, pattern + 1, plen - 2 ) ) return candidate;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    while( pos <= last ) {
+        char const* const candidate = (char const*)memchr( text + pos, pattern[0], last + 1 - pos );
+        if ( !candidate ) return 0;
+        if ( !memcmp( candidate + 1, pattern + 1, plen - 1 ) ) return candidate;
+        pos = (size_t)( candidate - text ) + 1;
+    }
+    return 0;
+}
+
+/** Process the lines of a batch that contain all the patterns. The first
+  * pattern is searched through the batch and the line of each occurrence is
+  * checked for the rest of patterns.
+  * @param ndjson The configuration.
+  * @param worker The resources of the thread.
+  * @param text The first line of the batch.
+  * @param len Length of the batch.
+  * @param out Buffer for the output of the batch.
+  * @retval 0 if success.
+  * @retval -1 if a callback stopped or there was not enough memory. */
+static int processCandidates( jsonNdjson_t const* ndjson, worker_t* worker,
+                              char const* text, size_t len, jsonBuffer_t* out ) {
+    char const* const end = text + len;
+    char const* const anchor = ndjson->patterns[0];
+    size_t const anchorLen = strlen( anchor );
+    while( text < end ) {
+        char const* const hit = findPattern( text, (size_t)( end - text ), anchor, anchorLen );
+        if ( !hit ) break;
+        char const* line = hit;
+        while( line > text && line[-1] != '\n' ) --line;
+        char const* eol = (char const*)memchr( hit, '\n', (size_t)( end - hit ) );
+        if ( !eol ) eol = end;
+        size_t const linelen = (size_t)( eol - line );
+        unsigned int i;
+        for( i = 1; i < ndjson->patternQty; ++i ) {
+            char const* const pattern = ndjson->patterns[i];
+            if ( !findPattern( line, linelen, pattern, strlen( pattern ) ) ) break;
+        }
+        if ( i == ndjson->patternQty ) {
+            json_t const* json;
+            if ( parseLine( worker, line, linelen, &json ) ) return -1;
+            if ( ndjson->process( worker->ctx, json, line, linelen, out ) ) return -1;
+        }
+        text = eol + 1;
+    }
+    return 0;
+}
+
+/** Process the lines of a batch.
+  * @param ndjson The configuration.
+  * @param worker The resources of the thread.
+  * @param text The first line of the batch.
+  * @param len Length of the batch.
+  * @param out Buffer for the output of the batch.
+  * @retval 0 if success.
+  * @retval -1 if a callback stopped or there was not enough memory. */
+static int processBatch( jsonNdjson_t const* ndjson, worker_t* worker,
+                         char const* text, size_t len, jsonBuffer_t* out ) {
+    if ( ndjson->patternQty ) return processCandidates( ndjson, worker, text, len, out );
+    char const* const end = text + len;
+    while( text < end ) {
+        char const* eol = (char const*)memchr( text, '\n', (size_t)( end - text ) );
+        if ( !eol ) eol = end;
+        size_t const linelen = (size_t)( eol - text );
+        if ( !isBlankLine( text, linelen ) ) {
+            json_t const* json;
+            if ( parseLine( worker, text, linelen, &json ) ) return -1;
+            if ( ndjson->process( worker->ctx, json, text, linelen, out ) ) return -1;
+        }
+        text = eol + 1;
+    }
+    return 0;
+}
+
+/** Find the end of the batch that starts at an offset.
+  * @return Offset after the end of line that closes the batch. */
+static size_t batchEnd( job_t const* job, size_t offset ) {
+    if ( job->len - offset <= job->batchSize ) return job->len;
+    size_t const from = offset + job->batchSize;
+    char const* const eol = (char const*)memchr( job->text + from, '\n', job->len - from );
+    return eol ? (size_t)( eol - job->text ) + 1 : job->len;
+}
+
+/** Worker thread. It takes batches while the window of outputs has room.
+  * @param arg The handler of the job.
+  * @return Null pointer. */
+static void* workerThread( void* arg ) {
+    job_t* const job = (job_t*)arg;
+    worker_t worker;
+    int const failed = workerInit( &worker, job->ndjson );
+    pthread_mutex_lock( &job->mutex );
+    if ( failed ) job->stop = true;
+    for(;;) {
+        while( !job->stop && job->offset < job->len && job->taken >= job->emitted + job->window )
+            pthread_cond_wait( &job->cond, &job->mutex );
+        if ( job->stop || job->offset >= job->len ) break;
+        size_t const begin = job->offset;
+        size_t const end = batchEnd( job, begin );
+        batch_t* const batch = job->batches + job->taken % job->window;
+        batch->index = job->taken++;
+        batch->done = false;
+        batch->out.len = 0;
+        job->offset = end;
+        pthread_mutex_unlock( &job->mutex );
+        int const error = processBatch( job->ndjson, &worker, job->text + begin, end - begin, &batch->out );
+        pthread_mutex_lock( &job->mutex );
+        if ( error ) job->stop = true;
+        batch->done = true;
+        pthread_cond_broadcast( &job->cond );
+    }
+    pthread_cond_broadcast( &job->cond );
+    pthread_mutex_unlock( &job->mutex );
+    workerFree( &worker, job->ndjson );
+    return 0;
+}
+
+/** Write the outputs of the batches in order until all the text is processed.
+  * @param job The handler of the job with its threads running.
+  * @retval 0 if success.
+  * @retval -1 if the processing was stopped. */
+static int emitBatches( job_t* job ) {
+    jsonNdjson_t const* const ndjson = job->ndjson;
+    pthread_mutex_lock( &job->mutex );
+    for(;;) {
+        batch_t* const batch = job->batches + job->emitted % job->window;
+        while( !job->stop && ( job->emitted >= job->taken || !batch->done )
+               && !( job->offset >= job->len && job->emitted == job->taken ) )
+            pthread_cond_wait( &job->cond, &job->mutex );
+        if ( job->stop ) break;
+        if ( job->emitted == job->taken ) break;
+        pthread_mutex_unlock( &job->mutex );
+        int const error = ndjson->emit && batch->out.len && ndjson->emit( ndjson->ctx, batch->out.data, batch->out.len );
+        pthread_mutex_lock( &job->mutex );
+        if ( error ) job->stop = true;
+        else ++job->emitted;
+        pthread_cond_broadcast( &job->cond );
+    }
+    int const result = job->stop ? -1 : 0;
+    job->stop = true;
+    pthread_cond_broadcast( &job->cond );
+    pthread_mutex_unlock( &job->mutex );
+    return result;
+}
+
+/** Process all the lines in the calling thread. */
+static int runSerial( jsonNdjson_t const* ndjson, char const* text, size_t len, size_t batchSize ) {
+    job_t job;
+    job.text = text;
+    job.len = len;
+    job.batchSize = batchSize;
+    worker_t worker;
+    if ( workerInit( &worker, ndjson ) ) return -1;
+    jsonBuffer_t out = { 0, 0, 0 };
+    int result = 0;
+    size_t offset;
+    for( offset = 0; !result && offset < len; ) {
+        size_t const end = batchEnd( &job, offset );
+        out.len = 0;
+        result = processBatch( ndjson, &worker, text + offset, end - offset, &out );
+        if ( !result && ndjson->emit && out.len && ndjson->emit( ndjson->ctx, out.data, out.len ) ) result = -1;
+        offset = end;
+    }
+    free( out.data );
+    workerFree( &worker, ndjson );
+    return result;
+}
+
+/* Process all the lines of an NDJSON text. */
+int json_ndjsonRun( jsonNdjson_t const* ndjson, char const* text, size_t len ) {
+    size_t const batchSize = ndjson->batchSize ? ndjson->batchSize : BATCH_SIZE;
+    if ( ndjson->threads <= 1 ) return runSerial( ndjson, text, len, batchSize );
+    job_t job;
+    job.ndjson = ndjson;
+    job.text = text;
+    job.len = len;
+    job.batchSize = batchSize;
+    job.offset = 0;
+    job.taken = 0;
+    job.emitted = 0;
+    job.window = WINDOW * ndjson->threads;
+    job.stop = false;
+    job.batches = (batch_t*)calloc( job.window, sizeof( batch_t ) );
+    pthread_t* const threads = (pthread_t*)malloc( ndjson->threads * sizeof( pthread_t ) );
+    int result = -1;
+    if ( job.batches && threads ) {
+        pthread_mutex_init( &job.mutex, 0 );
+        pthread_cond_init( &job.cond, 0 );
+        unsigned int started;
+        for( started = 0; started < ndjson->threads; ++started )
+            if ( pthread_create( threads + started, 0, workerThread, &job ) ) break;
+        if ( started == ndjson->threads ) result = emitBatches( &job );
+        else {
+            pthread_mutex_lock( &job.mutex );
+            job.stop = true;
+            pthread_cond_broadcast( &job.cond );
+            pthread_mutex_unlock( &job.mutex );
+        }
+        unsigned int i;
+        for( i = 0; i < started; ++i )
+            pthread_join( threads[i], 0 );
+        pthread_cond_destroy( &job.cond );
+        pthread_mutex_destroy( &job.mutex );
+    }
+    if ( job.batches ) {
+        unsigned int i;
+        for( i = 0; i < job.window; ++i )
+            free( job.batches[i].out.data );
+    }
+    free( threads );
+    free( job.batches );
+    return result;
+}
@@ -0,0 +1,132 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_NDJSON_H_
+#define	_TINY_JSON_NDJSON_H_
+
+#ifdef TINY_JSON_USE_WCHAR
+#error "tiny-json-ndjson.h works with char strings only, it cannot be used when TINY_JSON_USE_WCHAR is defined."
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "tiny-json.h"
+
+/** @defgroup tinyJsonNdjson Parallel processing of NDJSON texts.
+  * A text with a JSON document per line, f.i. a mapped log file, is split
+  * into batches of lines that are parsed and processed by a set of threads.
+  * Each thread copies a line into its own buffer, so the text is never
+  * modified, and grows its own pool when a line needs more properties. The
+  * output of the batches is handed to the calling thread in the order of the
+  * lines. A prefilter of raw strings, f.i. the key and the value of an
+  * equality, skips most lines of a selective filter before parsing them.
+  * POSIX threads only.
+  * @{ */
+
+/** Growable buffer of characters. */
+typedef struct jsonBuffer_s {
+    char* data;            /**< The characters, allocated with malloc().   */
+    size_t len;            /**< Number of characters stored.               */
+    size_t cap;            /**< Number of characters allocated.            */
+} jsonBuffer_t;
+
+/** Append characters to a buffer.
+  * @param buffer The handler of the buffer.
+  * @param data The characters to append.
+  * @param len Number of characters.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+int json_bufferAppend( jsonBuffer_t* buffer, char const* data, size_t len );
+
+/** Append a string to a buffer as a JSON string: between quotes and with
+  * the quotes, the backslashes and the control characters escaped.
+  * @param buffer The handler of the buffer.
+  * @param str The characters of the string.
+  * @param len Number of characters.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+int json_bufferAppendString( jsonBuffer_t* buffer, char const* str, size_t len );
+
+/** Configuration of the processing of an NDJSON text. */
+typedef struct jsonNdjson_s {
+    unsigned int threads;  /**< Number of threads. Zero or one processes in the calling thread. */
+    size_t batchSize;      /**< Approximate size of a batch of lines. Zero for 1 MB. */
+    void* ctx;             /**< Context passed to the callbacks.           */
+    /** Process one line. It is called from the threads. Blank lines are skipped.
+      * @param ctx The context.
+      * @param json The root of the document or null pointer if it is not valid.
+      * @param line The original text of the line, without the end of line.
+      * @param len Length of the line.
+      * @param out Buffer for the output of the line.
+      * @return Zero to go on or other value to stop the processing. */
+    int (*process)( void* ctx, json_t const* json, char const* line, size_t len, jsonBuffer_t* out );
+    /** Write the output of a batch. It is called in the calling thread in the
+      * order of the lines. It may be null if the output is not needed.
+      * @param ctx The context.
+      * @param data The output of the lines of the batch.
+      * @param len Length of the output.
+      * @return Zero to go on or other value to stop the processing. */
+    int (*emit)( void* ctx, char const* data, size_t len );
+    /** Optional prefilter. Only the lines that contain all these strings are
+      * parsed and processed, the rest are skipped without being checked. The
+      * first pattern is searched in the whole batch, so it should be the
+      * rarest one. Patterns may not contain ends of line. */
+    char const* const* patterns;
+    unsigned int patternQty; /**< Number of patterns. Zero for no prefilter. */
+    /** Optional. Create the context of a thread, f.i. to accumulate results
+      * without locks. It is called in each thread before its first line and
+      * the context returned is passed to process instead of ctx.
+      * @param ctx The context.
+      * @return The context of the thread or null pointer to stop. */
+    void* (*threadStart)( void* ctx );
+    /** Optional. Called in each thread after its last line.
+      * @param ctx The context.
+      * @param local The context returned by threadStart. */
+    void (*threadEnd)( void* ctx, void* local );
+} jsonNdjson_t;
+
+/** Process all the lines of an NDJSON text.
+  * @param ndjson The configuration.
+  * @param text The text. It is not modified.
+  * @param len Length of the text.
+  * @retval 0 when all the lines have been processed.
+  * @retval -1 if a callback stopped the processing or there was not enough
+  *         memory or threads. */
+int json_ndjsonRun( jsonNdjson_t const* ndjson, char const* text, size_t len );
+
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_NDJSON_H_ */
@@ -0,0 +1,271 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tiny-json-numeric.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define TINY_JSON_SSE2
+#endif
+
+/** Number of elements converted at a time by the aggregates of arrays. */
+#define BLOCK 256
+
+/** Powers of ten that are exact doubles. */
+static double const powers[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/** Convert the text of a number validated by the parser. When the digits fit
+  * in the 53 bits of a double and the power of ten is exact, a product or a
+  * quotient of two exact doubles is correctly rounded. Otherwise strtod()
+  * is used. */
+static double toDouble( char const* str ) {
+    char const* ptr = str;
+    bool const negative = *ptr == '-';
+    if ( negative ) ++ptr;
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    for( ; *ptr >= '0' && *ptr <= '9' && digits < 19; ++ptr, ++digits )
+        mantissa = 10 * mantissa + (uint64_t)( *ptr - '0' );
+    if ( *ptr == '.' )
+        for( ++ptr; *ptr >= '0' && *ptr <= '9' && digits < 19; ++ptr, ++digits, --exponent )
+            mantissa = 10 * mantissa + (uint64_t)( *ptr - '0' );
+    if ( *ptr == 'e' || *ptr == 'E' ) {
+        bool const negExp = *++ptr == '-';
+        if ( *ptr == '-' || *ptr == '+' ) ++ptr;
+        int value = 0;
+        for( ; *ptr >= '0' && *ptr <= '9' && value < 1000; ++ptr )
+            value = 10 * value + ( *ptr - '0' );
+        exponent += negExp ? -value : value;
+    }
+    if ( *ptr || mantissa > ( (uint64_t)1 << 53 ) || exponent < -22 || exponent > 22 )
+        return strtod( str, 0 );
+    double const value = exponent < 0 ? (double)mantissa / powers[ -exponent ] : (double)mantissa * powers[ exponent ];
+    return negative ? -value : value;
+}
+
+/** Convert the numbers of the next elements of an array.
+  * @param cursor The next element. It is moved past the elements converted.
+  * @param policy What to do with the elements that are not numbers.
+  * @param values Array of BLOCK doubles to store the numbers.
+  * @param skipped Counter of elements that are not numbers.
+  * @return The number of numbers converted or -1 if an element is not a
+  *         number and the policy is JSON_FAIL. */
+static int convertBlock( json_t const** cursor, jsonNonNumeric_t policy, double* values, size_t* skipped ) {
+    int qty = 0;
+    json_t const* json = *cursor;
+    for( ; json && qty < BLOCK; json = json_getSibling( json ) ) {
+        jsonType_t const type = json_getType( json );
+        if ( type == JSON_INTEGER || type == JSON_REAL ) values[ qty++ ] = toDouble( json_getValue( json ) );
+        else if ( policy == JSON_FAIL ) return -1;
+        else ++*skipped;
+    }
+    *cursor = json;
+    return qty;
+}
+
+/* Convert the numbers of an array. */
+int json_numbersLoad( jsonNumbers_t* numbers, json_t const* array, jsonNonNumeric_t policy ) {
+    numbers->qty = 0;
+    numbers->skipped = 0;
+    if ( json_getType( array ) != JSON_ARRAY ) return -1;
+    json_t const* cursor = json_getChild( array );
+    while( cursor ) {
+        if ( numbers->cap - numbers->qty < BLOCK ) {
+            size_t const cap = numbers->cap ? 2 * numbers->cap : 4 * BLOCK;
+            double* const values = (double*)realloc( numbers->values, cap * sizeof( double ) );
+            if ( !values ) return -1;
+            numbers->values = values;
+            numbers->cap = cap;
+        }
+        int const qty = convertBlock( &cursor, policy, numbers->values + numbers->qty, &numbers->skipped );
+        if ( qty < 0 ) return -1;
+        numbers->qty += (size_t)qty;
+    }
+    return 0;
+}
+
+/* Free the memory of converted numbers. */
+void json_numbersFree( jsonNumbers_t* numbers ) {
+    free( numbers->values );
+    memset( numbers, 0, sizeof( jsonNumbers_t ) );
+}
+
+/* Get the sum of some doubles. */
+double json_numbersSum( double const* values, size_t qty ) {
+    double sum = 0;
+    size_t i = 0;
+#ifdef TINY_JSON_SSE2
+    __m128d a = _mm_setzero_pd();
+    __m128d b = _mm_setzero_pd();
+    __m128d c = _mm_setzero_pd();
+    __m128d d = _mm_setzero_pd();
+    for( ; i + 8 <= qty; i += 8 ) {
+        a = _mm_add_pd( a, _mm_loadu_pd( values + i ) );
+        b = _mm_add_pd( b, _mm_loadu_pd( values + i + 2 ) );
+        c = _mm_add_pd( c, _mm_loadu_pd( values + i + 4 ) );
+        d = _mm_add_pd( d, _mm_loadu_pd( values + i + 6 ) );
+    }
+    double lanes[2];
+    _mm_storeu_pd( lanes, _mm_add_pd( _mm_add_pd( a, b ), _mm_add_pd( c, d ) ) );
+    sum = lanes[0] + lanes[1];
+#endif
+    for( ; i < qty; ++i )
+        sum += values[i];
+    return sum;
+}
+
+/* Get the minimum and the maximum of some doubles. */
+void json_numbersMinMax( double const* values, size_t qty, double* min, double* max ) {
+    double low = HUGE_VAL;
+    double high = -HUGE_VAL;
+    size_t i = 0;
+#ifdef TINY_JSON_SSE2
+    __m128d lowA = _mm_set1_pd( low );
+    __m128d lowB = lowA;
+    __m128d highA = _mm_set1_pd( high );
+    __m128d highB = highA;
+    for( ; i + 4 <= qty; i += 4 ) {
+        __m128d const x = _mm_loadu_pd( values + i );
+        __m128d const y = _mm_loadu_pd( values + i + 2 );
+        lowA = _mm_min_pd( lowA, x );
+        lowB = _mm_min_pd( lowB, y );
+        highA = _mm_max_pd( highA, x );
+        highB = _mm_max_pd( highB, y );
+    }
+    double lanes[2];
+    _mm_storeu_pd( lanes, _mm_min_pd( lowA, lowB ) );
+    low = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+    _mm_storeu_pd( lanes, _mm_max_pd( highA, highB ) );
+    high = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+#endif
+    for( ; i < qty; ++i ) {
+        if ( values[i] < low ) low = values[i];
+        if ( values[i] > high ) high = values[i];
+    }
+    *min = low;
+    *max = high;
+}
+
+/* Count some doubles in the bins of a histogram. */
+size_t json_numbersHistogram( double const* values, size_t qty, double lower, double upper, unsigned int bins, size_t counts[] ) {
+    if ( !bins || !( lower < upper ) || !isfinite( upper - lower ) ) return qty;
+    double const scale = bins / ( upper - lower );
+    size_t outside = 0;
+    size_t i;
+    for( i = 0; i < qty; ++i ) {
+        double const value = values[i];
+        if ( !( value >= lower && value <= upper ) ) {
+            ++outside;
+            continue;
+        }
+        size_t bin = (size_t)( ( value - lower ) * scale );
+        if ( bin >= bins ) bin = bins - 1;
+        ++counts[ bin ];
+    }
+    return outside;
+}
+
+/* Get the sum of the numbers of an array. */
+int json_arraySum( json_t const* array, jsonNonNumeric_t policy, double* sum, size_t* qty ) {
+    if ( json_getType( array ) != JSON_ARRAY ) return -1;
+    double values[ BLOCK ];
+    double total = 0;
+    size_t count = 0;
+    size_t skipped = 0;
+    json_t const* cursor = json_getChild( array );
+    while( cursor ) {
+        int const len = convertBlock( &cursor, policy, values, &skipped );
+        if ( len < 0 ) return -1;
+        total += json_numbersSum( values, (size_t)len );
+        count += (size_t)len;
+    }
+    *sum = total;
+    if ( qty ) *qty = count;
+    return 0;
+}
+
+/* Get the minimum and the maximum of the numbers of an array. */
+int json_arrayMinMax( json_t const* array, jsonNonNumeric_t policy, double* min, double* max ) {
+    if ( json_getType( array ) != JSON_ARRAY ) return -1;
+    double values[ BLOCK ];
+    double low = HUGE_VAL;
+    double high = -HUGE_VAL;
+    size_t count = 0;
+    size_t skipped = 0;
+    json_t const* cursor = json_getChild( array );
+    while( cursor ) {
+        int const len = convertBlock( &cursor, policy, values, &skipped );
+        if ( len < 0 ) return -1;
+        double blockMin, blockMax;
+        json_numbersMinMax( values, (size_t)len, &blockMin, &blockMax );
+        if ( blockMin < low ) low = blockMin;
+        if ( blockMax > high ) high = blockMax;
+        count += (size_t)len;
+    }
+    if ( !count ) return -1;
+    *min = low;
+    *max = high;
+    return 0;
+}
+
+/* Get the mean of the numbers of an array. */
+int json_arrayMean( json_t const* array, jsonNonNumeric_t policy, double* mean ) {
+    double sum;
+    size_t qty;
+    if ( json_arraySum( array, policy, &sum, &qty ) || !qty ) return -1;
+    *mean = sum / (double)qty;
+    return 0;
+}
+
+/* Count the numbers of an array in the bins of a histogram. */
+int json_arrayHistogram( json_t const* array, jsonNonNumeric_t policy, double lower, double upper,
+                         unsigned int bins, size_t counts[], size_t* outside ) {
+    if ( json_getType( array ) != JSON_ARRAY || !bins || !( lower < upper ) || !isfinite( upper - lower ) ) return -1;
+    memset( counts, 0, bins * sizeof( size_t ) );
+    double values[ BLOCK ];
+    size_t out = 0;
+    size_t skipped = 0;
+    json_t const* cursor = json_getChild( array );
+    while( cursor ) {
+        int const len = convertBlock( &cursor, policy, values, &skipped );
+        if ( len < 0 ) return -1;
+        out += json_numbersHistogram( values, (size_t)len, lower, upper, bins, counts );
+    }
+    if ( outside ) *outside = out;
+    return 0;
+}
@@ -0,0 +1,139 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_NUMERIC_H_
+#define	_TINY_JSON_NUMERIC_H_
+
+#ifdef TINY_JSON_USE_WCHAR
+#error "tiny-json-numeric.h works with char strings only, it cannot be used when TINY_JSON_USE_WCHAR is defined."
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "tiny-json.h"
+
+/** @defgroup tinyJsonNumeric Aggregates of numeric arrays.
+  * The numbers of an array are converted a block at a time into doubles with
+  * a conversion that only falls back to strtod() for the numbers that need
+  * it, and each block is reduced with SIMD instructions when SSE2 is
+  * available. To compute several aggregates of the same array, its numbers
+  * can be converted once into a jsonNumbers_t.
+  * @{ */
+
+/** What to do with the elements that are not numbers. */
+typedef enum {
+    JSON_SKIP,             /**< Ignore them, f.i. the nulls of missing points. */
+    JSON_FAIL              /**< The function fails.                        */
+} jsonNonNumeric_t;
+
+/** Numbers of an array converted to doubles. */
+typedef struct jsonNumbers_s {
+    double* values;        /**< The numbers, allocated with malloc().      */
+    size_t qty;            /**< Number of numbers.                         */
+    size_t cap;            /**< Length of the allocated array.             */
+    size_t skipped;        /**< Number of elements that are not numbers.   */
+} jsonNumbers_t;
+
+/** Convert the numbers of an array. The numbers of a previous array are
+  * replaced and the memory is reused.
+  * @param numbers The handler of the numbers. Initialize it with zeros.
+  * @param array A json array.
+  * @param policy What to do with the elements that are not numbers.
+  * @retval 0 if success.
+  * @retval -1 if it is not an array, an element is not a number and the
+  *         policy is JSON_FAIL or there was not enough memory. */
+int json_numbersLoad( jsonNumbers_t* numbers, json_t const* array, jsonNonNumeric_t policy );
+
+/** Free the memory of converted numbers.
+  * @param numbers The handler of the numbers. */
+void json_numbersFree( jsonNumbers_t* numbers );
+
+/** Get the sum of some doubles. */
+double json_numbersSum( double const* values, size_t qty );
+
+/** Get the minimum and the maximum of some doubles.
+  * If there are none, the minimum is infinite and the maximum minus infinite. */
+void json_numbersMinMax( double const* values, size_t qty, double* min, double* max );
+
+/** Count some doubles in the bins of a histogram. The range is split in bins
+  * of the same width. A value equal to the upper limit is in the last bin.
+  * @param values The doubles.
+  * @param qty Number of doubles.
+  * @param lower Lower limit of the range.
+  * @param upper Upper limit of the range. It must be greater than lower and
+  *        the width of the range must be finite.
+  * @param bins Number of bins. It must not be zero.
+  * @param counts The counts of the bins. They are added to, not set.
+  * @return The number of values out of the range. If the range or the bins
+  *         are not valid, no value is counted and all are out of range. */
+size_t json_numbersHistogram( double const* values, size_t qty, double lower, double upper, unsigned int bins, size_t counts[] );
+
+/** Get the sum of the numbers of an array.
+  * @param array A json array.
+  * @param policy What to do with the elements that are not numbers.
+  * @param sum Pointer to store the sum.
+  * @param qty Pointer to store the number of numbers or null pointer.
+  * @retval 0 if success.
+  * @retval -1 if it is not an array or an element is not a number and the
+  *         policy is JSON_FAIL. */
+int json_arraySum( json_t const* array, jsonNonNumeric_t policy, double* sum, size_t* qty );
+
+/** Get the minimum and the maximum of the numbers of an array.
+  * @retval 0 if success.
+  * @retval -1 if it is not an array, it has no numbers or an element is not
+  *         a number and the policy is JSON_FAIL. */
+int json_arrayMinMax( json_t const* array, jsonNonNumeric_t policy, double* min, double* max );
+
+/** Get the mean of the numbers of an array.
+  * @retval 0 if success.
+  * @retval -1 if it is not an array, it has no numbers or an element is not
+  *         a number and the policy is JSON_FAIL. */
+int json_arrayMean( json_t const* array, jsonNonNumeric_t policy, double* mean );
+
+/** Count the numbers of an array in the bins of a histogram. The range is
+  * the same as in json_numbersHistogram().
+  * @param counts The counts of the bins. They are set.
+  * @param outside Pointer to store the number of numbers out of the range
+  *        or null pointer.
+  * @retval 0 if success.
+  * @retval -1 if it is not an array, the range or the bins are not valid or
+  *         an element is not a number and the policy is JSON_FAIL. */
+int json_arrayHistogram( json_t const* array, jsonNonNumeric_t policy, double lower, double upper,
+                         unsigned int bins, size_t counts[], size_t* outside );
+
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_NUMERIC_H_ */
@@ -0,0 +1,282 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include "tiny-json-pipeline.h"
+
+/** Size of a cache line. It keeps the indexes of a ring apart. */
+#define CACHE_LINE 64
+
+/** Times a stage yields before it sleeps waiting on a ring. */
+#define SPINS 64
+
+/** Lock-free single-producer/single-consumer ring of pointers. */
+typedef struct ring_s {
+    unsigned int head;     /**< Index of the next item to pop.             */
+    char pad0[ CACHE_LINE - sizeof( unsigned int ) ];
+    unsigned int tail;     /**< Index of the next item to push.            */
+    char pad1[ CACHE_LINE - sizeof( unsigned int ) ];
+    unsigned int mask;     /**< Capacity of the ring minus one.            */
+    void** items;          /**< Array of items of the ring.                */
+    unsigned int waits;    /**< A stage sleeps waiting on the ring.        */
+    pthread_mutex_t mutex; /**< Protects the sleep of a stage.             */
+    pthread_cond_t cond;   /**< Signaled when an index changes.            */
+} ring_t;
+
+/** A document travelling along the pipeline. */
+typedef struct slot_s {
+    char* str;             /**< Buffer for the text of the document.       */
+    json_t* mem;           /**< Array of json properties of the document.  */
+    json_t const* json;    /**< The root of the document once parsed.      */
+} slot_t;
+
+/** A parser thread with the rings that connect it to the other stages. */
+typedef struct lane_s {
+    ring_t free;           /**< Recycled slots, from consumer to reader.   */
+    ring_t work;           /**< Read slots, from reader to parser.         */
+    ring_t done;           /**< Parsed slots, from parser to consumer.     */
+    pthread_t thread;      /**< The parser thread.                         */
+    jsonPipeline_t const* pipeline;
+} lane_t;
+
+/** State shared by the stages of a running pipeline. */
+typedef struct pipe_s {
+    jsonPipeline_t const* pipeline;
+    lane_t* lanes;
+} pipe_t;
+
+/** Wait until an index of a ring is not equal to a value. It yields a few
+  * times and then sleeps until the other side of the ring wakes it. The
+  * index is stored before the waits flag is loaded and the flag is stored
+  * before the index is loaded, all sequentially consistent, so either the
+  * waker sees the flag or the sleeper sees the new index.
+  * @param ring The handler of the ring.
+  * @param index The index that the other side of the ring moves.
+  * @param value The value seen by the caller. */
+static void ringWait( ring_t* ring, unsigned int const* index, unsigned int value ) {
+    unsigned int i;
+    for( i = 0; i < SPINS; ++i ) {
+        if ( __atomic_load_n( index, __ATOMIC_ACQUIRE ) != value ) return;
+        sched_yield();
+    }
+    pthread_mutex_lock( &ring->mutex );
+    __atomic_store_n( &ring->waits, 1, __ATOMIC_SEQ_CST );
+    while( __atomic_load_n( index, __ATOMIC_SEQ_CST ) == value )
+        pthread_cond_wait( &ring->cond, &ring->mutex );
+    __atomic_store_n( &ring->waits, 0, __ATOMIC_RELAXED );
+    pthread_mutex_unlock( &ring->mutex );
+}
+
+/** Wake the stage that sleeps waiting on a ring, if any.
+  * @param ring The handler of the ring. */
+static void ringWake( ring_t* ring ) {
+    if ( !__atomic_load_n( &ring->waits, __ATOMIC_SEQ_CST ) ) return;
+    pthread_mutex_lock( &ring->mutex );
+    pthread_cond_signal( &ring->cond );
+    pthread_mutex_unlock( &ring->mutex );
+}
+
+/** Push an item into a ring. It waits while the ring is full.
+  * Only one thread can push into a ring.
+  * @param ring The handler of the ring.
+  * @param item The item to push. */
+static void ringPush( ring_t* ring, void* item ) {
+    unsigned int const tail = __atomic_load_n( &ring->tail, __ATOMIC_RELAXED );
+    unsigned int head;
+    while( tail - ( head = __atomic_load_n( &ring->head, __ATOMIC_ACQUIRE ) ) > ring->mask )
+        ringWait( ring, &ring->head, head );
+    ring->items[ tail & ring->mask ] = item;
+    __atomic_store_n( &ring->tail, tail + 1, __ATOMIC_SEQ_CST );
+    ringWake( ring );
+}
+
+/** Pop an item from a ring. It waits while the ring is empty.
+  * Only one thread can pop from a ring.
+  * @param ring The handler of the ring.
+  * @return The item. */
+static void* ringPop( ring_t* ring ) {
+    unsigned int const head = __atomic_load_n( &ring->head, __ATOMIC_RELAXED );
+    while( head == __atomic_load_n( &ring->tail, __ATOMIC_ACQUIRE ) )
+        ringWait( ring, &ring->tail, head );
+    void* const item = ring->items[ head & ring->mask ];
+    __atomic_store_n( &ring->head, head + 1, __ATOMIC_SEQ_CST );
+    ringWake( ring );
+    return item;
+}
+
+/** Initialize an empty ring.
+  * @param ring The handler of the ring.
+  * @param items Array of items. Its length must be a power of two.
+  * @param qty Length of the array of items. */
+static void ringInit( ring_t* ring, void** items, unsigned int qty ) {
+    ring->head = 0;
+    ring->tail = 0;
+    ring->mask = qty - 1;
+    ring->items = items;
+    ring->waits = 0;
+    pthread_mutex_init( &ring->mutex, 0 );
+    pthread_cond_init( &ring->cond, 0 );
+}
+
+/** Release the resources of a ring.
+  * @param ring The handler of the ring. */
+static void ringFree( ring_t* ring ) {
+    pthread_cond_destroy( &ring->cond );
+    pthread_mutex_destroy( &ring->mutex );
+}
+
+/** Parser stage. It parses the documents of its lane until it gets a null slot.
+  * @param arg The handler of the lane.
+  * @return Null pointer. */
+static void* parserThread( void* arg ) {
+    lane_t* const lane = (lane_t*)arg;
+    for(;;) {
+        slot_t* const slot = (slot_t*)ringPop( &lane->work );
+        if ( slot )
+            slot->json = json_create( slot->str, slot->mem, lane->pipeline->poolSize );
+        ringPush( &lane->done, slot );
+        if ( !slot ) return 0;
+    }
+}
+
+/** Consumer stage. It visits the lanes in the same order as the reader did.
+  * @param arg The handler of the pipe.
+  * @return Null pointer. */
+static void* consumerThread( void* arg ) {
+    pipe_t* const pipe = (pipe_t*)arg;
+    jsonPipeline_t const* const pipeline = pipe->pipeline;
+    unsigned int i = 0;
+    for(;;) {
+        lane_t* const lane = pipe->lanes + i;
+        slot_t* const slot = (slot_t*)ringPop( &lane->done );
+        if ( !slot ) return 0;
+        pipeline->consume( pipeline->ctx, slot->json );
+        ringPush( &lane->free, slot );
+        if ( ++i == pipeline->parsers ) i = 0;
+    }
+}
+
+/** Stop and join the parser threads of some lanes.
+  * @param lanes Array of lanes.
+  * @param qty Number of lanes whose thread is running. */
+static void stopParsers( lane_t* lanes, unsigned int qty ) {
+    unsigned int i;
+    for( i = 0; i < qty; ++i )
+        ringPush( &lanes[i].work, 0 );
+    for( i = 0; i < qty; ++i )
+        pthread_join( lanes[i].thread, 0 );
+}
+
+/** Start the threads, read the stream and wait for the end of the other stages.
+  * @param pipe The pipe with its lanes ready.
+  * @retval 0 when the whole stream has been consumed.
+  * @retval -1 if the threads could not be created. */
+static int runStages( pipe_t* pipe ) {
+    jsonPipeline_t const* const pipeline = pipe->pipeline;
+    lane_t* const lanes = pipe->lanes;
+    unsigned int i;
+    for( i = 0; i < pipeline->parsers; ++i ) {
+        if ( pthread_create( &lanes[i].thread, 0, parserThread, lanes + i ) ) {
+            stopParsers( lanes, i );
+            return -1;
+        }
+    }
+    pthread_t consumer;
+    if ( pthread_create( &consumer, 0, consumerThread, pipe ) ) {
+        stopParsers( lanes, pipeline->parsers );
+        return -1;
+    }
+    for( i = 0;; ) {
+        lane_t* const lane = lanes + i;
+        slot_t* const slot = (slot_t*)ringPop( &lane->free );
+        size_t const cap = pipeline->bufferSize - 1;
+        size_t const len = pipeline->read( pipeline->ctx, slot->str, cap );
+        if ( !len ) break;
+        /* A truncated document is not parsed, the parser gets an empty text. */
+        slot->str[ len <= cap ? len : 0 ] = '\0';
+        ringPush( &lane->work, slot );
+        if ( ++i == pipeline->parsers ) i = 0;
+    }
+    stopParsers( lanes, pipeline->parsers );
+    pthread_join( consumer, 0 );
+    return 0;
+}
+
+/* Run a pipeline until the end of the stream. */
+int json_pipelineRun( jsonPipeline_t const* pipeline ) {
+    jsonPipeline_t config = *pipeline;
+    if ( !config.parsers ) config.parsers = 1;
+    if ( !config.depth ) config.depth = 1;
+    if ( !config.bufferSize || !config.poolSize ) return -1;
+    unsigned int const slots = config.parsers * config.depth;
+    unsigned int ringqty = 2;
+    while( ringqty < config.depth + 1 ) ringqty *= 2;
+
+    lane_t* const lanes = (lane_t*)malloc( config.parsers * sizeof *lanes );
+    void** const items = (void**)malloc( 3 * config.parsers * ringqty * sizeof *items );
+    slot_t* const slot = (slot_t*)malloc( slots * sizeof *slot );
+    char* const buffers = (char*)malloc( slots * config.bufferSize );
+    json_t* const mem = (json_t*)malloc( slots * config.poolSize * sizeof *mem );
+    int result = -1;
+    if ( lanes && items && slot && buffers && mem ) {
+        unsigned int i;
+        for( i = 0; i < slots; ++i ) {
+            slot[i].str = buffers + i * config.bufferSize;
+            slot[i].mem = mem + i * config.poolSize;
+        }
+        for( i = 0; i < config.parsers; ++i ) {
+            lane_t* const lane = lanes + i;
+            void** const laneitems = items + 3 * i * ringqty;
+            ringInit( &lane->free, laneitems, ringqty );
+            ringInit( &lane->work, laneitems + ringqty, ringqty );
+            ringInit( &lane->done, laneitems + 2 * ringqty, ringqty );
+            lane->pipeline = &config;
+            unsigned int j;
+            for( j = 0; j < config.depth; ++j )
+                ringPush( &lane->free, slot + i * config.depth + j );
+        }
+        pipe_t pipe = { &config, lanes };
+        result = runStages( &pipe );
+        for( i = 0; i < config.parsers; ++i ) {
+            ringFree( &lanes[i].free );
+            ringFree( &lanes[i].work );
+            ringFree( &lanes[i].done );
+        }
+    }
+    free( mem );
+    free( buffers );
+    free( slot );
+    free( items );
+    free( lanes );
+    return result;
+}
@@ -0,0 +1,90 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_PIPELINE_H_
+#define	_TINY_JSON_PIPELINE_H_
+
+#ifdef TINY_JSON_USE_WCHAR
+#error "tiny-json-pipeline.h works with char strings only, it cannot be used when TINY_JSON_USE_WCHAR is defined."
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "tiny-json.h"
+
+/** @defgroup tinyJsonPipeline Pipeline of reader, parsers and consumer.
+  * The documents of a stream are read by the calling thread, parsed by a set
+  * of parser threads and handed to a consumer thread in the order they were
+  * read. The stages are connected by lock-free single-producer/single-consumer
+  * rings and the buffers and pools are recycled, so the memory is bounded by
+  * the number of parsers and the depth of the pipeline. A stage that has to
+  * wait yields a few times and then sleeps until it is woken, so the idle
+  * stages do not take the CPU. POSIX threads only.
+  * @{ */
+
+/** Configuration of a pipeline. */
+typedef struct jsonPipeline_s {
+    unsigned int parsers;  /**< Number of parser threads.                  */
+    unsigned int depth;    /**< Number of documents in flight per parser.  */
+    size_t bufferSize;     /**< Size of the buffer of each document.       */
+    unsigned int poolSize; /**< Number of json properties per document.    */
+    void* ctx;             /**< Context passed to the callbacks.           */
+    /** Read one document of the stream. It is called in the calling thread.
+      * @param ctx The context of the pipeline.
+      * @param buf Buffer to store the text of the document. It has room for
+      *        cap characters and the null character, which is set by the pipeline.
+      * @param cap Maximum length of the text, bufferSize minus one.
+      * @return The length of the text or zero at the end of the stream. A
+      *         length greater than cap means that the document did not fit:
+      *         it is not parsed and it is consumed as not valid. */
+    size_t (*read)( void* ctx, char* buf, size_t cap );
+    /** Consume one parsed document. It is called in the consumer thread in
+      * the order the documents were read. The tree is recycled on return.
+      * @param ctx The context of the pipeline.
+      * @param json The root of the document or null pointer if it is not valid
+      *        or it did not fit in the buffer. */
+    void (*consume)( void* ctx, json_t const* json );
+} jsonPipeline_t;
+
+/** Run a pipeline until the end of the stream.
+  * @param pipeline The configuration of the pipeline.
+  * @retval 0 when the whole stream has been consumed.
+  * @retval -1 if the memory or the threads could not be created. */
+int json_pipelineRun( jsonPipeline_t const* pipeline );
+
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_PIPELINE_H_ */
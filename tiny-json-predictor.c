@@ -0,0 +1,121 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <stdlib.h>
+#include <limits.h>
+#include "tiny-json-predictor.h"
+
+/** Get the length of the pool that is always enough to parse a text.
+  * Every property but the root takes at least two characters. */
+static unsigned int worstCase( size_t bytes ) {
+    return bytes / 2 + 2 < UINT_MAX ? (unsigned int)( bytes / 2 + 2 ) : UINT_MAX;
+}
+
+/** Store the ratio of properties per byte of a parse in the history. */
+static void learn( jsonPredictor_t* predictor, size_t bytes, unsigned int nodes ) {
+    predictor->ratio[ predictor->next ] = bytes ? (double)nodes / (double)bytes : 0.0;
+    predictor->next = ( predictor->next + 1 ) % JSON_PREDICTOR_HISTORY;
+    if ( predictor->samples < JSON_PREDICTOR_HISTORY ) ++predictor->samples;
+}
+
+/* Initialize a predictor without history. */
+void json_predictorInit( jsonPredictor_t* predictor ) {
+    predictor->samples = 0;
+    predictor->next = 0;
+    predictor->parses = 0;
+    predictor->undersized = 0;
+    predictor->oversized = 0;
+    predictor->used = 0;
+    predictor->capacity = 0;
+}
+
+/* Record a successful parse. */
+void json_predictorRecord( jsonPredictor_t* predictor, size_t bytes, unsigned int nodes, unsigned int qty ) {
+    learn( predictor, bytes, nodes );
+    ++predictor->parses;
+    if ( !qty ) return;
+    if ( nodes < qty / 2 ) ++predictor->oversized;
+    predictor->used += nodes;
+    predictor->capacity += qty;
+}
+
+/* Record a parse that failed because the pool was too small. */
+void json_predictorFailure( jsonPredictor_t* predictor, size_t bytes, unsigned int qty ) {
+    unsigned int const worst = worstCase( bytes );
+    learn( predictor, bytes, qty < worst / 2 ? 2 * qty : worst );
+    ++predictor->parses;
+    ++predictor->undersized;
+    predictor->used += qty;
+    predictor->capacity += qty;
+}
+
+/* Get the recommended length of the pool for a text. */
+unsigned int json_predictorSize( jsonPredictor_t const* predictor, size_t bytes, double confidence ) {
+    unsigned int const worst = worstCase( bytes );
+    unsigned int const samples = predictor->samples;
+    if ( !samples ) return worst;
+    double sorted[ JSON_PREDICTOR_HISTORY ];
+    unsigned int i;
+    for( i = 0; i < samples; ++i ) {
+        double const ratio = predictor->ratio[i];
+        unsigned int j;
+        for( j = i; j && sorted[ j - 1 ] > ratio; --j )
+            sorted[j] = sorted[ j - 1 ];
+        sorted[j] = ratio;
+    }
+    if ( confidence < 0.0 ) confidence = 0.0;
+    unsigned int rank = (unsigned int)( confidence * samples + 0.999999 );
+    if ( rank ) --rank;
+    if ( rank >= samples ) rank = samples - 1;
+    double const qty = sorted[ rank ] * (double)bytes + 2.0;
+    return qty < worst ? (unsigned int)qty : worst;
+}
+
+/* Allocate a pool of the recommended length for a text. */
+json_t* json_predictorAlloc( jsonPredictor_t const* predictor, size_t bytes, double confidence, unsigned int* qty ) {
+    *qty = json_predictorSize( predictor, bytes, confidence );
+    json_t* const mem = malloc( *qty * sizeof( json_t ) );
+    if ( !mem ) *qty = 0;
+    return mem;
+}
+
+/* Get the number of properties of a tree. */
+unsigned int json_predictorCount( json_t const* json ) {
+    jsonType_t const type = json_getType( json );
+    if ( type != JSON_OBJ && type != JSON_ARRAY ) return 1;
+#ifdef TINY_JSON_USE_SPAN
+    return json_getDescendants( json ) + 1;
+#else
+    unsigned int count = 1;
+    json_t const* child;
+    for( child = json_getChild( json ); child; child = json_getSibling( child ) )
+        count += json_predictorCount( child );
+    return count;
+#endif
+}
@@ -0,0 +1,109 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_PREDICTOR_H_
+#define	_TINY_JSON_PREDICTOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "tiny-json.h"
+
+/** @defgroup tinyJsonPredictor Pool size predictor.
+  * A predictor learns how many properties per byte the documents of a class
+  * of traffic have from the last parses and recommends the length of the pool
+  * for the next one. Use a predictor for each class of documents, f.i. for
+  * each endpoint, and do not share it between threads without a lock.
+  * @{ */
+
+/** Number of parses remembered by a predictor. */
+#define JSON_PREDICTOR_HISTORY 64
+
+/** Statistics of the parses of a class of documents. */
+typedef struct jsonPredictor_s {
+    double ratio[ JSON_PREDICTOR_HISTORY ]; /**< Properties per byte of the last parses. */
+    unsigned int samples;       /**< Number of valid ratios.                    */
+    unsigned int next;          /**< Index where the next ratio is stored.      */
+    unsigned long parses;       /**< Number of parses recorded.                 */
+    unsigned long undersized;   /**< Parses that failed for lack of properties. */
+    unsigned long oversized;    /**< Parses that used less than half the pool.  */
+    unsigned long long used;    /**< Sum of the properties used.                */
+    unsigned long long capacity;/**< Sum of the lengths of the pools.           */
+} jsonPredictor_t;
+
+/** Initialize a predictor without history.
+  * @param predictor The handler of the predictor. */
+void json_predictorInit( jsonPredictor_t* predictor );
+
+/** Record a successful parse.
+  * @param predictor The handler of the predictor.
+  * @param bytes Length of the text.
+  * @param nodes Number of properties of the tree. See json_predictorCount().
+  * @param qty Length of the pool that was used. Zero if it is unknown. */
+void json_predictorRecord( jsonPredictor_t* predictor, size_t bytes, unsigned int nodes, unsigned int qty );
+
+/** Record a parse that failed because the pool was too small. As the number
+  * of properties needed is unknown, twice the length of the pool is learnt.
+  * @param predictor The handler of the predictor.
+  * @param bytes Length of the text.
+  * @param qty Length of the pool that was used. */
+void json_predictorFailure( jsonPredictor_t* predictor, size_t bytes, unsigned int qty );
+
+/** Get the recommended length of the pool for a text.
+  * Without history it is the length that is always enough for json_create().
+  * @param predictor The handler of the predictor.
+  * @param bytes Length of the text.
+  * @param confidence Fraction of the last parses, from 0 to 1, that would have
+  *        been successful with the ratio of properties per byte used.
+  * @return The number of properties. */
+unsigned int json_predictorSize( jsonPredictor_t const* predictor, size_t bytes, double confidence );
+
+/** Allocate with malloc() a pool of the recommended length for a text.
+  * @param predictor The handler of the predictor.
+  * @param bytes Length of the text.
+  * @param confidence See json_predictorSize().
+  * @param qty Pointer to store the length of the pool.
+  * @retval The pool, to be released with free().
+  * @retval Null pointer if there was not enough memory. */
+json_t* json_predictorAlloc( jsonPredictor_t const* predictor, size_t bytes, double confidence, unsigned int* qty );
+
+/** Get the number of properties of a tree.
+  * @param json A valid handler of a json property.
+  * @return The number of properties including the given one. */
+unsigned int json_predictorCount( json_t const* json );
+
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_PREDICTOR_H_ */
@@ -0,0 +1,726 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tiny-json-rpc.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#endif
+
+/** Number of properties of the first block of a pool. */
+#define POOL_BLOCK 64
+
+/** Maximum number of properties of a block of a pool. */
+#define POOL_MAX_BLOCK ( 1024 * 1024 )
+
+/** Maximum number of seeds tried for a bucket before the table is enlarged. */
+#define MAX_SEED 65536
+
+/** Maximum length of a request line. Longer ones close the connection. */
+#define MAX_REQUEST ( 64 * 1024 * 1024 )
+
+/** Length of the output pending of a connection that stops its reading. */
+#define MAX_PENDING ( 16 * 1024 * 1024 )
+
+/** Responses of a part of a batch. */
+typedef struct part_s {
+    jsonBuffer_t out;      /**< Responses, each one preceded by a comma.   */
+    jsonBuffer_t message;  /**< Message of the error of a method.          */
+} part_t;
+
+struct jsonRpcWorkers_s {
+    jsonRpc_t* rpc;
+    pthread_t* threads;    /**< The threads besides the calling one.       */
+    unsigned int qty;      /**< Number of threads created.                 */
+    part_t* parts;         /**< A part per thread, the calling one included. */
+    json_t const* const* elements; /**< Elements of the current batch.     */
+    size_t elementQty;     /**< Number of elements of the current batch.   */
+    unsigned int partQty;  /**< Number of parts of the current batch.      */
+    unsigned int next;     /**< Next part to take.                         */
+    unsigned int pending;  /**< Number of parts not finished.              */
+    bool failed;           /**< There was not enough memory in a part.     */
+    bool stop;             /**< The threads must exit.                     */
+    pthread_mutex_t mutex;
+    pthread_cond_t work;   /**< There are parts to take or stop is set.    */
+    pthread_cond_t done;   /**< All the parts are finished.                */
+};
+
+/** FNV-1a hash of a string. */
+static uint64_t hashName( char const* name ) {
+    uint64_t hash = 14695981039346656037u;
+    for( ; *name; ++name ) {
+        hash ^= (unsigned char)*name;
+        hash *= 1099511628211u;
+    }
+    return hash;
+}
+
+/** Mix the hash of a name with the seed of its bucket. */
+static unsigned int slotOf( uint64_t hash, unsigned int seed, unsigned int mask ) {
+    uint64_t x = hash + seed * 0x9e3779b97f4a7c15u;
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9u;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebu;
+    x ^= x >> 31;
+    return (unsigned int)x & mask;
+}
+
+/** Bucket of the first level of a name. */
+static unsigned int bucketOf( uint64_t hash, unsigned int buckets ) {
+    return (unsigned int)( hash >> 32 ) % buckets;
+}
+
+/** Build the perfect hash table with the method of hash and displace. The
+  * buckets are placed from the largest and each one takes the first seed that
+  * sends all its names to free slots.
+  * @retval 0 if success.
+  * @retval 1 if a seed was not found and the table must be larger.
+  * @retval -1 if there was not enough memory. */
+static int buildTable( jsonRpc_t* rpc, uint64_t const* hashes ) {
+    unsigned int const slotQty = rpc->mask + 1;
+    unsigned int* const counts = (unsigned int*)calloc( rpc->buckets, sizeof( unsigned int ) );
+    unsigned int* const order = (unsigned int*)malloc( rpc->buckets * sizeof( unsigned int ) );
+    unsigned int* const members = (unsigned int*)malloc( rpc->qty * sizeof( unsigned int ) );
+    unsigned int* const taken = (unsigned int*)malloc( rpc->qty * sizeof( unsigned int ) );
+    rpc->seeds = (unsigned int*)calloc( rpc->buckets, sizeof( unsigned int ) );
+    rpc->slots = (jsonRpcMethod_t const**)calloc( slotQty, sizeof( jsonRpcMethod_t const* ) );
+    int result = -1;
+    if ( !counts || !order || !members || !taken || !rpc->seeds || !rpc->slots ) goto end;
+    unsigned int i, j;
+    for( i = 0; i < rpc->qty; ++i )
+        ++counts[ bucketOf( hashes[i], rpc->buckets ) ];
+    for( i = 0; i < rpc->buckets; ++i ) {
+        for( j = i; j > 0 && counts[ order[ j - 1 ] ] < counts[i]; --j )
+            order[j] = order[ j - 1 ];
+        order[j] = i;
+    }
+    result = 0;
+    for( i = 0; i < rpc->buckets && counts[ order[i] ]; ++i ) {
+        unsigned int const bucket = order[i];
+        unsigned int qty = 0;
+        for( j = 0; j < rpc->qty; ++j )
+            if ( bucketOf( hashes[j], rpc->buckets ) == bucket ) members[ qty++ ] = j;
+        unsigned int seed;
+        for( seed = 1; seed <= MAX_SEED; ++seed ) {
+            unsigned int k;
+            for( k = 0; k < qty; ++k ) {
+                unsigned int const slot = slotOf( hashes[ members[k] ], seed, rpc->mask );
+                unsigned int m;
+                for( m = 0; m < k && taken[m] != slot; ++m );
+                if ( rpc->slots[ slot ] || m < k ) break;
+                taken[k] = slot;
+            }
+            if ( k == qty ) break;
+        }
+        if ( seed > MAX_SEED ) {
+            result = 1;
+            break;
+        }
+        rpc->seeds[ bucket ] = seed;
+        for( j = 0; j < qty; ++j )
+            rpc->slots[ taken[j] ] = rpc->methods + members[j];
+    }
+end:
+    free( taken );
+    free( members );
+    free( order );
+    free( counts );
+    if ( result ) {
+        free( rpc->seeds );
+        free( (void*)rpc->slots );
+        rpc->seeds = 0;
+        rpc->slots = 0;
+    }
+    return result;
+}
+
+/** Append a null-terminated string to a buffer. */
+static int append( jsonBuffer_t* out, char const* str ) {
+    return json_bufferAppend( out, str, strlen( str ) );
+}
+
+/** Write the id of a request. Its type was checked before. */
+static int writeId( jsonBuffer_t* out, json_t const* id ) {
+    if ( !id ) return append( out, "null" );
+    char const* const value = json_getValue( id );
+    if ( json_getType( id ) == JSON_TEXT ) return json_bufferAppendString( out, value, strlen( value ) );
+    return append( out, value );
+}
+
+/** Message of the standard error codes. */
+static char const* errorMessage( int code ) {
+    switch( code ) {
+        case JSON_RPC_PARSE_ERROR:      return "Parse error";
+        case JSON_RPC_INVALID_REQUEST:  return "Invalid Request";
+        case JSON_RPC_METHOD_NOT_FOUND: return "Method not found";
+        case JSON_RPC_INVALID_PARAMS:   return "Invalid params";
+        case JSON_RPC_INTERNAL_ERROR:   return "Internal error";
+        default:                        return "Server error";
+    }
+}
+
+/** Write an error response. */
+static int writeError( jsonBuffer_t* out, int code, char const* message, size_t len, json_t const* id ) {
+    char text[64];
+    sprintf( text, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":%d,\"message\":", code );
+    if ( append( out, text ) ) return -1;
+    if ( !message ) {
+        message = errorMessage( code );
+        len = strlen( message );
+    }
+    if ( json_bufferAppendString( out, message, len ) ) return -1;
+    if ( append( out, "},\"id\":" ) || writeId( out, id ) ) return -1;
+    return json_bufferAppend( out, "}", 1 );
+}
+
+/** Handle a request that is not in a batch or an element of a batch.
+  * @param rpc The handler of the dispatcher.
+  * @param request The request.
+  * @param out Buffer to append the response.
+  * @param message Buffer for the message of the error of a method.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int handleRequest( jsonRpc_t* rpc, json_t const* request, jsonBuffer_t* out, jsonBuffer_t* message ) {
+    if ( json_getType( request ) != JSON_OBJ )
+        return writeError( out, JSON_RPC_INVALID_REQUEST, 0, 0, 0 );
+    json_t const* const version = json_getProperty( request, "jsonrpc" );
+    json_t const* const method = json_getProperty( request, "method" );
+    json_t const* const params = json_getProperty( request, "params" );
+    json_t const* id = json_getProperty( request, "id" );
+    if ( id ) {
+        jsonType_t const type = json_getType( id );
+        if ( type != JSON_TEXT && type != JSON_INTEGER && type != JSON_REAL && type != JSON_NULL )
+            return writeError( out, JSON_RPC_INVALID_REQUEST, 0, 0, 0 );
+    }
+    bool const valid = version && json_getType( version ) == JSON_TEXT
+        && !strcmp( json_getValue( version ), "2.0" )
+        && method && json_getType( method ) == JSON_TEXT
+        && ( !params || json_getType( params ) == JSON_OBJ || json_getType( params ) == JSON_ARRAY );
+    if ( !valid ) return writeError( out, JSON_RPC_INVALID_REQUEST, 0, 0, id );
+    jsonRpcMethod_t const* const found = json_rpcFind( rpc, json_getValue( method ) );
+    if ( !found ) return id ? writeError( out, JSON_RPC_METHOD_NOT_FOUND, 0, 0, id ) : 0;
+    size_t const start = out->len;
+    if ( append( out, "{\"jsonrpc\":\"2.0\",\"result\":" ) ) return -1;
+    size_t const result = out->len;
+    int const code = found->handler( rpc->ctx, params, out );
+    if ( !id ) {
+        out->len = start;
+        return 0;
+    }
+    if ( code ) {
+        message->len = 0;
+        if ( json_bufferAppend( message, out->data + result, out->len - result ) ) return -1;
+        out->len = start;
+        return writeError( out, code, message->len ? message->data : 0, message->len, id );
+    }
+    if ( out->len == result && append( out, "null" ) ) return -1;
+    if ( append( out, ",\"id\":" ) || writeId( out, id ) ) return -1;
+    return json_bufferAppend( out, "}", 1 );
+}
+
+/** Handle a range of elements of a batch. Each response is preceded by a comma.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int handleElements( jsonRpc_t* rpc, json_t const* const* elements, size_t qty, jsonBuffer_t* out, jsonBuffer_t* message ) {
+    size_t i;
+    for( i = 0; i < qty; ++i ) {
+        size_t const start = out->len;
+        if ( json_bufferAppend( out, ",", 1 ) ) return -1;
+        if ( handleRequest( rpc, elements[i], out, message ) ) return -1;
+        if ( out->len == start + 1 ) out->len = start;
+    }
+    return 0;
+}
+
+/** Handle the part of the current batch with an index.
+  * The mutex must not be locked. */
+static void handlePart( jsonRpcWorkers_t* workers, unsigned int index ) {
+    size_t const size = workers->elementQty / workers->partQty;
+    size_t const extra = workers->elementQty % workers->partQty;
+    size_t const first = index * size + ( index < extra ? index : extra );
+    size_t const qty = size + ( index < extra );
+    part_t* const part = workers->parts + index;
+    part->out.len = 0;
+    int const result = handleElements( workers->rpc, workers->elements + first, qty, &part->out, &part->message );
+    pthread_mutex_lock( &workers->mutex );
+    if ( result ) workers->failed = true;
+    if ( !--workers->pending ) pthread_cond_signal( &workers->done );
+    pthread_mutex_unlock( &workers->mutex );
+}
+
+/** Take the parts of the batches until the dispatcher is freed. */
+static void* worker( void* arg ) {
+    jsonRpcWorkers_t* const workers = (jsonRpcWorkers_t*)arg;
+    pthread_mutex_lock( &workers->mutex );
+    while( !workers->stop ) {
+        if ( workers->next < workers->partQty ) {
+            unsigned int const index = workers->next++;
+            pthread_mutex_unlock( &workers->mutex );
+            handlePart( workers, index );
+            pthread_mutex_lock( &workers->mutex );
+        }
+        else pthread_cond_wait( &workers->work, &workers->mutex );
+    }
+    pthread_mutex_unlock( &workers->mutex );
+    return 0;
+}
+
+/** Stop the threads and free the memory of the workers. */
+static void workersFree( jsonRpcWorkers_t* workers ) {
+    pthread_mutex_lock( &workers->mutex );
+    workers->stop = true;
+    pthread_cond_broadcast( &workers->work );
+    pthread_mutex_unlock( &workers->mutex );
+    unsigned int i;
+    for( i = 0; i < workers->qty; ++i )
+        pthread_join( workers->threads[i], 0 );
+    for( i = 0; workers->parts && i <= workers->qty; ++i ) {
+        free( workers->parts[i].out.data );
+        free( workers->parts[i].message.data );
+    }
+    free( workers->parts );
+    free( workers->threads );
+    pthread_cond_destroy( &workers->done );
+    pthread_cond_destroy( &workers->work );
+    pthread_mutex_destroy( &workers->mutex );
+    free( workers );
+}
+
+/** Create the threads that dispatch the elements of batches.
+  * @param threads Number of threads, the calling one included.
+  * @return The workers or null pointer if there was not enough memory or threads. */
+static jsonRpcWorkers_t* workersCreate( jsonRpc_t* rpc, unsigned int threads ) {
+    jsonRpcWorkers_t* const workers = (jsonRpcWorkers_t*)calloc( 1, sizeof( jsonRpcWorkers_t ) );
+    if ( !workers ) return 0;
+    workers->rpc = rpc;
+    pthread_mutex_init( &workers->mutex, 0 );
+    pthread_cond_init( &workers->work, 0 );
+    pthread_cond_init( &workers->done, 0 );
+    workers->threads = (pthread_t*)malloc( ( threads - 1 ) * sizeof( pthread_t ) );
+    workers->parts = (part_t*)calloc( threads, sizeof( part_t ) );
+    if ( !workers->threads || !workers->parts ) {
+        workersFree( workers );
+        return 0;
+    }
+    for( ; workers->qty < threads - 1; ++workers->qty ) {
+        if ( pthread_create( workers->threads + workers->qty, 0, worker, workers ) ) {
+            workersFree( workers );
+            return 0;
+        }
+    }
+    return workers;
+}
+
+/** Handle the elements of a batch in parallel and join their responses.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int handleParallel( jsonRpcWorkers_t* workers, json_t const* const* elements, size_t qty, jsonBuffer_t* out ) {
+    unsigned int const partQty = qty < workers->qty + 1 ? (unsigned int)qty : workers->qty + 1;
+    pthread_mutex_lock( &workers->mutex );
+    workers->elements = elements;
+    workers->elementQty = qty;
+    workers->partQty = partQty;
+    workers->next = 0;
+    workers->pending = partQty;
+    workers->failed = false;
+    pthread_cond_broadcast( &workers->work );
+    while( workers->next < partQty ) {
+        unsigned int const index = workers->next++;
+        pthread_mutex_unlock( &workers->mutex );
+        handlePart( workers, index );
+        pthread_mutex_lock( &workers->mutex );
+    }
+    while( workers->pending )
+        pthread_cond_wait( &workers->done, &workers->mutex );
+    workers->partQty = 0;
+    bool const failed = workers->failed;
+    pthread_mutex_unlock( &workers->mutex );
+    if ( failed ) return -1;
+    size_t const start = out->len;
+    unsigned int i;
+    for( i = 0; i < partQty; ++i )
+        if ( json_bufferAppend( out, workers->parts[i].out.data, workers->parts[i].out.len ) ) return -1;
+    if ( out->len == start ) return 0;
+    out->data[ start ] = '[';
+    return json_bufferAppend( out, "]", 1 );
+}
+
+/* Create a dispatcher. */
+int json_rpcInit( jsonRpc_t* rpc, jsonRpcMethod_t const* methods, unsigned int qty, unsigned int threads, void* ctx ) {
+    rpc->methods = methods;
+    rpc->qty = qty;
+    rpc->buckets = qty / 4 + 1;
+    rpc->seeds = 0;
+    rpc->slots = 0;
+    rpc->mask = 0;
+    rpc->ctx = ctx;
+    rpc->workers = 0;
+    unsigned int i, j;
+    for( i = 0; i < qty; ++i )
+        for( j = 0; j < i; ++j )
+            if ( !strcmp( methods[i].name, methods[j].name ) ) return -1;
+    uint64_t* const hashes = (uint64_t*)malloc( ( qty ? qty : 1 ) * sizeof( uint64_t ) );
+    if ( !hashes ) return -1;
+    for( i = 0; i < qty; ++i )
+        hashes[i] = hashName( methods[i].name );
+    unsigned int slotQty = 1;
+    while( slotQty < qty ) slotQty *= 2;
+    int result;
+    do {
+        rpc->mask = slotQty - 1;
+        result = buildTable( rpc, hashes );
+        slotQty *= 2;
+    } while( result == 1 && slotQty <= 16 * qty + 16 );
+    free( hashes );
+    if ( result ) return -1;
+    if ( threads > 1 ) {
+        rpc->workers = workersCreate( rpc, threads );
+        if ( !rpc->workers ) {
+            json_rpcFree( rpc );
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Stop the threads and free the memory of a dispatcher. */
+void json_rpcFree( jsonRpc_t* rpc ) {
+    if ( rpc->workers ) workersFree( rpc->workers );
+    free( rpc->seeds );
+    free( (void*)rpc->slots );
+    rpc->workers = 0;
+    rpc->seeds = 0;
+    rpc->slots = 0;
+}
+
+/* Find a method by its name. */
+jsonRpcMethod_t const* json_rpcFind( jsonRpc_t const* rpc, char const* name ) {
+    if ( !rpc->slots ) return 0;
+    uint64_t const hash = hashName( name );
+    unsigned int const seed = rpc->seeds[ bucketOf( hash, rpc->buckets ) ];
+    jsonRpcMethod_t const* const method = rpc->slots[ slotOf( hash, seed, rpc->mask ) ];
+    return method && !strcmp( method->name, name ) ? method : 0;
+}
+
+/** Take the first property of the next document. */
+static json_t* poolInit( jsonPool_t* pool ) {
+    jsonRpcPool_t* const rpool = (jsonRpcPool_t*)pool;
+    rpool->block = 0;
+    rpool->nextFree = 0;
+    rpool->failed = false;
+    return pool->alloc( pool );
+}
+
+/** Take a property, moving to the next block when the current one is full. */
+static json_t* poolAlloc( jsonPool_t* pool ) {
+    jsonRpcPool_t* const rpool = (jsonRpcPool_t*)pool;
+    unsigned int const size = rpool->block < 14 ? POOL_BLOCK << rpool->block : POOL_MAX_BLOCK;
+    if ( rpool->blockQty && rpool->nextFree < size )
+        return rpool->blocks[ rpool->block ] + rpool->nextFree++;
+    unsigned int const next = rpool->blockQty ? rpool->block + 1 : 0;
+    if ( next == rpool->blockQty ) {
+        unsigned int const nextSize = next < 14 ? POOL_BLOCK << next : POOL_MAX_BLOCK;
+        json_t** const blocks = (json_t**)realloc( rpool->blocks, ( next + 1 ) * sizeof( json_t* ) );
+        if ( !blocks ) {
+            rpool->failed = true;
+            return 0;
+        }
+        rpool->blocks = blocks;
+        blocks[ next ] = (json_t*)malloc( nextSize * sizeof( json_t ) );
+        if ( !blocks[ next ] ) {
+            rpool->failed = true;
+            return 0;
+        }
+        ++rpool->blockQty;
+    }
+    rpool->block = next;
+    rpool->nextFree = 1;
+    return rpool->blocks[ next ];
+}
+
+/* Initialize an empty pool for json_rpcHandle(). */
+void json_rpcPoolInit( jsonRpcPool_t* pool ) {
+    memset( pool, 0, sizeof( jsonRpcPool_t ) );
+    pool->pool.init = poolInit;
+    pool->pool.alloc = poolAlloc;
+}
+
+/* Free the memory of a pool. */
+void json_rpcPoolFree( jsonRpcPool_t* pool ) {
+    unsigned int i;
+    for( i = 0; i < pool->blockQty; ++i )
+        free( pool->blocks[i] );
+    free( pool->blocks );
+    free( (void*)pool->elements );
+    free( pool->message.data );
+    json_rpcPoolInit( pool );
+}
+
+/* Handle a request or a batch of requests. */
+int json_rpcHandle( jsonRpc_t* rpc, char* text, jsonRpcPool_t* pool, jsonBuffer_t* out ) {
+    json_t const* const root = json_createWithPool( text, &pool->pool );
+    if ( !root ) return pool->failed ? -1 : writeError( out, JSON_RPC_PARSE_ERROR, 0, 0, 0 );
+    if ( json_getType( root ) == JSON_OBJ ) return handleRequest( rpc, root, out, &pool->message );
+    size_t qty = 0;
+    json_t const* element;
+    for( element = json_getChild( root ); element; element = json_getSibling( element ) ) {
+        if ( qty == pool->elementCap ) {
+            size_t const cap = pool->elementCap ? 2 * pool->elementCap : 64;
+            json_t const** const elements = (json_t const**)realloc( (void*)pool->elements, cap * sizeof( json_t const* ) );
+            if ( !elements ) return -1;
+            pool->elements = elements;
+            pool->elementCap = cap;
+        }
+        pool->elements[ qty++ ] = element;
+    }
+    if ( !qty ) return writeError( out, JSON_RPC_INVALID_REQUEST, 0, 0, 0 );
+    if ( rpc->workers && qty > 1 ) return handleParallel( rpc->workers, pool->elements, qty, out );
+    size_t const start = out->len;
+    if ( handleElements( rpc, pool->elements, qty, out, &pool->message ) ) return -1;
+    if ( out->len == start ) return 0;
+    out->data[ start ] = '[';
+    return json_bufferAppend( out, "]", 1 );
+}
+
+#ifdef __linux__
+
+/** State of a connection of the server. */
+typedef struct conn_s {
+    int fd;
+    jsonBuffer_t in;       /**< Characters received and not handled.       */
+    size_t scanned;        /**< Characters of in without a new line.       */
+    jsonBuffer_t out;      /**< Responses to send.                         */
+    size_t sent;           /**< Characters of out already sent.            */
+    jsonRpcPool_t pool;    /**< Pool recycled for every request.           */
+    uint32_t events;       /**< Events registered in epoll.                */
+    bool closing;          /**< The peer closed, only the output is left.  */
+    struct conn_s* prev;
+    struct conn_s* next;
+} conn_t;
+
+/** State of the server. */
+typedef struct server_s {
+    jsonRpc_t* rpc;
+    int epoll;
+    conn_t* conns;         /**< List of the connections.                   */
+} server_t;
+
+/** Close a connection and free its memory. */
+static void connClose( server_t* server, conn_t* conn ) {
+    epoll_ctl( server->epoll, EPOLL_CTL_DEL, conn->fd, 0 );
+    close( conn->fd );
+    if ( conn->prev ) conn->prev->next = conn->next;
+    else server->conns = conn->next;
+    if ( conn->next ) conn->next->prev = conn->prev;
+    json_rpcPoolFree( &conn->pool );
+    free( conn->in.data );
+    free( conn->out.data );
+    free( conn );
+}
+
+/** Register the events a connection is waiting for. It reads while its
+  * output is not too long and waits to write while there is output.
+  * @retval 0 if success.
+  * @retval -1 if the connection must be closed. */
+static int connUpdate( server_t* server, conn_t* conn ) {
+    size_t const pending = conn->out.len - conn->sent;
+    if ( conn->closing && !pending ) return -1;
+    uint32_t const events = ( !conn->closing && pending < MAX_PENDING ? EPOLLIN : 0 ) | ( pending ? EPOLLOUT : 0 );
+    if ( events == conn->events ) return 0;
+    struct epoll_event event;
+    event.events = events;
+    event.data.ptr = conn;
+    if ( epoll_ctl( server->epoll, EPOLL_CTL_MOD, conn->fd, &event ) ) return -1;
+    conn->events = events;
+    return 0;
+}
+
+/** Send the output of a connection until it is empty or the socket is full.
+  * @retval 0 if success.
+  * @retval -1 if the connection must be closed. */
+static int connSend( conn_t* conn ) {
+    while( conn->sent < conn->out.len ) {
+        ssize_t const n = send( conn->fd, conn->out.data + conn->sent, conn->out.len - conn->sent, MSG_NOSIGNAL );
+        if ( n < 0 && errno == EINTR ) continue;
+        if ( n < 0 ) return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+        conn->sent += (size_t)n;
+    }
+    conn->out.len = 0;
+    conn->sent = 0;
+    return 0;
+}
+
+/** Handle a request line of a connection.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int connRequest( server_t* server, conn_t* conn, char* line, size_t len ) {
+    if ( len && line[ len - 1 ] == '\r' ) --len;
+    line[ len ] = '\0';
+    size_t i;
+    for( i = 0; i < len && ( line[i] == ' ' || line[i] == '\t' ); ++i );
+    if ( i == len ) return 0;
+    size_t const start = conn->out.len;
+    if ( json_rpcHandle( server->rpc, line, &conn->pool, &conn->out ) ) return -1;
+    return conn->out.len == start ? 0 : json_bufferAppend( &conn->out, "\n", 1 );
+}
+
+/** Receive the requests of a connection and handle the complete lines.
+  * @retval 0 if success.
+  * @retval -1 if the connection must be closed. */
+static int connReceive( server_t* server, conn_t* conn ) {
+    jsonBuffer_t* const in = &conn->in;
+    if ( in->cap - in->len < 65536 ) {
+        size_t const cap = in->cap ? 2 * in->cap : 65536;
+        char* const data = (char*)realloc( in->data, cap );
+        if ( !data ) return -1;
+        in->data = data;
+        in->cap = cap;
+    }
+    ssize_t const n = recv( conn->fd, in->data + in->len, in->cap - in->len - 1, 0 );
+    if ( n < 0 ) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+    if ( !n ) conn->closing = true;
+    in->len += (size_t)n;
+    size_t begin = 0;
+    for(;;) {
+        char* const end = (char*)memchr( in->data + conn->scanned, '\n', in->len - conn->scanned );
+        if ( !end ) break;
+        size_t const len = (size_t)( end - in->data ) - begin;
+        if ( connRequest( server, conn, in->data + begin, len ) ) return -1;
+        begin += len + 1;
+        conn->scanned = begin;
+    }
+    if ( conn->closing && begin < in->len ) {
+        if ( connRequest( server, conn, in->data + begin, in->len - begin ) ) return -1;
+        begin = in->len;
+    }
+    memmove( in->data, in->data + begin, in->len - begin );
+    in->len -= begin;
+    conn->scanned = in->len;
+    if ( in->len > MAX_REQUEST ) return -1;
+    return connSend( conn );
+}
+
+/** Accept the pending connections of the listener.
+  * @retval 0 if success.
+  * @retval -1 if the listener failed. */
+static int serverAccept( server_t* server, int listener ) {
+    for(;;) {
+        int const fd = accept( listener, 0, 0 );
+        if ( fd < 0 ) {
+            if ( errno == EINTR || errno == ECONNABORTED ) continue;
+            if ( errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM ) return 0;
+            return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+        }
+        int const one = 1;
+        setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one );
+        conn_t* const conn = (conn_t*)calloc( 1, sizeof( conn_t ) );
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = conn;
+        if ( !conn || fcntl( fd, F_SETFL, fcntl( fd, F_GETFL ) | O_NONBLOCK )
+            || epoll_ctl( server->epoll, EPOLL_CTL_ADD, fd, &event ) ) {
+            free( conn );
+            close( fd );
+            continue;
+        }
+        conn->fd = fd;
+        conn->events = EPOLLIN;
+        json_rpcPoolInit( &conn->pool );
+        conn->next = server->conns;
+        if ( conn->next ) conn->next->prev = conn;
+        server->conns = conn;
+    }
+}
+
+/* Serve the connections of a listening socket until a flag is set. */
+int json_rpcServe( jsonRpc_t* rpc, int listener, sig_atomic_t volatile const* stop ) {
+    server_t server;
+    server.rpc = rpc;
+    server.conns = 0;
+    server.epoll = epoll_create1( EPOLL_CLOEXEC );
+    if ( server.epoll < 0 ) return -1;
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = 0;
+    int const flags = fcntl( listener, F_GETFL );
+    int result = -1;
+    if ( flags < 0 || fcntl( listener, F_SETFL, flags | O_NONBLOCK ) ) goto end;
+    if ( epoll_ctl( server.epoll, EPOLL_CTL_ADD, listener, &event ) ) goto end;
+    while( !__atomic_load_n( stop, __ATOMIC_ACQUIRE ) ) {
+        struct epoll_event events[64];
+        int const qty = epoll_wait( server.epoll, events, 64, 100 );
+        if ( qty < 0 && errno != EINTR ) goto end;
+        int i;
+        for( i = 0; i < qty; ++i ) {
+            conn_t* const conn = (conn_t*)events[i].data.ptr;
+            if ( !conn ) {
+                if ( serverAccept( &server, listener ) ) goto end;
+                continue;
+            }
+            int failed = 0;
+            if ( events[i].events & ( EPOLLERR | EPOLLHUP ) && !( events[i].events & EPOLLIN ) ) failed = -1;
+            if ( !failed && events[i].events & EPOLLOUT ) failed = connSend( conn );
+            if ( !failed && events[i].events & EPOLLIN ) failed = connReceive( &server, conn );
+            if ( failed || connUpdate( &server, conn ) ) connClose( &server, conn );
+        }
+    }
+    result = 0;
+end:
+    while( server.conns ) connClose( &server, server.conns );
+    epoll_ctl( server.epoll, EPOLL_CTL_DEL, listener, 0 );
+    close( server.epoll );
+    if ( flags >= 0 ) fcntl( listener, F_SETFL, flags );
+    return result;
+}
+
+#else
+
+/* Serve the connections of a listening socket until a flag is set. */
+int json_rpcServe( jsonRpc_t* rpc, int listener, sig_atomic_t volatile const* stop ) {
+    (void)rpc;
+    (void)listener;
+    (void)stop;
+    return -1;
+}
+
+#endif
@@ -0,0 +1,165 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_RPC_H_
+#define	_TINY_JSON_RPC_H_
+
+#ifdef TINY_JSON_USE_WCHAR
+#error "tiny-json-rpc.h works with char strings only, it cannot be used when TINY_JSON_USE_WCHAR is defined."
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <signal.h>
+#include "tiny-json.h"
+#include "tiny-json-ndjson.h"
+
+/** @defgroup tinyJsonRpc JSON-RPC 2.0 dispatcher and server.
+  * The methods are found through a perfect hash table built once, so a
+  * request costs one hash and one string comparison. The elements of a batch
+  * are dispatched in parallel by a set of threads and their responses are
+  * written in order. The server reads requests and writes responses a line
+  * each, on TCP or Unix sockets, with epoll, and parses each request into a
+  * pool of its connection that is recycled for the next one. The server
+  * needs Linux, the rest POSIX threads.
+  * @{ */
+
+/** Error codes of JSON-RPC 2.0. */
+enum {
+    JSON_RPC_PARSE_ERROR = -32700,
+    JSON_RPC_INVALID_REQUEST = -32600,
+    JSON_RPC_METHOD_NOT_FOUND = -32601,
+    JSON_RPC_INVALID_PARAMS = -32602,
+    JSON_RPC_INTERNAL_ERROR = -32603
+};
+
+/** A method that can be called. */
+typedef struct jsonRpcMethod_s {
+    char const* name;      /**< Name of the method.                        */
+    /** Run the method. It may be called from several threads at the same time.
+      * @param ctx The context of the dispatcher.
+      * @param params The params of the request or null pointer if there are none.
+      * @param out Buffer to write the JSON text of the result.
+      * @return Zero if success or an error code. Then the text written to
+      *         out, if any, is the message of the error. */
+    int (*handler)( void* ctx, json_t const* params, jsonBuffer_t* out );
+} jsonRpcMethod_t;
+
+/** Threads that dispatch the elements of batches. It is private. */
+typedef struct jsonRpcWorkers_s jsonRpcWorkers_t;
+
+/** Dispatcher of requests. */
+typedef struct jsonRpc_s {
+    jsonRpcMethod_t const* methods; /**< The methods.                      */
+    unsigned int qty;      /**< Number of methods.                         */
+    unsigned int buckets;  /**< Number of buckets of the first level.      */
+    unsigned int* seeds;   /**< Seed of the second level of each bucket.   */
+    jsonRpcMethod_t const** slots; /**< Perfect hash table of the methods. */
+    unsigned int mask;     /**< Number of slots minus one.                 */
+    void* ctx;             /**< Context passed to the methods.             */
+    jsonRpcWorkers_t* workers; /**< Threads for the batches.               */
+} jsonRpc_t;
+
+/** Recyclable pool of properties. It grows by blocks that are kept for the
+  * next documents, so a request is parsed in place at the first attempt. */
+typedef struct jsonRpcPool_s {
+    jsonPool_t pool;       /**< The callbacks of the pool.                 */
+    json_t** blocks;       /**< Blocks of properties, each one larger.     */
+    unsigned int blockQty; /**< Number of blocks allocated.                */
+    unsigned int block;    /**< Index of the block in use.                 */
+    unsigned int nextFree; /**< Index of the next free property in it.     */
+    bool failed;           /**< A block could not be allocated.            */
+    json_t const** elements; /**< Elements of the current batch.           */
+    size_t elementCap;     /**< Length of the array of elements.           */
+    jsonBuffer_t message;  /**< Message of the error of a method.          */
+} jsonRpcPool_t;
+
+/** Create a dispatcher.
+  * @param rpc The handler of the dispatcher.
+  * @param methods The methods. The array must outlive the dispatcher.
+  * @param qty Number of methods. Their names must be different.
+  * @param threads Number of threads that dispatch the elements of batches,
+  *        the calling thread included. Zero or one for none.
+  * @param ctx Context passed to the methods.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory or threads. */
+int json_rpcInit( jsonRpc_t* rpc, jsonRpcMethod_t const* methods, unsigned int qty, unsigned int threads, void* ctx );
+
+/** Stop the threads and free the memory of a dispatcher.
+  * @param rpc The handler of the dispatcher. */
+void json_rpcFree( jsonRpc_t* rpc );
+
+/** Find a method by its name.
+  * @param rpc The handler of the dispatcher.
+  * @param name The name.
+  * @return The method or null pointer if there is none with that name. */
+jsonRpcMethod_t const* json_rpcFind( jsonRpc_t const* rpc, char const* name );
+
+/** Initialize an empty pool for json_rpcHandle().
+  * @param pool The handler of the pool. */
+void json_rpcPoolInit( jsonRpcPool_t* pool );
+
+/** Free the memory of a pool.
+  * @param pool The handler of the pool. */
+void json_rpcPoolFree( jsonRpcPool_t* pool );
+
+/** Handle a request or a batch of requests. Only one thread can call it for
+  * a dispatcher at a time.
+  * @param rpc The handler of the dispatcher.
+  * @param text The text of the request terminated by a null character. It
+  *        will be modified.
+  * @param pool A pool of the calling connection or thread.
+  * @param out Buffer to append the response. Nothing is appended for
+  *        notifications.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+int json_rpcHandle( jsonRpc_t* rpc, char* text, jsonRpcPool_t* pool, jsonBuffer_t* out );
+
+/** Serve the connections of a listening socket until a flag is set. Each line
+  * received is a request and each response is written in a line.
+  * @param rpc The handler of the dispatcher.
+  * @param listener A TCP or Unix socket that is listening.
+  * @param stop Pointer to a flag that stops the server when it is not zero.
+  *        It is checked at least every 100 ms. Set it from a signal handler
+  *        or, from another thread, with an atomic store such as
+  *        __atomic_store_n( stop, 1, __ATOMIC_RELEASE ).
+  * @retval 0 if the server was stopped.
+  * @retval -1 if there was an error or it is not supported. */
+int json_rpcServe( jsonRpc_t* rpc, int listener, sig_atomic_t volatile const* stop );
+
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_RPC_H_ */
@@ -0,0 +1,441 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "tiny-json-schema.h"
+
+/** Create a node without values.
+  * @param name Name of the field or null pointer.
+  * @return The node or null pointer if there was not enough memory. */
+static jsonSchemaNode_t* newNode( char const* name ) {
+    jsonSchemaNode_t* const node = (jsonSchemaNode_t*)calloc( 1, sizeof( jsonSchemaNode_t ) );
+    if ( !node ) return 0;
+    if ( name ) {
+        size_t const len = strlen( name );
+        node->name = (char*)malloc( len + 1 );
+        if ( !node->name ) {
+            free( node );
+            return 0;
+        }
+        memcpy( node->name, name, len + 1 );
+    }
+    node->minLength = SIZE_MAX;
+    node->minItems = SIZE_MAX;
+    node->minimum = INFINITY;
+    node->maximum = -INFINITY;
+    return node;
+}
+
+/** Free a node with its fields and elements. */
+static void freeNode( jsonSchemaNode_t* node ) {
+    if ( !node ) return;
+    jsonSchemaNode_t* field = node->fields;
+    while( field ) {
+        jsonSchemaNode_t* const next = field->next;
+        freeNode( field );
+        field = next;
+    }
+    freeNode( node->items );
+    free( node->name );
+    free( node );
+}
+
+/** Get the node of a field of the objects of a node, adding it if it is new.
+  * The objects of a corpus usually have their fields in the same order, so
+  * the field after the previous one is tried before searching all of them.
+  * @param node The node of the objects.
+  * @param cursor The field expected. It is updated to the next one.
+  * @param name The name of the field.
+  * @return The node of the field or null pointer if there was not enough memory. */
+static jsonSchemaNode_t* findField( jsonSchemaNode_t* node, jsonSchemaNode_t** cursor, char const* name ) {
+    jsonSchemaNode_t* field = *cursor;
+    if ( !field || strcmp( field->name, name ) ) {
+        jsonSchemaNode_t** link;
+        for( link = &node->fields; *link; link = &(*link)->next )
+            if ( !strcmp( (*link)->name, name ) ) break;
+        if ( !*link ) *link = newNode( name );
+        field = *link;
+    }
+    if ( field ) *cursor = field->next;
+    return field;
+}
+
+/** Count the characters of a UTF-8 text. */
+static size_t characters( char const* str ) {
+    size_t qty = 0;
+    for( ; *str; ++str )
+        qty += ( *str & 0xc0 ) != 0x80;
+    return qty;
+}
+
+/** Add a value to a node.
+  * @param node The node.
+  * @param json The value.
+  * @param position Position of the document of the value.
+  * @return Number of properties of the value or -1 if there was not enough memory. */
+static long addValue( jsonSchemaNode_t* node, json_t const* json, size_t position ) {
+    jsonType_t const type = json_getType( json );
+    if ( !node->count++ ) node->first = position;
+    ++node->types[ type ];
+    long properties = 1;
+    if ( type == JSON_TEXT ) {
+        size_t const len = characters( json_getValue( json ) );
+        if ( node->minLength > len ) node->minLength = len;
+        if ( node->maxLength < len ) node->maxLength = len;
+    }
+    else if ( type == JSON_INTEGER || type == JSON_REAL ) {
+        double const value = json_getReal( json );
+        if ( node->minimum > value ) node->minimum = value;
+        if ( node->maximum < value ) node->maximum = value;
+    }
+    else if ( type == JSON_OBJ ) {
+        jsonSchemaNode_t* cursor = node->fields;
+        json_t const* child;
+        for( child = json_getChild( json ); child; child = json_getSibling( child ) ) {
+            jsonSchemaNode_t* const field = findField( node, &cursor, json_getName( child ) );
+            long const qty = field ? addValue( field, child, position ) : -1;
+            if ( qty < 0 ) return -1;
+            properties += qty;
+        }
+    }
+    else if ( type == JSON_ARRAY ) {
+        size_t items = 0;
+        json_t const* child;
+        for( child = json_getChild( json ); child; child = json_getSibling( child ), ++items ) {
+            if ( !node->items && !( node->items = newNode( 0 ) ) ) return -1;
+            long const qty = addValue( node->items, child, position );
+            if ( qty < 0 ) return -1;
+            properties += qty;
+        }
+        if ( node->minItems > items ) node->minItems = items;
+        if ( node->maxItems < items ) node->maxItems = items;
+    }
+    return properties;
+}
+
+/** Merge a node into another. The fields and elements of the source are
+  * moved to the destination when it has none of its own.
+  * @param dst The node that receives the values.
+  * @param src The other node. It is freed.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int mergeNode( jsonSchemaNode_t* dst, jsonSchemaNode_t* src ) {
+    dst->count += src->count;
+    if ( dst->first > src->first ) dst->first = src->first;
+    unsigned int i;
+    for( i = 0; i <= JSON_NULL; ++i )
+        dst->types[i] += src->types[i];
+    if ( dst->minLength > src->minLength ) dst->minLength = src->minLength;
+    if ( dst->maxLength < src->maxLength ) dst->maxLength = src->maxLength;
+    if ( dst->minimum > src->minimum ) dst->minimum = src->minimum;
+    if ( dst->maximum < src->maximum ) dst->maximum = src->maximum;
+    if ( dst->minItems > src->minItems ) dst->minItems = src->minItems;
+    if ( dst->maxItems < src->maxItems ) dst->maxItems = src->maxItems;
+    int result = 0;
+    if ( !dst->items ) dst->items = src->items;
+    else if ( src->items ) result = mergeNode( dst->items, src->items );
+    src->items = 0;
+    jsonSchemaNode_t* cursor = dst->fields;
+    while( src->fields ) {
+        jsonSchemaNode_t* const field = src->fields;
+        src->fields = field->next;
+        field->next = 0;
+        jsonSchemaNode_t* const same = result ? 0 : findField( dst, &cursor, field->name );
+        if ( !same ) result = -1;
+        else if ( !same->count ) {
+            /* It was just added: take the whole subtree of the source. */
+            jsonSchemaNode_t* const next = same->next;
+            free( same->name );
+            *same = *field;
+            same->next = next;
+            free( field );
+            continue;
+        }
+        else if ( mergeNode( same, field ) ) result = -1;
+        else continue;
+        freeNode( field );
+    }
+    freeNode( src );
+    return result;
+}
+
+/** Sort a list of fields by the position where they were found first. The
+  * sort is stable, so the fields found in the same document keep their order.
+  * @return The first field of the sorted list. */
+static jsonSchemaNode_t* sortFields( jsonSchemaNode_t* list ) {
+    if ( !list || !list->next ) return list;
+    jsonSchemaNode_t* slow = list;
+    jsonSchemaNode_t* fast = list->next;
+    for( ; fast && fast->next; fast = fast->next->next )
+        slow = slow->next;
+    jsonSchemaNode_t* second = slow->next;
+    slow->next = 0;
+    jsonSchemaNode_t* first = sortFields( list );
+    second = sortFields( second );
+    jsonSchemaNode_t* head = 0;
+    jsonSchemaNode_t** tail = &head;
+    while( first && second ) {
+        jsonSchemaNode_t** const taken = second->first < first->first ? &second : &first;
+        *tail = *taken;
+        tail = &(*taken)->next;
+        *taken = (*taken)->next;
+    }
+    *tail = first ? first : second;
+    return head;
+}
+
+/** Sort the fields of a node and of its descendants. */
+static void sortNode( jsonSchemaNode_t* node ) {
+    if ( !node ) return;
+    node->fields = sortFields( node->fields );
+    jsonSchemaNode_t* field;
+    for( field = node->fields; field; field = field->next )
+        sortNode( field );
+    sortNode( node->items );
+}
+
+/** Add a document to a schema.
+  * @param position Position of the document.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int addDocument( jsonSchema_t* schema, json_t const* json, size_t position ) {
+    if ( !schema->root && !( schema->root = newNode( 0 ) ) ) return -1;
+    long const properties = addValue( schema->root, json, position );
+    if ( properties < 0 ) return -1;
+    ++schema->documents;
+    schema->properties += (unsigned long long)properties;
+    if ( schema->maxProperties < (unsigned long)properties ) schema->maxProperties = (unsigned int)properties;
+    return 0;
+}
+
+/* Initialize an empty schema. */
+void json_schemaInit( jsonSchema_t* schema ) {
+    schema->root = 0;
+    schema->documents = 0;
+    schema->invalid = 0;
+    schema->maxProperties = 0;
+    schema->properties = 0;
+}
+
+/* Add a document to a schema. */
+int json_schemaAdd( jsonSchema_t* schema, json_t const* json ) {
+    return addDocument( schema, json, schema->documents );
+}
+
+/* Merge a schema into another. */
+int json_schemaMerge( jsonSchema_t* dst, jsonSchema_t* src ) {
+    int result = 0;
+    if ( !dst->root ) dst->root = src->root;
+    else if ( src->root ) result = mergeNode( dst->root, src->root );
+    dst->documents += src->documents;
+    dst->invalid += src->invalid;
+    dst->properties += src->properties;
+    if ( dst->maxProperties < src->maxProperties ) dst->maxProperties = src->maxProperties;
+    json_schemaInit( src );
+    return result;
+}
+
+/* Free the memory of a schema and leave it empty. */
+void json_schemaFree( jsonSchema_t* schema ) {
+    freeNode( schema->root );
+    json_schemaInit( schema );
+}
+
+/** Partial schema of a thread in the list of the threads that finished. */
+typedef struct partial_s {
+    jsonSchema_t schema;
+    char const* text;      /**< The whole text, to get the offsets of the lines. */
+    struct partial_s* next;
+} partial_t;
+
+/** State of an inference with several threads. */
+typedef struct job_s {
+    char const* text;      /**< The whole text.                            */
+    partial_t* partials;   /**< Partial schemas of the threads that finished. */
+    pthread_mutex_t mutex; /**< It protects the list of partial schemas.   */
+} job_t;
+
+/** Create the partial schema of a thread. */
+static void* partialCreate( void* ctx ) {
+    partial_t* const partial = (partial_t*)malloc( sizeof( partial_t ) );
+    if ( !partial ) return 0;
+    json_schemaInit( &partial->schema );
+    partial->text = ( (job_t const*)ctx )->text;
+    return partial;
+}
+
+/** Keep the partial schema of a thread that finished to merge it. */
+static void partialDone( void* ctx, void* local ) {
+    job_t* const job = (job_t*)ctx;
+    partial_t* const partial = (partial_t*)local;
+    pthread_mutex_lock( &job->mutex );
+    partial->next = job->partials;
+    job->partials = partial;
+    pthread_mutex_unlock( &job->mutex );
+}
+
+/** Add a line to the partial schema of the thread. It is called from the threads. */
+static int addLine( void* ctx, json_t const* json, char const* line, size_t len, jsonBuffer_t* out ) {
+    partial_t* const partial = (partial_t*)ctx;
+    jsonSchema_t* const schema = &partial->schema;
+    (void)len;
+    (void)out;
+    if ( json ) return addDocument( schema, json, (size_t)( line - partial->text ) );
+    ++schema->invalid;
+    return 0;
+}
+
+/* Add the lines of an NDJSON text to a schema with several threads. */
+int json_schemaInfer( jsonSchema_t* schema, unsigned int threads, char const* text, size_t len ) {
+    job_t job;
+    job.text = text;
+    job.partials = 0;
+    pthread_mutex_init( &job.mutex, 0 );
+    jsonNdjson_t const ndjson = {
+        .threads = threads,
+        .ctx = &job,
+        .process = addLine,
+        .threadStart = partialCreate,
+        .threadEnd = partialDone
+    };
+    int result = json_ndjsonRun( &ndjson, text, len );
+    pthread_mutex_destroy( &job.mutex );
+    jsonSchema_t all;
+    json_schemaInit( &all );
+    while( job.partials ) {
+        partial_t* const partial = job.partials;
+        job.partials = partial->next;
+        if ( !result ) result = json_schemaMerge( &all, &partial->schema );
+        json_schemaFree( &partial->schema );
+        free( partial );
+    }
+    sortNode( all.root );
+    if ( !result ) result = json_schemaMerge( schema, &all );
+    json_schemaFree( &all );
+    return result;
+}
+
+/** Names of the types in a JSON Schema. */
+static char const* const typeNames[] = {
+    "object", "array", "string", "boolean", "integer", "number", "null"
+};
+
+/** Write a keyword with a number. Integers are written without decimals. */
+static int writeNumber( jsonBuffer_t* out, char const* keyword, double value ) {
+    char text[64];
+    int len = sprintf( text, ",\"%s\":", keyword );
+    if ( value == floor( value ) && fabs( value ) < 9007199254740992.0 )
+        len += json_formatInteger( (int64_t)value, text + len, sizeof text - (unsigned int)len );
+    else len += json_formatReal( value, text + len, sizeof text - (unsigned int)len );
+    return json_bufferAppend( out, text, (size_t)len );
+}
+
+static int writeNode( jsonBuffer_t* out, jsonSchemaNode_t const* node );
+
+/** Write the keywords of a node, each one after a comma. */
+static int writeKeywords( jsonBuffer_t* out, jsonSchemaNode_t const* node ) {
+    unsigned long const* const types = node->types;
+    unsigned int qty = 0;
+    unsigned int i;
+    for( i = 0; i <= JSON_NULL; ++i )
+        qty += types[i] && !( i == JSON_INTEGER && types[ JSON_REAL ] );
+    if ( json_bufferAppend( out, ",\"type\":", 8 ) ) return -1;
+    if ( qty > 1 && json_bufferAppend( out, "[", 1 ) ) return -1;
+    unsigned int written = 0;
+    for( i = 0; i <= JSON_NULL; ++i ) {
+        if ( !types[i] || ( i == JSON_INTEGER && types[ JSON_REAL ] ) ) continue;
+        if ( written++ && json_bufferAppend( out, ",", 1 ) ) return -1;
+        if ( json_bufferAppendString( out, typeNames[i], strlen( typeNames[i] ) ) ) return -1;
+    }
+    if ( qty > 1 && json_bufferAppend( out, "]", 1 ) ) return -1;
+    if ( writeNumber( out, "x-count", (double)node->count ) ) return -1;
+    if ( types[ JSON_TEXT ] ) {
+        if ( writeNumber( out, "minLength", (double)node->minLength ) ) return -1;
+        if ( writeNumber( out, "maxLength", (double)node->maxLength ) ) return -1;
+    }
+    if ( types[ JSON_INTEGER ] || types[ JSON_REAL ] ) {
+        if ( writeNumber( out, "minimum", node->minimum ) ) return -1;
+        if ( writeNumber( out, "maximum", node->maximum ) ) return -1;
+    }
+    if ( types[ JSON_ARRAY ] ) {
+        if ( writeNumber( out, "minItems", (double)node->minItems ) ) return -1;
+        if ( writeNumber( out, "maxItems", (double)node->maxItems ) ) return -1;
+        if ( node->items ) {
+            if ( json_bufferAppend( out, ",\"items\":", 9 ) ) return -1;
+            if ( writeNode( out, node->items ) ) return -1;
+        }
+    }
+    if ( types[ JSON_OBJ ] ) {
+        jsonSchemaNode_t const* field;
+        if ( json_bufferAppend( out, ",\"properties\":{", 15 ) ) return -1;
+        for( field = node->fields; field; field = field->next ) {
+            if ( field != node->fields && json_bufferAppend( out, ",", 1 ) ) return -1;
+            if ( json_bufferAppendString( out, field->name, strlen( field->name ) ) ) return -1;
+            if ( json_bufferAppend( out, ":", 1 ) ) return -1;
+            if ( writeNode( out, field ) ) return -1;
+        }
+        if ( json_bufferAppend( out, "},\"required\":[", 14 ) ) return -1;
+        written = 0;
+        for( field = node->fields; field; field = field->next ) {
+            if ( field->count < types[ JSON_OBJ ] ) continue;
+            if ( written++ && json_bufferAppend( out, ",", 1 ) ) return -1;
+            if ( json_bufferAppendString( out, field->name, strlen( field->name ) ) ) return -1;
+        }
+        if ( json_bufferAppend( out, "]", 1 ) ) return -1;
+    }
+    return 0;
+}
+
+/** Write a node as a JSON Schema. The comma before its first keyword is
+  * replaced by the opening brace. */
+static int writeNode( jsonBuffer_t* out, jsonSchemaNode_t const* node ) {
+    size_t const start = out->len;
+    if ( writeKeywords( out, node ) ) return -1;
+    out->data[ start ] = '{';
+    return json_bufferAppend( out, "}", 1 );
+}
+
+/* Write a schema as a JSON Schema with the counts as "x-" keywords. */
+int json_schemaWrite( jsonSchema_t const* schema, jsonBuffer_t* out ) {
+    static char const head[] = "{\"$schema\":\"https://json-schema.org/draft/2020-12/schema\"";
+    if ( json_bufferAppend( out, head, sizeof head - 1 ) ) return -1;
+    if ( writeNumber( out, "x-documents", (double)schema->documents ) ) return -1;
+    if ( writeNumber( out, "x-invalid", (double)schema->invalid ) ) return -1;
+    if ( writeNumber( out, "x-properties", (double)schema->properties ) ) return -1;
+    if ( writeNumber( out, "x-maxProperties", (double)schema->maxProperties ) ) return -1;
+    if ( schema->root && writeKeywords( out, schema->root ) ) return -1;
+    return json_bufferAppend( out, "}", 1 );
+}
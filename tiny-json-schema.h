@@ -0,0 +1,128 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_SCHEMA_H_
+#define	_TINY_JSON_SCHEMA_H_
+
+#ifdef TINY_JSON_USE_WCHAR
+#error "tiny-json-schema.h works with char strings only, it cannot be used when TINY_JSON_USE_WCHAR is defined."
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "tiny-json.h"
+#include "tiny-json-ndjson.h"
+
+/** @defgroup tinyJsonSchema Schema inference.
+  * The documents of a corpus are summarized in a tree with a node per path:
+  * the fields found in the objects, the types found in each path with their
+  * counts, the range of lengths of the texts, of the numbers and of the
+  * number of elements of the arrays. The lines of an NDJSON text are
+  * summarized by several threads, each one in its own tree, and the trees
+  * are merged at the end. POSIX threads only.
+  * @{ */
+
+/** Summary of the values found in a path. */
+typedef struct jsonSchemaNode_s {
+    char* name;            /**< Name of the field. Null pointer for the root and the elements of arrays. */
+    unsigned long count;   /**< Number of values found.                    */
+    unsigned long types[ JSON_NULL + 1 ]; /**< Number of values of each type. */
+    size_t minLength;      /**< Minimum number of characters of the texts. */
+    size_t maxLength;      /**< Maximum number of characters of the texts. */
+    double minimum;        /**< Minimum of the numbers.                    */
+    double maximum;        /**< Maximum of the numbers.                    */
+    size_t minItems;       /**< Minimum number of elements of the arrays.  */
+    size_t maxItems;       /**< Maximum number of elements of the arrays.  */
+    struct jsonSchemaNode_s* fields; /**< Fields of the objects in the order they were found. */
+    struct jsonSchemaNode_s* next;   /**< Next field of the same objects.  */
+    struct jsonSchemaNode_s* items;  /**< Summary of the elements of the arrays. */
+    size_t first;          /**< Position of the document where it was found first:
+                                its index or, in json_schemaInfer(), its offset. */
+} jsonSchemaNode_t;
+
+/** Schema inferred from a corpus. */
+typedef struct jsonSchema_s {
+    jsonSchemaNode_t* root;     /**< Summary of the documents. Null pointer if none. */
+    unsigned long documents;    /**< Number of documents.                   */
+    unsigned long invalid;      /**< Number of lines that are not valid JSON. */
+    unsigned int maxProperties; /**< Maximum number of properties of a document:
+                                     a pool of this length fits them all.   */
+    unsigned long long properties; /**< Number of properties of all the documents. */
+} jsonSchema_t;
+
+/** Initialize an empty schema.
+  * @param schema The handler of the schema. */
+void json_schemaInit( jsonSchema_t* schema );
+
+/** Add a document to a schema.
+  * @param schema The handler of the schema.
+  * @param json The root of the document.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+int json_schemaAdd( jsonSchema_t* schema, json_t const* json );
+
+/** Add the lines of an NDJSON text to a schema with several threads. The
+  * result does not depend on the number of threads: the fields are in the
+  * order of the lines where they were found first.
+  * @param schema The handler of the schema.
+  * @param threads Number of threads. See jsonNdjson_t.
+  * @param text The text. It is not modified.
+  * @param len Length of the text.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory or threads. */
+int json_schemaInfer( jsonSchema_t* schema, unsigned int threads, char const* text, size_t len );
+
+/** Merge a schema into another.
+  * @param dst The handler of the schema that receives the documents.
+  * @param src The handler of the other schema. It is left empty.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+int json_schemaMerge( jsonSchema_t* dst, jsonSchema_t* src );
+
+/** Write a schema as a JSON Schema with the counts as "x-" keywords.
+  * @param schema The handler of the schema.
+  * @param out Buffer to append the text.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+int json_schemaWrite( jsonSchema_t const* schema, jsonBuffer_t* out );
+
+/** Free the memory of a schema and leave it empty.
+  * @param schema The handler of the schema. */
+void json_schemaFree( jsonSchema_t* schema );
+
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_SCHEMA_H_ */
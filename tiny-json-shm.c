@@ -0,0 +1,337 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "tiny-json-shm.h"
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+/** Identifies a segment created by json_shmCreate(). */
+#define MAGIC 0x4e534a54u
+
+/** Version of the layout of the segment. */
+#define VERSION 1u
+
+/** Size of a cache line. The counters of each process are in their own line. */
+#define LINE 64
+
+/** Header at the start of a segment. */
+typedef struct header_s {
+    uint32_t magic;        /**< MAGIC once the segment is initialized.     */
+    uint32_t version;      /**< VERSION.                                   */
+    uint32_t slotQty;      /**< Number of slots, a power of two.           */
+    uint32_t finished;     /**< The producer will not publish any more.    */
+    uint64_t slotSize;     /**< Size of a slot.                            */
+    char pad1[ LINE - 24 ];
+    uint32_t tail;         /**< Number of documents published.             */
+    uint32_t consumerWaits;/**< The consumer sleeps on tail.               */
+    char pad2[ LINE - 8 ];
+    uint32_t head;         /**< Number of documents released.              */
+    uint32_t producerWaits;/**< The producer sleeps on head.               */
+    char pad3[ LINE - 8 ];
+} header_t;
+
+/** Round a size up to a multiple of a power of two. */
+static size_t roundUp( size_t size, size_t align ) {
+    return ( size + align - 1 ) & ~( align - 1 );
+}
+
+/** Get the document of a slot. */
+static jsonShmDoc_t* slotOf( jsonShm_t const* shm, uint32_t index ) {
+    return (jsonShmDoc_t*)( (char*)shm->base + sizeof( header_t ) + ( index & shm->mask ) * shm->slotSize );
+}
+
+/** Compute the deadline of a timeout in milliseconds. */
+static void deadlineOf( struct timespec* deadline, int timeout ) {
+    clock_gettime( CLOCK_MONOTONIC, deadline );
+    deadline->tv_sec += timeout / 1000;
+    deadline->tv_nsec += ( timeout % 1000 ) * 1000000L;
+    if ( deadline->tv_nsec >= 1000000000L ) {
+        ++deadline->tv_sec;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+/** Sleep while a counter has a value, until it is woken or the deadline.
+  * @param word The counter in the segment.
+  * @param value The value seen by the caller.
+  * @param deadline The deadline or null pointer to wait forever.
+  * @retval 0 if it was woken or the value changed.
+  * @retval 1 if the deadline passed. */
+static int sleepOn( uint32_t* word, uint32_t value, struct timespec const* deadline ) {
+    struct timespec left = { 0, 1000000L };
+    if ( deadline ) {
+        struct timespec now;
+        clock_gettime( CLOCK_MONOTONIC, &now );
+        left.tv_sec = deadline->tv_sec - now.tv_sec;
+        left.tv_nsec = deadline->tv_nsec - now.tv_nsec;
+        if ( left.tv_nsec < 0 ) {
+            --left.tv_sec;
+            left.tv_nsec += 1000000000L;
+        }
+        if ( left.tv_sec < 0 ) return 1;
+    }
+#ifdef __linux__
+    syscall( SYS_futex, word, FUTEX_WAIT, value, deadline ? &left : 0, 0, 0 );
+#else
+    if ( !deadline || left.tv_sec || left.tv_nsec > 1000000L ) {
+        left.tv_sec = 0;
+        left.tv_nsec = 1000000L;
+    }
+    if ( __atomic_load_n( word, __ATOMIC_SEQ_CST ) == value ) nanosleep( &left, 0 );
+#endif
+    return 0;
+}
+
+/** Wake the process that sleeps on a counter, if any. */
+static void wake( uint32_t* word, uint32_t* waits ) {
+#ifdef __linux__
+    if ( __atomic_load_n( waits, __ATOMIC_SEQ_CST ) )
+        syscall( SYS_futex, word, FUTEX_WAKE, INT_MAX, 0, 0, 0 );
+#else
+    (void)word;
+    (void)waits;
+#endif
+}
+
+/** Wait until a counter is not equal to a value. The other process checks
+  * the waits flag after changing the counter, so it cannot miss the sleep.
+  * @param word The counter in the segment.
+  * @param waits The flag that tells the other process to wake this one.
+  * @param value The value to wait to change.
+  * @param finished A flag that also ends the wait or null pointer.
+  * @param timeout Milliseconds to wait or -1 to wait forever.
+  * @retval 0 if the counter changed or the flag was set.
+  * @retval 1 if the timeout passed. */
+static int waitChange( uint32_t* word, uint32_t* waits, uint32_t value, uint32_t const* finished, int timeout ) {
+    struct timespec deadline;
+    if ( timeout >= 0 ) deadlineOf( &deadline, timeout );
+    for(;;) {
+        __atomic_add_fetch( waits, 1, __ATOMIC_SEQ_CST );
+        int result = 0;
+        if ( __atomic_load_n( word, __ATOMIC_SEQ_CST ) == value
+             && !( finished && __atomic_load_n( finished, __ATOMIC_SEQ_CST ) ) )
+            result = sleepOn( word, value, timeout >= 0 ? &deadline : 0 );
+        __atomic_sub_fetch( waits, 1, __ATOMIC_SEQ_CST );
+        if ( __atomic_load_n( word, __ATOMIC_ACQUIRE ) != value ) return 0;
+        if ( finished && __atomic_load_n( finished, __ATOMIC_ACQUIRE ) ) return 0;
+        if ( result ) return 1;
+    }
+}
+
+/** Map a segment. The file descriptor is closed in any case.
+  * @retval 0 if success.
+  * @retval -1 if failed. */
+static int mapSegment( jsonShm_t* shm, int fd, size_t size ) {
+    void* const base = mmap( 0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    close( fd );
+    if ( base == MAP_FAILED ) return -1;
+    shm->base = base;
+    shm->size = size;
+    shm->received = 0;
+    shm->mem = 0;
+    shm->qty = 0;
+    return 0;
+}
+
+/* Create a segment for the producer. */
+int json_shmCreate( jsonShm_t* shm, char const* name, unsigned int slotQty, size_t slotSize ) {
+    if ( !slotQty || slotQty & ( slotQty - 1 ) ) return -1;
+    slotSize = roundUp( slotSize, LINE );
+    if ( slotSize < 2 * LINE || slotSize > UINT32_MAX ) return -1;
+    size_t const size = sizeof( header_t ) + slotQty * slotSize;
+    int const fd = shm_open( name, O_CREAT | O_EXCL | O_RDWR, 0600 );
+    if ( fd < 0 ) return -1;
+    if ( ftruncate( fd, (off_t)size ) ) {
+        close( fd );
+        shm_unlink( name );
+        return -1;
+    }
+    if ( mapSegment( shm, fd, size ) ) {
+        shm_unlink( name );
+        return -1;
+    }
+    shm->mask = slotQty - 1;
+    shm->slotSize = slotSize;
+    shm->qty = (unsigned int)( slotSize / sizeof( jsonShmNode_t ) );
+    shm->mem = (json_t*)malloc( shm->qty * sizeof( json_t ) );
+    if ( !shm->mem ) {
+        json_shmClose( shm );
+        shm_unlink( name );
+        return -1;
+    }
+    header_t* const header = (header_t*)shm->base;
+    header->version = VERSION;
+    header->slotQty = slotQty;
+    header->slotSize = slotSize;
+    __atomic_store_n( &header->magic, MAGIC, __ATOMIC_RELEASE );
+    return 0;
+}
+
+/* Map a segment created by the producer for the consumer. */
+int json_shmOpen( jsonShm_t* shm, char const* name ) {
+    int const fd = shm_open( name, O_RDWR, 0 );
+    if ( fd < 0 ) return -1;
+    struct stat info;
+    if ( fstat( fd, &info ) || (size_t)info.st_size < sizeof( header_t ) ) {
+        close( fd );
+        return -1;
+    }
+    if ( mapSegment( shm, fd, (size_t)info.st_size ) ) return -1;
+    header_t const* const header = (header_t const*)shm->base;
+    bool const valid = __atomic_load_n( &header->magic, __ATOMIC_ACQUIRE ) == MAGIC
+        && header->version == VERSION
+        && header->slotQty && !( header->slotQty & ( header->slotQty - 1 ) )
+        && sizeof( header_t ) + header->slotQty * header->slotSize == shm->size;
+    if ( !valid ) {
+        json_shmClose( shm );
+        return -1;
+    }
+    shm->mask = header->slotQty - 1;
+    shm->slotSize = (size_t)header->slotSize;
+    return 0;
+}
+
+/* Unmap a segment. */
+void json_shmClose( jsonShm_t* shm ) {
+    munmap( shm->base, shm->size );
+    free( shm->mem );
+    shm->base = 0;
+    shm->mem = 0;
+}
+
+/* Remove the name of a segment. */
+void json_shmUnlink( char const* name ) {
+    shm_unlink( name );
+}
+
+/** Write the nodes of a tree parsed into the properties of the producer.
+  * The index of a node is the index of its property, so the root is the first.
+  * @return The number of nodes written. */
+static uint32_t writeNodes( jsonShm_t const* shm, json_t const* json, jsonShmNode_t* nodes, char const* text ) {
+    jsonShmNode_t* const node = nodes + ( json - shm->mem );
+    char const* const name = json_getName( json );
+    json_t const* const sibling = json_getSibling( json );
+    node->name = name ? (uint32_t)( name - text ) : JSON_SHM_NONE;
+    node->sibling = sibling ? (uint32_t)( sibling - shm->mem ) : 0;
+    node->type = (uint32_t)json_getType( json );
+    if ( node->type != JSON_OBJ && node->type != JSON_ARRAY ) {
+        node->value = (uint32_t)( json_getValue( json ) - text );
+        return 1;
+    }
+    json_t const* child = json_getChild( json );
+    node->value = child ? (uint32_t)( child - shm->mem ) : 0;
+    uint32_t qty = 1;
+    for( ; child; child = json_getSibling( child ) )
+        qty += writeNodes( shm, child, nodes, text );
+    return qty;
+}
+
+/* Parse a document into the next free slot and hand it to the consumer. */
+int json_shmPublish( jsonShm_t* shm, char const* text, size_t len, int timeout ) {
+    header_t* const header = (header_t*)shm->base;
+    uint32_t const tail = header->tail;
+    uint32_t head = __atomic_load_n( &header->head, __ATOMIC_ACQUIRE );
+    while( tail - head > shm->mask ) {
+        if ( waitChange( &header->head, &header->producerWaits, head, 0, timeout ) ) return 1;
+        head = __atomic_load_n( &header->head, __ATOMIC_ACQUIRE );
+    }
+    size_t const nodes = sizeof( jsonShmDoc_t ) + roundUp( len + 1, sizeof( jsonShmNode_t ) );
+    if ( nodes + sizeof( jsonShmNode_t ) > shm->slotSize ) return -1;
+    jsonShmDoc_t* const doc = slotOf( shm, tail );
+    char* const str = (char*)( doc + 1 );
+    memcpy( str, text, len );
+    str[ len ] = '\0';
+    json_t const* const root = json_create( str, shm->mem, (unsigned int)( ( shm->slotSize - nodes ) / sizeof( jsonShmNode_t ) ) );
+    if ( !root ) return -1;
+    jsonShmNode_t* const array = (jsonShmNode_t*)( (char*)doc + nodes );
+    doc->qty = writeNodes( shm, root, array, str );
+    doc->len = (uint32_t)len;
+    doc->nodes = (uint32_t)nodes;
+    doc->reserved = 0;
+    __atomic_store_n( &header->tail, tail + 1, __ATOMIC_SEQ_CST );
+    wake( &header->tail, &header->consumerWaits );
+    return 0;
+}
+
+/* Tell the consumer that no more documents will be published. */
+void json_shmFinish( jsonShm_t* shm ) {
+    header_t* const header = (header_t*)shm->base;
+    __atomic_store_n( &header->finished, 1, __ATOMIC_SEQ_CST );
+    wake( &header->tail, &header->consumerWaits );
+}
+
+/* Take the next document. */
+int json_shmReceive( jsonShm_t* shm, jsonShmDoc_t const** doc, int timeout ) {
+    header_t* const header = (header_t*)shm->base;
+    uint32_t const next = header->head + shm->received;
+    for(;;) {
+        if ( __atomic_load_n( &header->tail, __ATOMIC_ACQUIRE ) != next ) {
+            *doc = slotOf( shm, next );
+            ++shm->received;
+            return 0;
+        }
+        if ( __atomic_load_n( &header->finished, __ATOMIC_ACQUIRE ) ) {
+            if ( __atomic_load_n( &header->tail, __ATOMIC_ACQUIRE ) == next ) return -1;
+            continue;
+        }
+        if ( waitChange( &header->tail, &header->consumerWaits, next, &header->finished, timeout ) ) return 1;
+    }
+}
+
+/* Release the oldest document taken. */
+void json_shmRelease( jsonShm_t* shm ) {
+    header_t* const header = (header_t*)shm->base;
+    if ( !shm->received ) return;
+    --shm->received;
+    __atomic_store_n( &header->head, header->head + 1, __ATOMIC_SEQ_CST );
+    wake( &header->head, &header->producerWaits );
+}
+
+/* Search a property by its name in an object. */
+jsonShmNode_t const* json_shmProperty( jsonShmDoc_t const* doc, jsonShmNode_t const* obj, char const* name ) {
+    jsonShmNode_t const* node;
+    for( node = json_shmChild( doc, obj ); node; node = json_shmSibling( doc, node ) ) {
+        char const* const nodeName = json_shmName( doc, node );
+        if ( nodeName && !strcmp( nodeName, name ) ) return node;
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_SHM_H_
+#define	_TINY_JSON_SHM_H_
+
+#ifdef TINY_JSON_USE_WCHAR
+#error "tiny-json-shm.h works with char strings only, it cannot be used when TINY_JSON_USE_WCHAR is defined."
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tiny-json.h"
+
+/** @defgroup tinyJsonShm Parsed documents in shared memory.
+  * A producer process parses documents into the slots of a ring in a segment
+  * of shared memory and a consumer process reads the trees there without
+  * parsing or copying them again. As the segment is mapped at different
+  * addresses by each process, the nodes of a tree link each other by their
+  * indexes and point to their names and values by their offsets. The text is
+  * parsed in place inside the slot. A process that waits for a slot sleeps
+  * on a futex in the segment on Linux and polls elsewhere. Only a producer
+  * and a consumer can use a ring. POSIX only.
+  * @{ */
+
+/** Value of the offset of a node without name. */
+#define JSON_SHM_NONE 0xffffffffu
+
+/** Node of a tree in shared memory. */
+typedef struct jsonShmNode_s {
+    uint32_t name;         /**< Offset of the name or JSON_SHM_NONE.       */
+    uint32_t value;        /**< Offset of the value text or index of the first child. Zero if there are no children. */
+    uint32_t sibling;      /**< Index of the next sibling or zero.         */
+    uint32_t type;         /**< The jsonType_t of the node.                */
+} jsonShmNode_t;
+
+/** Document in a slot. The nodes are after the text and the root is the first one. */
+typedef struct jsonShmDoc_s {
+    uint32_t len;          /**< Length of the text.                        */
+    uint32_t qty;          /**< Number of nodes.                           */
+    uint32_t nodes;        /**< Offset of the array of nodes.              */
+    uint32_t reserved;
+} jsonShmDoc_t;
+
+/** Handler of a mapped segment. */
+typedef struct jsonShm_s {
+    void* base;            /**< Start of the mapping.                      */
+    size_t size;           /**< Length of the mapping.                     */
+    unsigned int mask;     /**< Number of slots minus one.                 */
+    size_t slotSize;       /**< Size of a slot in bytes.                   */
+    unsigned int received; /**< Slots received and not released, consumer only. */
+    json_t* mem;           /**< Properties to parse into, producer only.   */
+    unsigned int qty;      /**< Length of mem.                             */
+} jsonShm_t;
+
+/** Create a segment for the producer. It fails if a segment with the same
+  * name exists, f.i. one left by a producer that crashed: remove it first
+  * with json_shmUnlink() if it is known to be stale.
+  * @param shm The handler of the segment.
+  * @param name Name of the segment for shm_open(), f.i. "/orders".
+  * @param slotQty Number of slots. It must be a power of two.
+  * @param slotSize Size of a slot. The largest document must fit in it with
+  *        16 bytes per node.
+  * @retval 0 if success.
+  * @retval -1 if the segment exists or it could not be created. */
+int json_shmCreate( jsonShm_t* shm, char const* name, unsigned int slotQty, size_t slotSize );
+
+/** Map a segment created by the producer for the consumer.
+  * @param shm The handler of the segment.
+  * @param name Name of the segment.
+  * @retval 0 if success.
+  * @retval -1 if the segment could not be mapped or it is not valid. */
+int json_shmOpen( jsonShm_t* shm, char const* name );
+
+/** Unmap a segment. The segment exists until json_shmUnlink() is called.
+  * @param shm The handler of the segment. */
+void json_shmClose( jsonShm_t* shm );
+
+/** Remove the name of a segment. Processes that mapped it keep it.
+  * @param name Name of the segment. */
+void json_shmUnlink( char const* name );
+
+/** Parse a document into the next free slot and hand it to the consumer.
+  * @param shm The handler of the segment of the producer.
+  * @param text The text of the document. It is not modified.
+  * @param len Length of the text.
+  * @param timeout Milliseconds to wait for a free slot or -1 to wait forever.
+  * @retval 0 if success.
+  * @retval 1 if all the slots are still in use after the timeout.
+  * @retval -1 if the document is not valid or it does not fit in a slot. */
+int json_shmPublish( jsonShm_t* shm, char const* text, size_t len, int timeout );
+
+/** Tell the consumer that no more documents will be published.
+  * @param shm The handler of the segment of the producer. */
+void json_shmFinish( jsonShm_t* shm );
+
+/** Take the next document. It can be read until it is released.
+  * @param shm The handler of the segment of the consumer.
+  * @param doc Pointer to store the document.
+  * @param timeout Milliseconds to wait for a document or -1 to wait forever.
+  * @retval 0 if success.
+  * @retval 1 if there is no document after the timeout.
+  * @retval -1 if the producer finished and all the documents were taken. */
+int json_shmReceive( jsonShm_t* shm, jsonShmDoc_t const** doc, int timeout );
+
+/** Release the oldest document taken, so its slot can be reused.
+  * @param shm The handler of the segment of the consumer. */
+void json_shmRelease( jsonShm_t* shm );
+
+/** Get the root of a document. Its type is JSON_OBJ or JSON_ARRAY. */
+static inline jsonShmNode_t const* json_shmRoot( jsonShmDoc_t const* doc ) {
+    return (jsonShmNode_t const*)( (char const*)doc + doc->nodes );
+}
+
+/** Get the type of a node. */
+static inline jsonType_t json_shmType( jsonShmNode_t const* node ) {
+    return (jsonType_t)node->type;
+}
+
+/** Get the name of a node.
+  * @return The name or null pointer if it is unnamed. */
+static inline char const* json_shmName( jsonShmDoc_t const* doc, jsonShmNode_t const* node ) {
+    return node->name == JSON_SHM_NONE ? 0 : (char const*)( doc + 1 ) + node->name;
+}
+
+/** Get the value of a node that is not an object or an array. */
+static inline char const* json_shmValue( jsonShmDoc_t const* doc, jsonShmNode_t const* node ) {
+    return (char const*)( doc + 1 ) + node->value;
+}
+
+/** Get the first child of an object or an array.
+  * @return The child or null pointer if it has none. */
+static inline jsonShmNode_t const* json_shmChild( jsonShmDoc_t const* doc, jsonShmNode_t const* node ) {
+    return node->value ? json_shmRoot( doc ) + node->value : 0;
+}
+
+/** Get the next sibling of a node.
+  * @return The sibling or null pointer if it is the last one. */
+static inline jsonShmNode_t const* json_shmSibling( jsonShmDoc_t const* doc, jsonShmNode_t const* node ) {
+    return node->sibling ? json_shmRoot( doc ) + node->sibling : 0;
+}
+
+/** Search a property by its name in an object.
+  * @return The property or null pointer if not found. */
+jsonShmNode_t const* json_shmProperty( jsonShmDoc_t const* doc, jsonShmNode_t const* obj, char const* name );
+
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_SHM_H_ */
@@ -0,0 +1,153 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "tiny-json-soa.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define TINY_JSON_SSE2
+#endif
+
+/** Make room for one more node.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int reserve( jsonSoa_t* soa ) {
+    if ( soa->qty < soa->cap ) return 0;
+    if ( soa->cap > UINT32_MAX / 2 ) return -1;
+    uint32_t const cap = soa->cap ? 2 * soa->cap : 256;
+    uint8_t* const types = (uint8_t*)realloc( soa->types, cap );
+    if ( !types ) return -1;
+    soa->types = types;
+    uint32_t* const names = (uint32_t*)realloc( soa->names, cap * sizeof( uint32_t ) );
+    if ( !names ) return -1;
+    soa->names = names;
+    uint32_t* const values = (uint32_t*)realloc( soa->values, cap * sizeof( uint32_t ) );
+    if ( !values ) return -1;
+    soa->values = values;
+    uint32_t* const next = (uint32_t*)realloc( soa->next, cap * sizeof( uint32_t ) );
+    if ( !next ) return -1;
+    soa->next = next;
+    soa->cap = cap;
+    return 0;
+}
+
+/** Get the offset of a name or a value in the text.
+  * @return The offset or JSON_SOA_NONE if it does not fit in 32 bits. */
+static uint32_t offsetOf( jsonSoa_t const* soa, char const* str ) {
+    size_t const offset = (size_t)( str - soa->text );
+    return offset < JSON_SOA_NONE ? (uint32_t)offset : JSON_SOA_NONE;
+}
+
+/** Append a node and its descendants in document order.
+  * @return The index of the node or -1 if there was not enough memory or
+  *         an offset does not fit in 32 bits. */
+static int64_t append( jsonSoa_t* soa, json_t const* json ) {
+    if ( reserve( soa ) ) return -1;
+    uint32_t const index = soa->qty++;
+    char const* const name = json_getName( json );
+    jsonType_t const type = json_getType( json );
+    soa->types[ index ] = (uint8_t)type;
+    soa->names[ index ] = name ? offsetOf( soa, name ) : JSON_SOA_NONE;
+    if ( name && soa->names[ index ] == JSON_SOA_NONE ) return -1;
+    soa->next[ index ] = 0;
+    if ( type != JSON_OBJ && type != JSON_ARRAY ) {
+        soa->values[ index ] = offsetOf( soa, json_getValue( json ) );
+        return soa->values[ index ] == JSON_SOA_NONE ? -1 : index;
+    }
+    int64_t previous = -1;
+    json_t const* child;
+    for( child = json_getChild( json ); child; child = json_getSibling( child ) ) {
+        int64_t const current = append( soa, child );
+        if ( current < 0 ) return -1;
+        if ( previous >= 0 ) soa->next[ previous ] = (uint32_t)current;
+        previous = current;
+    }
+    soa->values[ index ] = soa->qty;
+    return index;
+}
+
+/* Copy a parsed tree into a struct-of-arrays. */
+int json_soaBuild( jsonSoa_t* soa, json_t const* root, char const* text ) {
+    soa->qty = 0;
+    soa->text = text;
+    return append( soa, root ) < 0 ? -1 : 0;
+}
+
+/* Free the memory of a struct-of-arrays. */
+void json_soaFree( jsonSoa_t* soa ) {
+    free( soa->next );
+    free( soa->values );
+    free( soa->names );
+    free( soa->types );
+    memset( soa, 0, sizeof( jsonSoa_t ) );
+}
+
+/* Count the nodes of a type in a range of indexes. */
+size_t json_soaCount( jsonSoa_t const* soa, jsonType_t type, uint32_t first, uint32_t end ) {
+    uint8_t const* const types = soa->types;
+    size_t count = 0;
+    uint32_t i = first;
+#ifdef TINY_JSON_SSE2
+    /* Each byte of the accumulator counts up to 255 matches before it is summed. */
+    __m128i const key = _mm_set1_epi8( (char)type );
+    while( end - i >= 16 ) {
+        uint32_t const blocks = ( end - i ) / 16 < 255 ? ( end - i ) / 16 : 255;
+        __m128i sum = _mm_setzero_si128();
+        uint32_t j;
+        for( j = 0; j < blocks; ++j, i += 16 ) {
+            __m128i const chunk = _mm_loadu_si128( (__m128i const*)( types + i ) );
+            sum = _mm_sub_epi8( sum, _mm_cmpeq_epi8( chunk, key ) );
+        }
+        __m128i const total = _mm_sad_epu8( sum, _mm_setzero_si128() );
+        count += (size_t)_mm_cvtsi128_si32( total ) + (size_t)_mm_cvtsi128_si32( _mm_srli_si128( total, 8 ) );
+    }
+#endif
+    for( ; i < end; ++i )
+        count += types[i] == type;
+    return count;
+}
+
+/* Find the next node of a type. */
+uint32_t json_soaFind( jsonSoa_t const* soa, jsonType_t type, uint32_t first ) {
+    uint8_t const* const types = soa->types;
+    uint32_t i = first;
+#ifdef TINY_JSON_SSE2
+    __m128i const key = _mm_set1_epi8( (char)type );
+    for( ; i < soa->qty && soa->qty - i >= 16; i += 16 ) {
+        __m128i const chunk = _mm_loadu_si128( (__m128i const*)( types + i ) );
+        unsigned int const mask = (unsigned int)_mm_movemask_epi8( _mm_cmpeq_epi8( chunk, key ) );
+        if ( mask ) return i + (uint32_t)__builtin_ctz( mask );
+    }
+#endif
+    for( ; i < soa->qty; ++i )
+        if ( types[i] == type ) return i;
+    return soa->qty;
+}
@@ -0,0 +1,138 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_SOA_H_
+#define	_TINY_JSON_SOA_H_
+
+#ifdef TINY_JSON_USE_WCHAR
+#error "tiny-json-soa.h works with char strings only, it cannot be used when TINY_JSON_USE_WCHAR is defined."
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tiny-json.h"
+
+/** @defgroup tinyJsonSoa Struct-of-arrays layout of a tree.
+  * The nodes of a parsed tree are copied in document order into parallel
+  * arrays: a byte with the type of each node, the offsets of their names and
+  * values in the text and the indexes of their next siblings. Queries on the
+  * types, f.i. counting the nulls or finding all the texts, scan the array of
+  * types 16 nodes at a time with SSE2 instead of following the links of the
+  * json_t. As the nodes of a subtree are consecutive, a subtree is a range of
+  * indexes.
+  * @{ */
+
+/** Value of the offset of a node without name. */
+#define JSON_SOA_NONE 0xffffffffu
+
+/** Tree in struct-of-arrays layout. The root is the first node. */
+typedef struct jsonSoa_s {
+    uint8_t* types;        /**< The jsonType_t of each node.               */
+    uint32_t* names;       /**< Offset of each name or JSON_SOA_NONE.      */
+    uint32_t* values;      /**< Offset of each value text or, for objects and arrays, index past their last descendant. */
+    uint32_t* next;        /**< Index of each next sibling or zero.        */
+    uint32_t qty;          /**< Number of nodes.                           */
+    uint32_t cap;          /**< Length of the allocated arrays.            */
+    char const* text;      /**< The text the offsets refer to.             */
+} jsonSoa_t;
+
+/** Copy a parsed tree into a struct-of-arrays. The arrays of a previous tree
+  * are reused. The pool of the tree can be reused when it returns.
+  * @param soa The handler of the arrays. Initialize it with zeros.
+  * @param root The root of the tree.
+  * @param text The text that was parsed. It must be kept while the arrays are used.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory or a name or a value is beyond
+  *         the first 4 GB of the text. */
+int json_soaBuild( jsonSoa_t* soa, json_t const* root, char const* text );
+
+/** Free the memory of a struct-of-arrays.
+  * @param soa The handler of the arrays. */
+void json_soaFree( jsonSoa_t* soa );
+
+/** Count the nodes of a type in a range of indexes.
+  * @param soa The handler of the arrays.
+  * @param type The type.
+  * @param first Index of the first node.
+  * @param end Index past the last node, f.i. qty or the end of a subtree.
+  * @return The number of nodes of that type. */
+size_t json_soaCount( jsonSoa_t const* soa, jsonType_t type, uint32_t first, uint32_t end );
+
+/** Find the next node of a type.
+  * @param soa The handler of the arrays.
+  * @param type The type.
+  * @param first Index of the first node to check.
+  * @return The index of the node or qty if there is none. */
+uint32_t json_soaFind( jsonSoa_t const* soa, jsonType_t type, uint32_t first );
+
+/** Get the type of a node. */
+static inline jsonType_t json_soaType( jsonSoa_t const* soa, uint32_t index ) {
+    return (jsonType_t)soa->types[ index ];
+}
+
+/** Get the name of a node.
+  * @return The name or null pointer if it is unnamed. */
+static inline char const* json_soaName( jsonSoa_t const* soa, uint32_t index ) {
+    return soa->names[ index ] == JSON_SOA_NONE ? 0 : soa->text + soa->names[ index ];
+}
+
+/** Get the value of a node that is not an object or an array. */
+static inline char const* json_soaValue( jsonSoa_t const* soa, uint32_t index ) {
+    return soa->text + soa->values[ index ];
+}
+
+/** Get the index past the last descendant of a node. */
+static inline uint32_t json_soaEnd( jsonSoa_t const* soa, uint32_t index ) {
+    jsonType_t const type = json_soaType( soa, index );
+    return type == JSON_OBJ || type == JSON_ARRAY ? soa->values[ index ] : index + 1;
+}
+
+/** Get the first child of an object or an array.
+  * @return Its index or zero if it has no children. */
+static inline uint32_t json_soaChild( jsonSoa_t const* soa, uint32_t index ) {
+    return json_soaEnd( soa, index ) > index + 1 ? index + 1 : 0;
+}
+
+/** Get the next sibling of a node.
+  * @return Its index or zero if it is the last one. */
+static inline uint32_t json_soaSibling( jsonSoa_t const* soa, uint32_t index ) {
+    return soa->next[ index ];
+}
+
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_SOA_H_ */
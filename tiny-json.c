@@ -27,10 +27,41 @@
 
 */
 
+#include <limits.h>
 #include <string.h>
 #include <ctype.h>
 #include "tiny-json.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define TINY_JSON_SSE2
+#endif
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#define TINY_JSON_SSSE3
+#endif
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#define TINY_JSON_AVX2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define atomicCompareExchange( ptr, expected, desired ) \
+    ( (unsigned int)_InterlockedCompareExchange( (long volatile*)(ptr), (long)(desired), (long)(expected) ) == (expected) )
+#define atomicLoad( ptr ) ( *(unsigned int const volatile*)(ptr) )
+#define atomicIncrement( ptr ) ( (unsigned int)_InterlockedIncrement( (long volatile*)(ptr) ) )
+#define atomicDecrement( ptr ) ( (unsigned int)_InterlockedDecrement( (long volatile*)(ptr) ) )
+#else
+#define atomicCompareExchange( ptr, expected, desired ) \
+    __atomic_compare_exchange_n( (ptr), &(unsigned int){ (expected) }, (desired), 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED )
+#define atomicLoad( ptr ) __atomic_load_n( (ptr), __ATOMIC_RELAXED )
+#define atomicIncrement( ptr ) __atomic_add_fetch( (ptr), 1, __ATOMIC_RELAXED )
+#define atomicDecrement( ptr ) __atomic_sub_fetch( (ptr), 1, __ATOMIC_ACQ_REL )
+#endif
+
 /** Structure to handle a heap of JSON properties. */
 typedef struct jsonStaticPool_s {
     json_t* mem;      /**< Pointer to array of json properties.      */
@@ -75,14 +106,37 @@ json_t const* json_createWithPool( CHAR_T *str, jsonPool_t *pool ) {
     CHAR_T* ptr = goBlank( str );
     if ( !ptr || (*ptr != T('{') && *ptr != T('[')) ) return 0;
     json_t* obj = pool->init( pool );
+    if ( !obj ) return 0;
     obj->name    = 0;
     obj->sibling = 0;
     obj->u.c.child = 0;
+#ifdef TINY_JSON_USE_PARENT
+    obj->parent = 0;
+    obj->depth = 0;
+#endif
     ptr = objValue( ptr, obj, pool );
     if ( !ptr ) return 0;
     return obj;
 }
 
+/** Check whether a pool with lifecycle callbacks has a callback.
+  * Callbacks beyond the size given by the program are missing. */
+#define hasCallback( ex, field ) \
+    ( (ex)->size >= offsetof( jsonPoolEx_t, field ) + sizeof (ex)->field && (ex)->field )
+
+/* Parse a string to get a json with a pool that is reused for each document. */
+json_t const* json_createWithPoolEx( CHAR_T* str, jsonPoolEx_t* pool ) {
+    if ( hasCallback( pool, reset ) ) pool->reset( &pool->pool );
+    json_t const* const json = json_createWithPool( str, &pool->pool );
+    if ( !json && hasCallback( pool, onFailure ) ) pool->onFailure( &pool->pool );
+    return json;
+}
+
+/* Release the resources of a pool with lifecycle callbacks. */
+void json_poolRelease( jsonPoolEx_t* pool ) {
+    if ( hasCallback( pool, release ) ) pool->release( &pool->pool );
+}
+
 /* Parse a string to get a json. */
 json_t const* json_create( CHAR_T* str, json_t mem[], unsigned int qty ) {
     jsonStaticPool_t spool;
@@ -319,6 +373,10 @@ static CHAR_T* numValue( CHAR_T* ptr, json_t* property ) {
   * @param property The handler of the property to be added. */
 static void add( json_t* obj, json_t* property ) {
     property->sibling = 0;
+#ifdef TINY_JSON_USE_PARENT
+    property->parent = obj;
+    property->depth = obj->depth + 1;
+#endif
     if ( !obj->u.c.child ){
 	    obj->u.c.child = property;
 	    obj->u.c.last_child = property;
@@ -328,6 +386,32 @@ static void add( json_t* obj, json_t* property ) {
     }
 }
 
+/** Record where a JSON object or array begins, if TINY_JSON_USE_SPAN is defined.
+  * @param obj The handler of the JSON object or array.
+  * @param ptr Pointer to its first character.
+  * @param count Number of properties allocated so far in the document. */
+static void openSpan( json_t* obj, CHAR_T const* ptr, unsigned int count ) {
+#ifdef TINY_JSON_USE_SPAN
+    obj->u.c.begin = ptr;
+    obj->u.c.descendants = count;
+#else
+    (void)obj, (void)ptr, (void)count;
+#endif
+}
+
+/** Record where a JSON object or array ends, if TINY_JSON_USE_SPAN is defined.
+  * @param obj The handler of the JSON object or array.
+  * @param ptr Pointer to its last character.
+  * @param count Number of properties allocated so far in the document. */
+static void closeSpan( json_t* obj, CHAR_T const* ptr, unsigned int count ) {
+#ifdef TINY_JSON_USE_SPAN
+    obj->u.c.end = ptr + 1;
+    obj->u.c.descendants = count - obj->u.c.descendants;
+#else
+    (void)obj, (void)ptr, (void)count;
+#endif
+}
+
 /** Parser a string to get a json object value.
   * @param ptr Pointer to first character.
   * @param obj The handler of the JSON root object or array.
@@ -338,6 +422,8 @@ static CHAR_T* objValue( CHAR_T* ptr, json_t* obj, jsonPool_t* pool ) {
     obj->type    = *ptr == T('{') ? JSON_OBJ : JSON_ARRAY;
     obj->u.c.child = 0;
     obj->sibling = 0;
+    unsigned int count = 0;
+    openSpan( obj, ptr, count );
     ptr++;
     for(;;) {
         ptr = goBlank( ptr );
@@ -348,6 +434,7 @@ static CHAR_T* objValue( CHAR_T* ptr, json_t* obj, jsonPool_t* pool ) {
         }
         CHAR_T const endchar = ( obj->type == JSON_OBJ )? T('}'): T(']');
         if ( *ptr == endchar ) {
+            closeSpan( obj, ptr, count );
             *ptr = T('\0');
             json_t* parentObj = obj->sibling;
             if ( !parentObj ) return ++ptr;
@@ -358,6 +445,7 @@ static CHAR_T* objValue( CHAR_T* ptr, json_t* obj, jsonPool_t* pool ) {
         }
         json_t* property = pool->alloc( pool );
         if ( !property ) return 0;
+        ++count;
         if( obj->type != JSON_ARRAY ) {
             if ( *ptr != T('\"') ) return 0;
             ptr = propertyName( ptr, property );
@@ -370,6 +458,7 @@ static CHAR_T* objValue( CHAR_T* ptr, json_t* obj, jsonPool_t* pool ) {
             case T('{'):
                 property->type    = JSON_OBJ;
                 property->u.c.child = 0;
+                openSpan( property, ptr, count );
                 property->sibling = obj;
                 obj = property;
                 ++ptr;
@@ -377,6 +466,7 @@ static CHAR_T* objValue( CHAR_T* ptr, json_t* obj, jsonPool_t* pool ) {
             case T('['):
                 property->type    = JSON_ARRAY;
                 property->u.c.child = 0;
+                openSpan( property, ptr, count );
                 property->sibling = obj;
                 obj = property;
                 ++ptr;
@@ -410,6 +500,253 @@ static json_t* poolAlloc( jsonPool_t* pool ) {
     return spool->mem + spool->nextFree++;
 }
 
+/* Initialize an arena of json properties. */
+void json_arenaInit( jsonArena_t* arena, json_t mem[], unsigned int qty ) {
+    arena->mem = mem;
+    arena->qty = qty;
+    arena->nextFree = 0;
+}
+
+/* Free all the json properties of an arena at once. */
+void json_arenaReset( jsonArena_t* arena ) {
+    arena->nextFree = 0;
+}
+
+/* Get the number of json properties taken from an arena. */
+unsigned int json_arenaUsed( jsonArena_t const* arena ) {
+    return atomicLoad( &arena->nextFree );
+}
+
+/** Create an instance of a json from the pool of a thread.
+  * When the cached block is empty a new one is taken from the arena. The
+  * index of the next free property never goes beyond the end of the arena,
+  * so the failed refills of an empty arena do not make it wrap around.
+  * @param pool The handler of the pool.
+  * @retval The handler of the new instance if success.
+  * @retval Null pointer if the arena was empty. */
+static json_t* arenaPoolAlloc( jsonPool_t* pool ) {
+    jsonArenaPool_t* apool = json_containerOf( pool, jsonArenaPool_t, pool );
+    if ( apool->next == apool->end ) {
+        jsonArena_t* const arena = apool->arena;
+        unsigned int first, end;
+        do {
+            first = atomicLoad( &arena->nextFree );
+            if ( first >= arena->qty ) return 0;
+            end = arena->qty - first < apool->block ? arena->qty : first + apool->block;
+        } while( !atomicCompareExchange( &arena->nextFree, first, end ) );
+        apool->next = arena->mem + first;
+        apool->end = arena->mem + end;
+    }
+    return apool->next++;
+}
+
+/* Initialize the pool of a thread that allocates from an arena. */
+jsonPool_t* json_arenaPoolInit( jsonArenaPool_t* apool, jsonArena_t* arena, unsigned int block ) {
+    apool->arena = arena;
+    apool->block = block ? block : 64;
+    apool->next = 0;
+    apool->end = 0;
+    apool->pool.init = arenaPoolAlloc;
+    apool->pool.alloc = arenaPoolAlloc;
+    return &apool->pool;
+}
+
+/** Get the pool that keeps statistics from its generic handler. */
+static jsonStatsPool_t* statsPool( jsonPool_t* pool ) {
+    jsonPoolEx_t* const ex = json_containerOf( pool, jsonPoolEx_t, pool );
+    return json_containerOf( ex, jsonStatsPool_t, pool );
+}
+
+/** Recycle all the properties of a pool that keeps statistics.
+  * @param pool The handler of the pool. */
+static void statsPoolReset( jsonPool_t* pool ) {
+    jsonStatsPool_t* const spool = statsPool( pool );
+    spool->used = 0;
+    ++spool->parses;
+}
+
+/** Create an instance of a json from a pool that keeps statistics.
+  * @param pool The handler of the pool.
+  * @retval The handler of the new instance if success.
+  * @retval Null pointer if the pool was empty. */
+static json_t* statsPoolAlloc( jsonPool_t* pool ) {
+    jsonStatsPool_t* const spool = statsPool( pool );
+    if ( spool->used >= spool->qty ) return 0;
+    json_t* const property = spool->mem + spool->used++;
+    if ( spool->peak < spool->used ) spool->peak = spool->used;
+    return property;
+}
+
+/** Count a failed parse in a pool that keeps statistics.
+  * @param pool The handler of the pool. */
+static void statsPoolFailure( jsonPool_t* pool ) {
+    ++statsPool( pool )->failures;
+}
+
+/* Initialize a pool of an array of JSON properties that keeps statistics. */
+jsonPoolEx_t* json_statsPoolInit( jsonStatsPool_t* spool, json_t mem[], unsigned int qty ) {
+    spool->mem = mem;
+    spool->qty = qty;
+    spool->used = 0;
+    spool->peak = 0;
+    spool->parses = 0;
+    spool->failures = 0;
+    spool->pool.pool.init = statsPoolAlloc;
+    spool->pool.pool.alloc = statsPoolAlloc;
+    spool->pool.size = sizeof( jsonPoolEx_t );
+    spool->pool.reset = statsPoolReset;
+    spool->pool.release = 0;
+    spool->pool.onFailure = statsPoolFailure;
+    return &spool->pool;
+}
+
+/* Parse a string to get a shared document with one reference. */
+json_t const* json_docCreate( jsonDoc_t* doc, CHAR_T* str, jsonPool_t* pool,
+                              void (*destroy)( jsonDoc_t* doc ) ) {
+    json_t const* root = json_createWithPool( str, pool );
+    if ( !root ) return 0;
+    doc->root = root;
+    doc->str = str;
+    doc->pool = pool;
+    doc->refs = 1;
+    doc->destroy = destroy;
+    return root;
+}
+
+/* Add a reference to a shared document. */
+void json_docRetain( jsonDoc_t* doc ) {
+    atomicIncrement( &doc->refs );
+}
+
+/* Release a reference to a shared document. */
+void json_docRelease( jsonDoc_t* doc ) {
+    if ( atomicDecrement( &doc->refs ) ) return;
+    if ( doc->destroy ) doc->destroy( doc );
+}
+
+/** Copy the data of a json property but not its links.
+  * @param dst The handler of the copy.
+  * @param src The handler of the original. */
+static void copyProperty( json_t* dst, json_t const* src ) {
+    dst->name = src->name;
+    dst->type = src->type;
+    if ( src->type == JSON_OBJ || src->type == JSON_ARRAY ) {
+        dst->u.c = src->u.c;
+        dst->u.c.child = 0;
+    }
+    else dst->u.value = src->u.value;
+}
+
+/** Copy a json tree in breadth-first order.
+  * While a container waits to get its children copied, its first child points
+  * to its original and its last child to the next container in the queue.
+  * @param json The handler of the original tree.
+  * @param pool The pool for the copy.
+  * @retval The handler of the copy if success.
+  * @retval Null pointer if the pool had not enough properties. */
+static json_t* copyTree( json_t const* json, jsonPool_t* pool ) {
+    json_t* const root = pool->init( pool );
+    if ( !root ) return 0;
+    copyProperty( root, json );
+    root->sibling = 0;
+#ifdef TINY_JSON_USE_PARENT
+    root->parent = 0;
+    root->depth = 0;
+#endif
+    if ( json->type != JSON_OBJ && json->type != JSON_ARRAY ) return root;
+    root->u.c.child = (json_t*)json;
+    root->u.c.last_child = 0;
+    json_t* head = root;
+    json_t* tail = root;
+    while( head ) {
+        json_t* const obj = head;
+        json_t const* const original = obj->u.c.child;
+        head = obj->u.c.last_child;
+        obj->u.c.child = 0;
+        json_t const* child;
+        for( child = original->u.c.child; child; child = child->sibling ) {
+            json_t* const property = pool->alloc( pool );
+            if ( !property ) return 0;
+            copyProperty( property, child );
+            add( obj, property );
+            if ( child->type != JSON_OBJ && child->type != JSON_ARRAY ) continue;
+            property->u.c.child = (json_t*)child;
+            property->u.c.last_child = 0;
+            if ( head ) tail->u.c.last_child = property;
+            else head = property;
+            tail = property;
+        }
+    }
+    return root;
+}
+
+/* Copy a json tree into a pool with the children of each container together. */
+json_t const* json_compact( json_t const* json, jsonPool_t* pool ) {
+    return copyTree( json, pool );
+}
+
+/** Get the number of characters of a string including its null character. */
+static size_t textSize( CHAR_T const* str ) {
+    CHAR_T const* ptr = str;
+    while( *ptr++ );
+    return (size_t)( ptr - str );
+}
+
+/* Get the number of bytes needed to extract a json property. */
+size_t json_extractSize( json_t const* json ) {
+    size_t size = sizeof( json_t );
+    if ( json->name ) size += textSize( json->name ) * sizeof( CHAR_T );
+    if ( json->type != JSON_OBJ && json->type != JSON_ARRAY )
+        return size + textSize( json->u.value ) * sizeof( CHAR_T );
+    json_t const* child;
+    for( child = json->u.c.child; child; child = child->sibling )
+        size += json_extractSize( child );
+    return size;
+}
+
+/** Copy a string to the top of the free memory of a block.
+  * @param str The string to copy.
+  * @param top Pointer to the end of the free memory. It is updated.
+  * @param bottom Pointer to the beginning of the free memory.
+  * @retval The copy if success.
+  * @retval Null pointer if there was not enough memory. */
+static CHAR_T const* extractText( CHAR_T const* str, CHAR_T** top, CHAR_T const* bottom ) {
+    size_t const size = textSize( str );
+    if ( (size_t)( *top - bottom ) < size ) return 0;
+    *top -= size;
+    memcpy( *top, str, size * sizeof( CHAR_T ) );
+    return *top;
+}
+
+/* Copy a json property with all its properties and strings into a block. */
+json_t const* json_extract( json_t const* json, void* out, size_t cap ) {
+    if ( cap < sizeof( json_t ) ) return 0;
+    jsonStaticPool_t spool;
+    spool.mem = out;
+    spool.qty = cap / sizeof( json_t ) < UINT_MAX ? cap / sizeof( json_t ) : UINT_MAX;
+    spool.pool.init = poolInit;
+    spool.pool.alloc = poolAlloc;
+    json_t* const root = copyTree( json, &spool.pool );
+    if ( !root ) return 0;
+    CHAR_T const* const bottom = (CHAR_T const*)( spool.mem + spool.nextFree );
+    CHAR_T* top = (CHAR_T*)out + cap / sizeof( CHAR_T );
+    json_t* property;
+    for( property = spool.mem; property < spool.mem + spool.nextFree; ++property ) {
+        if ( property->name ) {
+            property->name = extractText( property->name, &top, bottom );
+            if ( !property->name ) return 0;
+        }
+        if ( property->type != JSON_OBJ && property->type != JSON_ARRAY ) {
+            property->u.value = extractText( property->u.value, &top, bottom );
+            if ( !property->u.value ) return 0;
+        }
+#ifdef TINY_JSON_USE_SPAN
+        else property->u.c.begin = property->u.c.end = 0;
+#endif
+    }
+    return root;
+}
+
 /** Checks whether an character belongs to set.
   * @param ch Character value to be checked.
   * @param set Set of characters. It is just a null-terminated string.
@@ -469,3 +806,864 @@ static CHAR_T* setToNull( CHAR_T* ch ) {
 static bool isEndOfPrimitive( CHAR_T ch ) {
     return ch == T(',') || isOneOfThem( ch, blank ) || isOneOfThem( ch, endofblock );
 }
+
+#ifndef TINY_JSON_USE_WCHAR
+
+/** Decode a multi-byte UTF-8 sequence.
+  * @param str Pointer to the first byte of the sequence.
+  * @param cp Pointer to store the code point.
+  * @retval Pointer to the first byte after the sequence. If success.
+  * @retval Null pointer if the sequence is truncated, overlong, a surrogate
+  *         or out of the Unicode range. */
+static unsigned char const* utf8Decode( unsigned char const* str, uint32_t* cp ) {
+    unsigned char const lead = *str;
+    unsigned int len;
+    uint32_t min;
+    if      ( ( lead & 0xE0 ) == 0xC0 ) { len = 2; min = 0x80;    *cp = lead & 0x1F; }
+    else if ( ( lead & 0xF0 ) == 0xE0 ) { len = 3; min = 0x800;   *cp = lead & 0x0F; }
+    else if ( ( lead & 0xF8 ) == 0xF0 ) { len = 4; min = 0x10000; *cp = lead & 0x07; }
+    else return 0;
+    unsigned int i;
+    for( i = 1; i < len; ++i ) {
+        if ( ( str[i] & 0xC0 ) != 0x80 ) return 0;
+        *cp = ( *cp << 6 ) | ( str[i] & 0x3F );
+    }
+    if ( *cp < min || *cp > 0x10FFFF ) return 0;
+    if ( *cp >= 0xD800 && *cp <= 0xDFFF ) return 0;
+    return str + len;
+}
+
+/** Transcode a null-terminated UTF-8 string to UTF-16 or UTF-32.
+  * Runs of ASCII characters are widened 16 bytes at a time when SSE2 is available.
+  * @param str The UTF-8 string.
+  * @param out Buffer of 16-bit or 32-bit code units.
+  * @param cap Number of code units of out.
+  * @param utf32 True to produce UTF-32 or false to produce UTF-16.
+  * @retval The number of code units of the string without the null character.
+  * @retval -1 if the string is not valid UTF-8. */
+static int utf8Transcode( char const* str, void* out, unsigned int cap, bool utf32 ) {
+    uint16_t* const out16 = (uint16_t*)out;
+    uint32_t* const out32 = (uint32_t*)out;
+    unsigned char const* src = (unsigned char const*)str;
+    unsigned char const* const end = src + strlen( str );
+    unsigned int const room = cap ? cap - 1 : 0;
+    unsigned int stored = 0;
+    unsigned int n = 0;
+    while( src < end ) {
+#ifdef TINY_JSON_SSE2
+        if ( end - src >= 16 && stored == n && n + 16 <= room ) {
+            __m128i const chunk = _mm_loadu_si128( (__m128i const*)src );
+            if ( !_mm_movemask_epi8( chunk ) ) {
+                __m128i const zero = _mm_setzero_si128();
+                __m128i const lo = _mm_unpacklo_epi8( chunk, zero );
+                __m128i const hi = _mm_unpackhi_epi8( chunk, zero );
+                if ( utf32 ) {
+                    _mm_storeu_si128( (__m128i*)( out32 + n ),      _mm_unpacklo_epi16( lo, zero ) );
+                    _mm_storeu_si128( (__m128i*)( out32 + n + 4 ),  _mm_unpackhi_epi16( lo, zero ) );
+                    _mm_storeu_si128( (__m128i*)( out32 + n + 8 ),  _mm_unpacklo_epi16( hi, zero ) );
+                    _mm_storeu_si128( (__m128i*)( out32 + n + 12 ), _mm_unpackhi_epi16( hi, zero ) );
+                }
+                else {
+                    _mm_storeu_si128( (__m128i*)( out16 + n ),     lo );
+                    _mm_storeu_si128( (__m128i*)( out16 + n + 8 ), hi );
+                }
+                src += 16;
+                n += 16;
+                stored = n;
+                continue;
+            }
+        }
+#endif
+        uint32_t cp = *src;
+        if ( cp < 0x80 ) ++src;
+        else {
+            src = utf8Decode( src, &cp );
+            if ( !src ) return -1;
+        }
+        if ( !utf32 && cp >= 0x10000 ) {
+            if ( stored == n && n + 2 <= room ) {
+                cp -= 0x10000;
+                out16[n]   = (uint16_t)( 0xD800 + ( cp >> 10 ) );
+                out16[n+1] = (uint16_t)( 0xDC00 + ( cp & 0x3FF ) );
+                stored = n + 2;
+            }
+            n += 2;
+            continue;
+        }
+        if ( stored == n && n < room ) {
+            if ( utf32 ) out32[n] = cp;
+            else out16[n] = (uint16_t)cp;
+            stored = n + 1;
+        }
+        ++n;
+    }
+    if ( cap ) {
+        if ( utf32 ) out32[stored] = 0;
+        else out16[stored] = 0;
+    }
+    return (int)n;
+}
+
+/* Get the value of a json property transcoded from UTF-8 to UTF-16. */
+int json_getUtf16( json_t const* property, uint16_t* out, unsigned int cap ) {
+    return utf8Transcode( property->u.value, out, cap, false );
+}
+
+/* Get the value of a json property transcoded from UTF-8 to wchar_t. */
+int json_getWide( json_t const* property, wchar_t* out, unsigned int cap ) {
+    return utf8Transcode( property->u.value, out, cap, sizeof( wchar_t ) > 2 );
+}
+
+/** Values of the characters of the Base64 alphabet, -1 for the rest. */
+static signed char const base64Table[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/** Decode a group of four Base64 characters into three bytes.
+  * @retval true if the four characters belong to the alphabet. */
+static bool base64Quad( unsigned char const* src, unsigned char* out ) {
+    int const a = base64Table[ src[0] ];
+    int const b = base64Table[ src[1] ];
+    int const c = base64Table[ src[2] ];
+    int const d = base64Table[ src[3] ];
+    if ( ( a | b | c | d ) < 0 ) return false;
+    uint32_t const v = (uint32_t)a << 18 | (uint32_t)b << 12 | (uint32_t)c << 6 | (uint32_t)d;
+    out[0] = (unsigned char)( v >> 16 );
+    out[1] = (unsigned char)( v >> 8 );
+    out[2] = (unsigned char)v;
+    return true;
+}
+
+#ifdef TINY_JSON_SSE2
+
+/** Translate 16 Base64 characters to their 6-bit values with range checks.
+  * Bytes above 127 are negative in the signed comparisons and never match.
+  * @param chunk The characters. They are replaced by their values.
+  * @retval true if all the characters belong to the alphabet. */
+static bool base64Values( __m128i* chunk ) {
+    __m128i const c = *chunk;
+    __m128i const upper = _mm_and_si128( _mm_cmpgt_epi8( c, _mm_set1_epi8( 'A' - 1 ) ),
+                                         _mm_cmpgt_epi8( _mm_set1_epi8( 'Z' + 1 ), c ) );
+    __m128i const lower = _mm_and_si128( _mm_cmpgt_epi8( c, _mm_set1_epi8( 'a' - 1 ) ),
+                                         _mm_cmpgt_epi8( _mm_set1_epi8( 'z' + 1 ), c ) );
+    __m128i const digit = _mm_and_si128( _mm_cmpgt_epi8( c, _mm_set1_epi8( '0' - 1 ) ),
+                                         _mm_cmpgt_epi8( _mm_set1_epi8( '9' + 1 ), c ) );
+    __m128i const plus  = _mm_cmpeq_epi8( c, _mm_set1_epi8( '+' ) );
+    __m128i const slash = _mm_cmpeq_epi8( c, _mm_set1_epi8( '/' ) );
+    __m128i const valid = _mm_or_si128( _mm_or_si128( upper, lower ),
+                                        _mm_or_si128( digit, _mm_or_si128( plus, slash ) ) );
+    if ( _mm_movemask_epi8( valid ) != 0xFFFF ) return false;
+    __m128i shift = _mm_and_si128( upper, _mm_set1_epi8( -'A' ) );
+    shift = _mm_or_si128( shift, _mm_and_si128( lower, _mm_set1_epi8( 26 - 'a' ) ) );
+    shift = _mm_or_si128( shift, _mm_and_si128( digit, _mm_set1_epi8( 52 - '0' ) ) );
+    shift = _mm_or_si128( shift, _mm_and_si128( plus,  _mm_set1_epi8( 62 - '+' ) ) );
+    shift = _mm_or_si128( shift, _mm_and_si128( slash, _mm_set1_epi8( 63 - '/' ) ) );
+    *chunk = _mm_add_epi8( c, shift );
+    return true;
+}
+
+/** Merge the four 6-bit values of each 32-bit lane into a 24-bit value. */
+static __m128i base64Merge( __m128i values ) {
+    __m128i const pairs = _mm_or_si128( _mm_slli_epi16( _mm_and_si128( values, _mm_set1_epi16( 0xFF ) ), 6 ),
+                                        _mm_srli_epi16( values, 8 ) );
+    return _mm_or_si128( _mm_slli_epi32( _mm_and_si128( pairs, _mm_set1_epi32( 0xFFFF ) ), 12 ),
+                         _mm_srli_epi32( pairs, 16 ) );
+}
+
+#endif
+
+#ifdef TINY_JSON_AVX2
+
+/** Translate 32 Base64 characters to their 6-bit values as base64Values(). */
+static bool base64Values256( __m256i* chunk ) {
+    __m256i const c = *chunk;
+    __m256i const upper = _mm256_and_si256( _mm256_cmpgt_epi8( c, _mm256_set1_epi8( 'A' - 1 ) ),
+                                            _mm256_cmpgt_epi8( _mm256_set1_epi8( 'Z' + 1 ), c ) );
+    __m256i const lower = _mm256_and_si256( _mm256_cmpgt_epi8( c, _mm256_set1_epi8( 'a' - 1 ) ),
+                                            _mm256_cmpgt_epi8( _mm256_set1_epi8( 'z' + 1 ), c ) );
+    __m256i const digit = _mm256_and_si256( _mm256_cmpgt_epi8( c, _mm256_set1_epi8( '0' - 1 ) ),
+                                            _mm256_cmpgt_epi8( _mm256_set1_epi8( '9' + 1 ), c ) );
+    __m256i const plus  = _mm256_cmpeq_epi8( c, _mm256_set1_epi8( '+' ) );
+    __m256i const slash = _mm256_cmpeq_epi8( c, _mm256_set1_epi8( '/' ) );
+    __m256i const valid = _mm256_or_si256( _mm256_or_si256( upper, lower ),
+                                           _mm256_or_si256( digit, _mm256_or_si256( plus, slash ) ) );
+    if ( _mm256_movemask_epi8( valid ) != -1 ) return false;
+    __m256i shift = _mm256_and_si256( upper, _mm256_set1_epi8( -'A' ) );
+    shift = _mm256_or_si256( shift, _mm256_and_si256( lower, _mm256_set1_epi8( 26 - 'a' ) ) );
+    shift = _mm256_or_si256( shift, _mm256_and_si256( digit, _mm256_set1_epi8( 52 - '0' ) ) );
+    shift = _mm256_or_si256( shift, _mm256_and_si256( plus,  _mm256_set1_epi8( 62 - '+' ) ) );
+    shift = _mm256_or_si256( shift, _mm256_and_si256( slash, _mm256_set1_epi8( 63 - '/' ) ) );
+    *chunk = _mm256_add_epi8( c, shift );
+    return true;
+}
+
+#endif
+
+/** Decode a Base64 string. The padding is optional.
+  * The output can be the input itself: a group of characters is always read
+  * before its bytes are written and the bytes are fewer than the characters.
+  * @param str The Base64 characters.
+  * @param len Number of characters.
+  * @param out Buffer to store the bytes.
+  * @param cap Length of the buffer.
+  * @retval The number of bytes decoded.
+  * @retval -1 if the string is not valid or the buffer is too short. */
+static int base64Decode( char const* str, size_t len, unsigned char* out, size_t cap ) {
+    unsigned char const* const src = (unsigned char const*)str;
+    if ( len && !( len % 4 ) && src[ len - 1 ] == '=' ) {
+        --len;
+        if ( src[ len - 1 ] == '=' ) --len;
+    }
+    size_t const rest = len % 4;
+    if ( rest == 1 ) return -1;
+    size_t const size = len / 4 * 3 + ( rest ? rest - 1 : 0 );
+    if ( size > cap || size > INT_MAX ) return -1;
+    size_t i = 0;
+    size_t o = 0;
+#ifdef TINY_JSON_AVX2
+    while( len - i >= 32 ) {
+        __m256i chunk = _mm256_loadu_si256( (__m256i const*)( src + i ) );
+        if ( !base64Values256( &chunk ) ) break;
+        __m256i const pairs = _mm256_or_si256(
+            _mm256_slli_epi16( _mm256_and_si256( chunk, _mm256_set1_epi16( 0xFF ) ), 6 ),
+            _mm256_srli_epi16( chunk, 8 ) );
+        __m256i const merged = _mm256_or_si256(
+            _mm256_slli_epi32( _mm256_and_si256( pairs, _mm256_set1_epi32( 0xFFFF ) ), 12 ),
+            _mm256_srli_epi32( pairs, 16 ) );
+        __m256i const bytes = _mm256_permutevar8x32_epi32(
+            _mm256_shuffle_epi8( merged, _mm256_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 ) ),
+            _mm256_setr_epi32( 0, 1, 2, 4, 5, 6, 3, 7 ) );
+        if ( o + 32 <= cap ) _mm256_storeu_si256( (__m256i*)( out + o ), bytes );
+        else {
+            unsigned char tmp[32];
+            _mm256_storeu_si256( (__m256i*)tmp, bytes );
+            memcpy( out + o, tmp, 24 );
+        }
+        i += 32;
+        o += 24;
+    }
+#endif
+#ifdef TINY_JSON_SSE2
+    while( len - i >= 16 ) {
+        __m128i chunk = _mm_loadu_si128( (__m128i const*)( src + i ) );
+        if ( !base64Values( &chunk ) ) break;
+        __m128i const merged = base64Merge( chunk );
+#ifdef TINY_JSON_SSSE3
+        __m128i const bytes = _mm_shuffle_epi8( merged, _mm_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 ) );
+#else
+        /* Reverse the three bytes of each lane and close the gaps with shifts. */
+        __m128i const mask = _mm_set1_epi32( 0xFF );
+        __m128i const swapped = _mm_or_si128(
+            _mm_or_si128( _mm_slli_epi32( _mm_and_si128( merged, mask ), 16 ),
+                          _mm_and_si128( merged, _mm_set1_epi32( 0xFF00 ) ) ),
+            _mm_and_si128( _mm_srli_epi32( merged, 16 ), mask ) );
+        __m128i const packed = _mm_or_si128(
+            _mm_and_si128( swapped, _mm_set_epi32( 0, 0xFFFFFF, 0, 0xFFFFFF ) ),
+            _mm_srli_epi64( _mm_andnot_si128( _mm_set_epi32( 0, -1, 0, -1 ), swapped ), 8 ) );
+        __m128i const bytes = _mm_or_si128( _mm_move_epi64( packed ),
+                                            _mm_slli_si128( _mm_srli_si128( packed, 8 ), 6 ) );
+#endif
+        if ( o + 16 <= cap ) _mm_storeu_si128( (__m128i*)( out + o ), bytes );
+        else {
+            unsigned char tmp[16];
+            _mm_storeu_si128( (__m128i*)tmp, bytes );
+            memcpy( out + o, tmp, 12 );
+        }
+        i += 16;
+        o += 12;
+    }
+#endif
+    for( ; len - i >= 4; i += 4, o += 3 )
+        if ( !base64Quad( src + i, out + o ) ) return -1;
+    if ( rest ) {
+        unsigned char quad[4] = { 'A', 'A', 'A', 'A' };
+        unsigned char bytes[3];
+        memcpy( quad, src + i, rest );
+        if ( !base64Quad( quad, bytes ) ) return -1;
+        memcpy( out + o, bytes, rest - 1 );
+    }
+    return (int)size;
+}
+
+/* Get the value of a json property decoded from Base64. */
+int json_getBase64( json_t const* property, void* out, unsigned int cap ) {
+    if ( property->type != JSON_TEXT ) return -1;
+    char const* const value = property->u.value;
+    return base64Decode( value, strlen( value ), (unsigned char*)out, cap );
+}
+
+/** Load eight bytes in the order of the memory. */
+static uint64_t load8( void const* ptr ) {
+    uint64_t word;
+    memcpy( &word, ptr, sizeof word );
+    return word;
+}
+
+/** Eight bytes with the same value. */
+#define bytes8( b ) ( UINT64_C(0x0101010101010101) * (b) )
+
+/** Check with SWAR that eight characters follow a layout of digits and separators.
+  * @param chars The characters.
+  * @param layout The layout with '0' in the positions of the digits.
+  * @retval true if the separators are the same and the rest are decimal digits. */
+static bool swarLayout( char const* chars, char const* layout ) {
+    uint64_t const word = load8( chars );
+    uint64_t const ref = load8( layout );
+    uint64_t const digits = ~( ( ( ref ^ bytes8( '0' ) ) + bytes8( 0x7F ) ) | bytes8( 0x7F ) ) & bytes8( 0x80 );
+    uint64_t const mask = ( digits >> 7 ) * 0xFF;
+    if ( ( word & ~mask ) != ( ref & ~mask ) ) return false;
+    uint64_t const chosen = ( word & mask ) | ( bytes8( '0' ) & ~mask );
+    return ( chosen & bytes8( 0xF0 ) ) == bytes8( 0x30 )
+        && ( ( chosen + bytes8( 0x06 ) ) & bytes8( 0xF0 ) ) == bytes8( 0x30 );
+}
+
+/** Get the value of two decimal digits already validated. */
+static int pairValue( char const* ptr ) {
+    return ( ptr[0] - '0' ) * 10 + ( ptr[1] - '0' );
+}
+
+/** Get the number of days from 1970-01-01 to a date of the Gregorian calendar. */
+static int64_t daysFromCivil( int year, int month, int day ) {
+    year -= month <= 2;
+    int const era = ( year >= 0 ? year : year - 399 ) / 400;
+    int const yoe = year - era * 400;
+    int const doy = ( 153 * ( month + ( month > 2 ? -3 : 9 ) ) + 2 ) / 5 + day - 1;
+    int const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (int64_t)era * 146097 + doe - 719468;
+}
+
+/* Get the value of a json property parsed as an RFC 3339 timestamp. */
+int json_getTimestamp( json_t const* property, int64_t* ns ) {
+    if ( property->type != JSON_TEXT ) return -1;
+    char const* const str = property->u.value;
+    size_t const len = strlen( str );
+    if ( len < 20 ) return -1;
+    char date[19];
+    memcpy( date, str, sizeof date );
+    if ( date[10] == 't' || date[10] == ' ' ) date[10] = 'T';
+    if ( !swarLayout( date,      "0000-00-" ) ) return -1;
+    if ( !swarLayout( date + 8,  "00T00:00" ) ) return -1;
+    if ( !swarLayout( date + 11, "00:00:00" ) ) return -1;
+    int const year   = pairValue( date ) * 100 + pairValue( date + 2 );
+    int const month  = pairValue( date + 5 );
+    int const day    = pairValue( date + 8 );
+    int const hour   = pairValue( date + 11 );
+    int const minute = pairValue( date + 14 );
+    int const second = pairValue( date + 17 );
+    static unsigned char const days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    bool const leap = !( year % 4 ) && ( year % 100 || !( year % 400 ) );
+    if ( month < 1 || month > 12 || day < 1 ) return -1;
+    if ( day > days[ month - 1 ] + ( month == 2 && leap ) ) return -1;
+    if ( hour > 23 || minute > 59 || second > 60 ) return -1;
+    char const* ptr = str + sizeof date;
+    int64_t fraction = 0;
+    if ( *ptr == '.' ) {
+        char const* const first = ++ptr;
+        int scale = 9;
+        for( ; isdigit( (unsigned char)*ptr ); ++ptr )
+            if ( scale ) {
+                fraction = fraction * 10 + ( *ptr - '0' );
+                --scale;
+            }
+        if ( ptr == first ) return -1;
+        for( ; scale; --scale ) fraction *= 10;
+    }
+    int offset = 0;
+    if ( *ptr == 'Z' || *ptr == 'z' ) ++ptr;
+    else if ( *ptr == '+' || *ptr == '-' ) {
+        if ( strlen( ptr ) != 6 ) return -1;
+        char zone[8] = "00:00000";
+        memcpy( zone, ptr + 1, 5 );
+        if ( !swarLayout( zone, "00:00000" ) ) return -1;
+        int const zoneHour = pairValue( zone );
+        int const zoneMinute = pairValue( zone + 3 );
+        if ( zoneHour > 23 || zoneMinute > 59 ) return -1;
+        offset = ( zoneHour * 60 + zoneMinute ) * ( *ptr == '-' ? -60 : 60 );
+        ptr += 6;
+    }
+    else return -1;
+    if ( *ptr ) return -1;
+    int64_t const seconds = daysFromCivil( year, month, day ) * 86400
+                          + hour * 3600 + minute * 60 + second - offset;
+    if ( seconds > INT64_MAX / 1000000000 - 1 || seconds < INT64_MIN / 1000000000 ) return -1;
+    *ns = seconds * 1000000000 + fraction;
+    return 0;
+}
+
+/** Check with SWAR that eight characters are hexadecimal digits and store
+  * their values. A byte x below 128 is between m and n if both 128 + n - x
+  * and x + 128 - m have the high bit set, and no byte carries to the next.
+  * @param chars The characters.
+  * @param nibbles Buffer to store the eight values.
+  * @retval true if all the characters are hexadecimal digits. */
+static bool swarHex( char const* chars, unsigned char* nibbles ) {
+    uint64_t const word = load8( chars );
+    uint64_t const low7 = word & bytes8( 0x7F );
+    uint64_t const lower = low7 | bytes8( 0x20 );
+    uint64_t const digit = ( bytes8( 127 + '9' + 1 ) - low7 ) & ( low7 + bytes8( 127 - '0' + 1 ) );
+    uint64_t const alpha = ( bytes8( 127 + 'f' + 1 ) - lower ) & ( lower + bytes8( 127 - 'a' + 1 ) );
+    if ( ( ( digit | alpha ) & ~word & bytes8( 0x80 ) ) != bytes8( 0x80 ) ) return false;
+    uint64_t const values = ( word & bytes8( 0x0F ) ) + ( ( word >> 6 ) & bytes8( 0x01 ) ) * 9;
+    memcpy( nibbles, &values, sizeof values );
+    return true;
+}
+
+/* Get the value of a json property parsed as a UUID. */
+int json_getUUID( json_t const* property, uint8_t* out ) {
+    if ( property->type != JSON_TEXT ) return -1;
+    char const* const str = property->u.value;
+    if ( strlen( str ) != 36 ) return -1;
+    if ( str[8] != '-' || str[13] != '-' || str[18] != '-' || str[23] != '-' ) return -1;
+    char hex[32];
+    memcpy( hex,      str,      8 );
+    memcpy( hex + 8,  str + 9,  4 );
+    memcpy( hex + 12, str + 14, 4 );
+    memcpy( hex + 16, str + 19, 4 );
+    memcpy( hex + 20, str + 24, 12 );
+    unsigned char nibbles[32];
+    unsigned int i;
+    for( i = 0; i < sizeof hex; i += 8 )
+        if ( !swarHex( hex + i, nibbles + i ) ) return -1;
+    for( i = 0; i < 16; ++i )
+        out[i] = (uint8_t)( nibbles[ 2 * i ] << 4 | nibbles[ 2 * i + 1 ] );
+    return 0;
+}
+
+/** The pairs of decimal digits from "00" to "99". */
+static char const digitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/** Write the decimal digits of an integer, two at a time from the end.
+  * @param value The integer.
+  * @param end Pointer after the last character of the output.
+  * @return Pointer to the first digit. */
+static char* writeDigits( uint64_t value, char* end ) {
+    while( value >= 100 ) {
+        unsigned int const pair = (unsigned int)( value % 100 ) * 2;
+        value /= 100;
+        *--end = digitPairs[ pair + 1 ];
+        *--end = digitPairs[ pair ];
+    }
+    if ( value >= 10 ) {
+        *--end = digitPairs[ value * 2 + 1 ];
+        *--end = digitPairs[ value * 2 ];
+    }
+    else *--end = (char)( '0' + value );
+    return end;
+}
+
+/** Copy a formatted number to the output with its null character.
+  * @retval The number of characters without the null character.
+  * @retval -1 if the output is too short. */
+static int copyFormatted( char const* str, size_t len, char* out, unsigned int cap ) {
+    if ( len >= cap ) return -1;
+    memcpy( out, str, len );
+    out[ len ] = '\0';
+    return (int)len;
+}
+
+/* Format an integer as a JSON number. */
+int json_formatInteger( int64_t value, char* out, unsigned int cap ) {
+    char buffer[24];
+    char* const end = buffer + sizeof buffer;
+    uint64_t const magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    char* begin = writeDigits( magnitude, end );
+    if ( value < 0 ) *--begin = '-';
+    return copyFormatted( begin, (size_t)( end - begin ), out, cap );
+}
+
+/** Floating point number with a 64-bit significand: f * 2^e. */
+typedef struct diyFp_s {
+    uint64_t f;
+    int e;
+} diyFp_t;
+
+/** Multiply two numbers keeping the 64 upper bits of the significand, rounded. */
+static diyFp_t diyMultiply( diyFp_t x, diyFp_t y ) {
+    uint64_t const mask = 0xFFFFFFFFu;
+    uint64_t const a = x.f >> 32, b = x.f & mask, c = y.f >> 32, d = y.f & mask;
+    uint64_t const ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t const mid = ( bd >> 32 ) + ( ad & mask ) + ( bc & mask ) + ( UINT64_C(1) << 31 );
+    diyFp_t const result = { ac + ( ad >> 32 ) + ( bc >> 32 ) + ( mid >> 32 ), x.e + y.e + 64 };
+    return result;
+}
+
+/** Shift a number until the highest bit of its significand is set. */
+static diyFp_t diyNormalize( diyFp_t x ) {
+    while( !( x.f & ( UINT64_C(1) << 63 ) ) ) {
+        x.f <<= 1;
+        --x.e;
+    }
+    return x;
+}
+
+/** Get the normalized power of ten that brings a binary exponent into the
+  * range of the digit generation and its decimal exponent.
+  * @param e Binary exponent of the upper boundary.
+  * @param k Pointer to store the decimal exponent to undo the scaling. */
+static diyFp_t cachedPower( int e, int* k ) {
+    static struct { uint64_t f; int e; } const powers[] = {
+    { UINT64_C(0xFA8FD5A0081C0288), -1220 }, { UINT64_C(0xBAAEE17FA23EBF76), -1193 },
+    { UINT64_C(0x8B16FB203055AC76), -1166 }, { UINT64_C(0xCF42894A5DCE35EA), -1140 },
+    { UINT64_C(0x9A6BB0AA55653B2D), -1113 }, { UINT64_C(0xE61ACF033D1A45DF), -1087 },
+    { UINT64_C(0xAB70FE17C79AC6CA), -1060 }, { UINT64_C(0xFF77B1FCBEBCDC4F), -1034 },
+    { UINT64_C(0xBE5691EF416BD60C), -1007 }, { UINT64_C(0x8DD01FAD907FFC3C),  -980 },
+    { UINT64_C(0xD3515C2831559A83),  -954 }, { UINT64_C(0x9D71AC8FADA6C9B5),  -927 },
+    { UINT64_C(0xEA9C227723EE8BCB),  -901 }, { UINT64_C(0xAECC49914078536D),  -874 },
+    { UINT64_C(0x823C12795DB6CE57),  -847 }, { UINT64_C(0xC21094364DFB5637),  -821 },
+    { UINT64_C(0x9096EA6F3848984F),  -794 }, { UINT64_C(0xD77485CB25823AC7),  -768 },
+    { UINT64_C(0xA086CFCD97BF97F4),  -741 }, { UINT64_C(0xEF340A98172AACE5),  -715 },
+    { UINT64_C(0xB23867FB2A35B28E),  -688 }, { UINT64_C(0x84C8D4DFD2C63F3B),  -661 },
+    { UINT64_C(0xC5DD44271AD3CDBA),  -635 }, { UINT64_C(0x936B9FCEBB25C996),  -608 },
+    { UINT64_C(0xDBAC6C247D62A584),  -582 }, { UINT64_C(0xA3AB66580D5FDAF6),  -555 },
+    { UINT64_C(0xF3E2F893DEC3F126),  -529 }, { UINT64_C(0xB5B5ADA8AAFF80B8),  -502 },
+    { UINT64_C(0x87625F056C7C4A8B),  -475 }, { UINT64_C(0xC9BCFF6034C13053),  -449 },
+    { UINT64_C(0x964E858C91BA2655),  -422 }, { UINT64_C(0xDFF9772470297EBD),  -396 },
+    { UINT64_C(0xA6DFBD9FB8E5B88F),  -369 }, { UINT64_C(0xF8A95FCF88747D94),  -343 },
+    { UINT64_C(0xB94470938FA89BCF),  -316 }, { UINT64_C(0x8A08F0F8BF0F156B),  -289 },
+    { UINT64_C(0xCDB02555653131B6),  -263 }, { UINT64_C(0x993FE2C6D07B7FAC),  -236 },
+    { UINT64_C(0xE45C10C42A2B3B06),  -210 }, { UINT64_C(0xAA242499697392D3),  -183 },
+    { UINT64_C(0xFD87B5F28300CA0E),  -157 }, { UINT64_C(0xBCE5086492111AEB),  -130 },
+    { UINT64_C(0x8CBCCC096F5088CC),  -103 }, { UINT64_C(0xD1B71758E219652C),   -77 },
+    { UINT64_C(0x9C40000000000000),   -50 }, { UINT64_C(0xE8D4A51000000000),   -24 },
+    { UINT64_C(0xAD78EBC5AC620000),     3 }, { UINT64_C(0x813F3978F8940984),    30 },
+    { UINT64_C(0xC097CE7BC90715B3),    56 }, { UINT64_C(0x8F7E32CE7BEA5C70),    83 },
+    { UINT64_C(0xD5D238A4ABE98068),   109 }, { UINT64_C(0x9F4F2726179A2245),   136 },
+    { UINT64_C(0xED63A231D4C4FB27),   162 }, { UINT64_C(0xB0DE65388CC8ADA8),   189 },
+    { UINT64_C(0x83C7088E1AAB65DB),   216 }, { UINT64_C(0xC45D1DF942711D9A),   242 },
+    { UINT64_C(0x924D692CA61BE758),   269 }, { UINT64_C(0xDA01EE641A708DEA),   295 },
+    { UINT64_C(0xA26DA3999AEF774A),   322 }, { UINT64_C(0xF209787BB47D6B85),   348 },
+    { UINT64_C(0xB454E4A179DD1877),   375 }, { UINT64_C(0x865B86925B9BC5C2),   402 },
+    { UINT64_C(0xC83553C5C8965D3D),   428 }, { UINT64_C(0x952AB45CFA97A0B3),   455 },
+    { UINT64_C(0xDE469FBD99A05FE3),   481 }, { UINT64_C(0xA59BC234DB398C25),   508 },
+    { UINT64_C(0xF6C69A72A3989F5C),   534 }, { UINT64_C(0xB7DCBF5354E9BECE),   561 },
+    { UINT64_C(0x88FCF317F22241E2),   588 }, { UINT64_C(0xCC20CE9BD35C78A5),   614 },
+    { UINT64_C(0x98165AF37B2153DF),   641 }, { UINT64_C(0xE2A0B5DC971F303A),   667 },
+    { UINT64_C(0xA8D9D1535CE3B396),   694 }, { UINT64_C(0xFB9B7CD9A4A7443C),   720 },
+    { UINT64_C(0xBB764C4CA7A44410),   747 }, { UINT64_C(0x8BAB8EEFB6409C1A),   774 },
+    { UINT64_C(0xD01FEF10A657842C),   800 }, { UINT64_C(0x9B10A4E5E9913129),   827 },
+    { UINT64_C(0xE7109BFBA19C0C9D),   853 }, { UINT64_C(0xAC2820D9623BF429),   880 },
+    { UINT64_C(0x80444B5E7AA7CF85),   907 }, { UINT64_C(0xBF21E44003ACDD2D),   933 },
+    { UINT64_C(0x8E679C2F5E44FF8F),   960 }, { UINT64_C(0xD433179D9C8CB841),   986 },
+    { UINT64_C(0x9E19DB92B4E31BA9),  1013 }, { UINT64_C(0xEB96BF6EBADF77D9),  1039 },
+    { UINT64_C(0xAF87023B9BF0EE6B),  1066 }
+    };
+    double const dk = ( -61 - e ) * 0.30102999566398114 + 347;
+    int decimal = (int)dk;
+    if ( dk - decimal > 0.0 ) ++decimal;
+    unsigned int const index = (unsigned int)( ( decimal >> 3 ) + 1 );
+    *k = -( -348 + (int)( index << 3 ) );
+    diyFp_t const power = { powers[ index ].f, powers[ index ].e };
+    return power;
+}
+
+/** Move the last digit towards the exact value while it stays within the
+  * rounding interval. */
+static void grisuRound( char* digits, int len, uint64_t delta, uint64_t rest,
+                        uint64_t tenKappa, uint64_t distance ) {
+    while( rest < distance && delta - rest >= tenKappa
+           && ( rest + tenKappa < distance || distance - rest > rest + tenKappa - distance ) ) {
+        --digits[ len - 1 ];
+        rest += tenKappa;
+    }
+}
+
+/** Generate the digits of the upper boundary until they are within delta.
+  * @param w The scaled value.
+  * @param upper The scaled upper boundary.
+  * @param delta Width of the rounding interval.
+  * @param digits Buffer to store the digits.
+  * @param k Decimal exponent. The position of the last digit is added.
+  * @return The number of digits. */
+static int digitGen( diyFp_t w, diyFp_t upper, uint64_t delta, char* digits, int* k ) {
+    static uint32_t const pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000,
+                                      10000000, 100000000, 1000000000 };
+    int const shift = -upper.e;
+    uint64_t const one = UINT64_C(1) << shift;
+    uint64_t const distance = upper.f - w.f;
+    uint32_t integral = (uint32_t)( upper.f >> shift );
+    uint64_t fraction = upper.f & ( one - 1 );
+    int kappa = 10;
+    while( kappa > 1 && integral < pow10[ kappa - 1 ] ) --kappa;
+    int len = 0;
+    while( kappa > 0 ) {
+        uint32_t const digit = integral / pow10[ kappa - 1 ];
+        integral %= pow10[ kappa - 1 ];
+        if ( digit || len ) digits[ len++ ] = (char)( '0' + digit );
+        --kappa;
+        uint64_t const rest = ( (uint64_t)integral << shift ) + fraction;
+        if ( rest <= delta ) {
+            *k += kappa;
+            grisuRound( digits, len, delta, rest, (uint64_t)pow10[ kappa ] << shift, distance );
+            return len;
+        }
+    }
+    uint64_t scaled = distance;
+    for( ;; ) {
+        fraction *= 10;
+        delta *= 10;
+        scaled *= 10;
+        char const digit = (char)( fraction >> shift );
+        if ( digit || len ) digits[ len++ ] = (char)( '0' + digit );
+        fraction &= one - 1;
+        --kappa;
+        if ( fraction < delta ) {
+            *k += kappa;
+            grisuRound( digits, len, delta, fraction, one, -kappa < 20 ? scaled : 0 );
+            return len;
+        }
+    }
+}
+
+/** Get the shortest digits that read back as a positive finite double, with
+  * the Grisu2 algorithm of Florian Loitsch.
+  * @param value The number.
+  * @param digits Buffer of at least 18 characters to store the digits.
+  * @param k Pointer to store the decimal exponent of the last digit.
+  * @return The number of digits. */
+static int grisu2( double value, char* digits, int* k ) {
+    uint64_t bits;
+    memcpy( &bits, &value, sizeof bits );
+    uint64_t const hidden = UINT64_C(1) << 52;
+    int const biased = (int)( bits >> 52 & 0x7FF );
+    diyFp_t v;
+    v.f = bits & ( hidden - 1 );
+    if ( biased ) {
+        v.f += hidden;
+        v.e = biased - 1075;
+    }
+    else v.e = -1074;
+    diyFp_t upper = { ( v.f << 1 ) + 1, v.e - 1 };
+    while( !( upper.f & ( hidden << 1 ) ) ) {
+        upper.f <<= 1;
+        --upper.e;
+    }
+    upper.f <<= 64 - 52 - 2;
+    upper.e -= 64 - 52 - 2;
+    diyFp_t lower = v.f == hidden ? (diyFp_t){ ( v.f << 2 ) - 1, v.e - 2 }
+                                  : (diyFp_t){ ( v.f << 1 ) - 1, v.e - 1 };
+    lower.f <<= lower.e - upper.e;
+    lower.e = upper.e;
+    diyFp_t const power = cachedPower( upper.e, k );
+    diyFp_t const w = diyMultiply( diyNormalize( v ), power );
+    diyFp_t high = diyMultiply( upper, power );
+    diyFp_t low = diyMultiply( lower, power );
+    ++low.f;
+    --high.f;
+    return digitGen( w, high, high.f - low.f, digits, k );
+}
+
+/* Format a double as the shortest JSON number that reads back the same. */
+int json_formatReal( double value, char* out, unsigned int cap ) {
+    uint64_t bits;
+    memcpy( &bits, &value, sizeof bits );
+    if ( ( bits >> 52 & 0x7FF ) == 0x7FF ) return -1;
+    char buffer[32];
+    char* ptr = buffer;
+    if ( bits >> 63 ) *ptr++ = '-';
+    if ( !( bits << 1 ) ) {
+        memcpy( ptr, "0.0", 3 );
+        return copyFormatted( buffer, (size_t)( ptr + 3 - buffer ), out, cap );
+    }
+    int k;
+    int const len = grisu2( value < 0 ? -value : value, ptr, &k );
+    int const point = len + k;
+    if ( 0 <= k && point <= 21 ) {
+        memset( ptr + len, '0', (size_t)k );
+        memcpy( ptr + point, ".0", 2 );
+        ptr += point + 2;
+    }
+    else if ( 0 < point && point <= 21 ) {
+        memmove( ptr + point + 1, ptr + point, (size_t)( len - point ) );
+        ptr[ point ] = '.';
+        ptr += len + 1;
+    }
+    else if ( -6 < point && point <= 0 ) {
+        int const offset = 2 - point;
+        memmove( ptr + offset, ptr, (size_t)len );
+        memcpy( ptr, "0.", 2 );
+        memset( ptr + 2, '0', (size_t)( offset - 2 ) );
+        ptr += len + offset;
+    }
+    else {
+        if ( len > 1 ) {
+            memmove( ptr + 2, ptr + 1, (size_t)( len - 1 ) );
+            ptr[1] = '.';
+            ptr += len + 1;
+        }
+        else ++ptr;
+        *ptr++ = 'e';
+        int exponent = point - 1;
+        if ( exponent < 0 ) {
+            *ptr++ = '-';
+            exponent = -exponent;
+        }
+        char* const end = ptr + 3;
+        char* const begin = writeDigits( (uint64_t)exponent, end );
+        memmove( ptr, begin, (size_t)( end - begin ) );
+        ptr += end - begin;
+    }
+    return copyFormatted( buffer, (size_t)( ptr - buffer ), out, cap );
+}
+
+/** Check that there are only blanks before a structural character.
+  * @param ptr Pointer to the first character to check.
+  * @param next Pointer to the structural character.
+  * @return true or false if there are only blanks or not. */
+static bool isBlankUntil( char const* ptr, char const* next ) {
+    for( ; ptr < next; ++ptr )
+        if ( !isOneOfThem( *ptr, blank ) )
+            return false;
+    return true;
+}
+
+/** Terminate a string whose closing quotation mark is known from the index.
+  * A string without escape characters is terminated without scanning it.
+  * @param open Pointer to the opening quotation mark.
+  * @param close Pointer to the closing quotation mark.
+  * @return true or false if the string is valid or not. */
+static bool indexedString( char* open, char* close ) {
+    if ( *close != '\"' ) return false;
+    if ( !memchr( open + 1, '\\', (size_t)( close - open - 1 ) ) ) {
+        *close = '\0';
+        return true;
+    }
+    return parseString( open + 1 ) == close + 1;
+}
+
+/** Parse a primitive value that ends before a structural character.
+  * @param ptr Pointer to the first character of the value.
+  * @param next Pointer to the structural character.
+  * @param property Property handler to set the value and the type.
+  * @retval Pointer to the first character after the value. If success.
+  * @retval Null pointer if any error occur. */
+static char* indexedPrimitive( char* ptr, char* next, json_t* property ) {
+    property->u.value = ptr;
+    switch( *ptr ) {
+        case 't': ptr = trueValue( ptr, property );  break;
+        case 'f': ptr = falseValue( ptr, property ); break;
+        case 'n': ptr = nullValue( ptr, property );  break;
+        default:  ptr = numValue( ptr, property );   break;
+    }
+    if ( !ptr ) return 0;
+    return ptr == next + 1 ? next : ptr;
+}
+
+/* Parse a string with its structural index to get a json. */
+json_t const* json_createWithIndex( char* str, size_t const* index, size_t qty, jsonPool_t* pool ) {
+    if ( !qty || !isBlankUntil( str, str + index[0] ) ) return 0;
+    char* ptr = str + index[0];
+    if ( *ptr != '{' && *ptr != '[' ) return 0;
+    json_t* obj = pool->init( pool );
+    if ( !obj ) return 0;
+    obj->name    = 0;
+    obj->sibling = 0;
+    obj->u.c.child = 0;
+#ifdef TINY_JSON_USE_PARENT
+    obj->parent = 0;
+    obj->depth = 0;
+#endif
+    obj->type = *ptr == '{' ? JSON_OBJ : JSON_ARRAY;
+    unsigned int count = 0;
+    openSpan( obj, ptr, count );
+    size_t i = 1;
+    for( ++ptr;; ) {
+        if ( i >= qty ) return 0;
+        char* next = str + index[i];
+        if ( !isBlankUntil( ptr, next ) ) {
+            /* Only primitive values of an array can be out of the index. */
+            if ( obj->type != JSON_ARRAY ) return 0;
+            json_t* property = pool->alloc( pool );
+            if ( !property ) return 0;
+            ++count;
+            property->name = 0;
+            add( obj, property );
+            ptr = indexedPrimitive( goBlank( ptr ), next, property );
+            if ( !ptr ) return 0;
+            continue;
+        }
+        /* A primitive value can have replaced a comma with a null character. */
+        char ch = *next ? *next : ',';
+        ptr = next + 1;
+        ++i;
+        if ( ch == ',' ) continue;
+        if ( ch == ( obj->type == JSON_OBJ ? '}' : ']' ) ) {
+            closeSpan( obj, next, count );
+            *next = '\0';
+            json_t* parentObj = obj->sibling;
+            if ( !parentObj ) return obj;
+            obj->sibling = 0;
+            obj = parentObj;
+            continue;
+        }
+        json_t* property = pool->alloc( pool );
+        if ( !property ) return 0;
+        ++count;
+        if ( obj->type == JSON_OBJ ) {
+            if ( ch != '\"' || i + 2 > qty ) return 0;
+            char* const close = str + index[i];
+            char* const colon = str + index[i+1];
+            if ( !indexedString( next, close ) ) return 0;
+            if ( *colon != ':' || !isBlankUntil( close + 1, colon ) ) return 0;
+            property->name = next + 1;
+            add( obj, property );
+            i += 2;
+            if ( i >= qty ) return 0;
+            next = str + index[i];
+            if ( !isBlankUntil( colon + 1, next ) ) {
+                ptr = indexedPrimitive( goBlank( colon + 1 ), next, property );
+                if ( !ptr ) return 0;
+                continue;
+            }
+            ch = *next;
+            ptr = next + 1;
+            ++i;
+        }
+        else {
+            property->name = 0;
+            add( obj, property );
+        }
+        switch( ch ) {
+            case '{':
+            case '[':
+                property->type    = ch == '{' ? JSON_OBJ : JSON_ARRAY;
+                property->u.c.child = 0;
+                openSpan( property, next, count );
+                property->sibling = obj;
+                obj = property;
+                break;
+            case '\"':
+                if ( i >= qty ) return 0;
+                ptr = str + index[i++];
+                if ( !indexedString( next, ptr ) ) return 0;
+                property->u.value = next + 1;
+                property->type = JSON_TEXT;
+                ++ptr;
+                break;
+            default:
+                return 0;
+        }
+    }
+}
+
+#endif
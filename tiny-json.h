@@ -30,14 +30,6 @@
 #ifndef _TINY_JSON_H_
 #define	_TINY_JSON_H_
 
-#ifdef TINY_JSON_USE_WCHAR
-typedef wchar_t CHAR_T;
-#define T(str) L##str
-#else
-typedef char CHAR_T;
-#define T(str) str
-#endif
-
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -59,6 +51,94 @@ typedef enum {
     JSON_INTEGER, JSON_REAL, JSON_NULL
 } jsonType_t;
 
+/** @ } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* _TINY_JSON_H_ */
+
+/* The rest of this header declares the API for one character width. It is
+ * read once for the narrow API and, through tiny-jsonw.h, once more for the
+ * wide API whose types and functions have a W suffix: jsonW_t, json_createW(),
+ * json_getPropertyW()... Both can be used in the same translation unit. */
+#if defined(TINY_JSON_WIDE_NAMES) && !defined(_TINY_JSON_WIDE_API_)
+#define _TINY_JSON_WIDE_API_
+#define TINY_JSON_API_BODY
+#elif !defined(TINY_JSON_WIDE_NAMES) && !defined(_TINY_JSON_API_)
+#define _TINY_JSON_API_
+#define TINY_JSON_API_BODY
+#endif
+
+#ifdef TINY_JSON_API_BODY
+#undef TINY_JSON_API_BODY
+
+#ifdef TINY_JSON_USE_WCHAR
+#include <wchar.h>
+#endif
+
+#if defined(TINY_JSON_WIDE_NAMES)
+#define CHAR_T wchar_t
+#define json_s                 jsonW_s
+#define json_t                 jsonW_t
+#define jsonPool_s             jsonPoolW_s
+#define jsonPool_t             jsonPoolW_t
+#define json_create            json_createW
+#define json_createWithPool    json_createWithPoolW
+#define json_getName           json_getNameW
+#define json_getValue          json_getValueW
+#define json_getType           json_getTypeW
+#define json_getSibling        json_getSiblingW
+#define json_getProperty       json_getPropertyW
+#define json_getPropertyValue  json_getPropertyValueW
+#define json_getChild          json_getChildW
+#define json_getBoolean        json_getBooleanW
+#define json_getInteger        json_getIntegerW
+#define json_getReal           json_getRealW
+#define jsonArena_s            jsonArenaW_s
+#define jsonArena_t            jsonArenaW_t
+#define jsonArenaPool_s        jsonArenaPoolW_s
+#define jsonArenaPool_t        jsonArenaPoolW_t
+#define json_arenaInit         json_arenaInitW
+#define json_arenaReset        json_arenaResetW
+#define json_arenaUsed         json_arenaUsedW
+#define json_arenaPoolInit     json_arenaPoolInitW
+#define jsonDoc_s              jsonDocW_s
+#define jsonDoc_t              jsonDocW_t
+#define json_docCreate         json_docCreateW
+#define json_docRoot           json_docRootW
+#define json_docRetain         json_docRetainW
+#define json_docRelease        json_docReleaseW
+#define json_getParent         json_getParentW
+#define json_getDepth          json_getDepthW
+#define json_getSpan           json_getSpanW
+#define json_getDescendants    json_getDescendantsW
+#define json_compact           json_compactW
+#define json_extractSize       json_extractSizeW
+#define json_extract           json_extractW
+#define jsonPoolEx_s           jsonPoolExW_s
+#define jsonPoolEx_t           jsonPoolExW_t
+#define json_createWithPoolEx  json_createWithPoolExW
+#define json_poolRelease       json_poolReleaseW
+#define jsonStatsPool_s        jsonStatsPoolW_s
+#define jsonStatsPool_t        jsonStatsPoolW_t
+#define json_statsPoolInit     json_statsPoolInitW
+#elif defined(TINY_JSON_USE_WCHAR)
+typedef wchar_t CHAR_T;
+#define T(str) L##str
+#else
+typedef char CHAR_T;
+#define T(str) str
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup tinyJson
+  * @{ */
+
 /** Structure to handle JSON properties. */
 typedef struct json_s {
     struct json_s* sibling;
@@ -68,9 +148,18 @@ typedef struct json_s {
         struct {
             struct json_s* child;
             struct json_s* last_child;
+#ifdef TINY_JSON_USE_SPAN
+            CHAR_T const* begin;
+            CHAR_T const* end;
+            unsigned int descendants;
+#endif
         } c;
     } u;
     jsonType_t type;
+#ifdef TINY_JSON_USE_PARENT
+    unsigned int depth;
+    struct json_s* parent;
+#endif
 } json_t;
 
 /** Parse a string to get a json.
@@ -137,11 +226,62 @@ static inline json_t const* json_getChild( json_t const* json ) {
     return json->u.c.child;
 }
 
+#ifdef TINY_JSON_USE_PARENT
+
+/** Get the JSON object or array that contains a json property.
+  * Only available if TINY_JSON_USE_PARENT is defined.
+  * @param json A valid handler of a json property.
+  * @retval The handler of the parent if there is.
+  * @retval Null pointer if the json property is the root. */
+static inline json_t const* json_getParent( json_t const* json ) {
+    return json->parent;
+}
+
+/** Get the nesting level of a json property.
+  * Only available if TINY_JSON_USE_PARENT is defined.
+  * @param json A valid handler of a json property.
+  * @return Zero for the root, one for its children and so on. */
+static inline unsigned int json_getDepth( json_t const* json ) {
+    return json->depth;
+}
+
+#endif
+
+#ifdef TINY_JSON_USE_SPAN
+
+/** Get the text of a JSON object or array.
+  * Only available if TINY_JSON_USE_SPAN is defined. The parser modifies the
+  * text in place, so to forward a sub-document verbatim keep a copy of the
+  * original string: the span starts in it at the returned pointer minus the
+  * string that was parsed.
+  * @param json A valid handler of a json property.
+  *             Its type must be JSON_OBJ or JSON_ARRAY.
+  * @param length Pointer to store the number of characters of the text.
+  * @return Pointer to the first character, '{' or '['. */
+static inline CHAR_T const* json_getSpan( json_t const* json, size_t* length ) {
+    *length = (size_t)( json->u.c.end - json->u.c.begin );
+    return json->u.c.begin;
+}
+
+/** Get the number of properties nested in a JSON object or array at any depth.
+  * Only available if TINY_JSON_USE_SPAN is defined. If the pool allocates
+  * consecutive properties, as json_create() does, they are the ones that
+  * follow it in memory, so the property after its subtree in node order is
+  * json + json_getDescendants( json ) + 1.
+  * @param json A valid handler of a json property.
+  *             Its type must be JSON_OBJ or JSON_ARRAY.
+  * @return The number of properties. */
+static inline unsigned int json_getDescendants( json_t const* json ) {
+    return json->u.c.descendants;
+}
+
+#endif
+
 /** Get the value of a json boolean property.
   * @param property A valid handler of a json object. Its type must be JSON_BOOLEAN.
   * @return The value stdbool. */
 static inline bool json_getBoolean( json_t const* property ) {
-    return *property->u.value == T('t');
+    return *property->u.value == 't';
 }
 
 /** Get the value of a json integer property.
@@ -166,6 +306,88 @@ static inline double json_getReal( json_t const* property ) {
 #endif
 }
 
+#ifndef TINY_JSON_USE_WCHAR
+
+/** Get the value of a json property transcoded from UTF-8 to UTF-16.
+  * Only the values that are requested are transcoded, the input buffer is
+  * not modified. If cap is not zero the output is always null-terminated.
+  * @param property A valid handler of a json property.
+  *                 Its type cannot be JSON_OBJ or JSON_ARRAY.
+  * @param out Buffer to store the UTF-16 code units.
+  * @param cap Number of code units of out.
+  * @retval The number of code units of the value without the null character.
+  *         If it is greater than or equal to cap the output was truncated.
+  * @retval -1 if the value is not a valid UTF-8 sequence. */
+int json_getUtf16( json_t const* property, uint16_t* out, unsigned int cap );
+
+/** Get the value of a json property transcoded from UTF-8 to wchar_t.
+  * The encoding is UTF-16 when wchar_t is 16 bits wide and UTF-32 otherwise.
+  * @param property A valid handler of a json property.
+  *                 Its type cannot be JSON_OBJ or JSON_ARRAY.
+  * @param out Buffer to store the wide characters.
+  * @param cap Number of wide characters of out.
+  * @retval The number of wide characters of the value without the null character.
+  *         If it is greater than or equal to cap the output was truncated.
+  * @retval -1 if the value is not a valid UTF-8 sequence. */
+int json_getWide( json_t const* property, wchar_t* out, unsigned int cap );
+
+/** Get the value of a json property decoded from Base64.
+  * The standard alphabet is used and the padding is optional. The value can
+  * be decoded in place by passing it as the output, cast to a non-constant
+  * pointer, if the text given to the parser can be modified.
+  * @param property A valid handler of a json property. Its type must be JSON_TEXT.
+  * @param out Buffer to store the bytes. Three quarters of the length of the
+  *            value are always enough.
+  * @param cap Length of the buffer in bytes.
+  * @retval The number of bytes decoded.
+  * @retval -1 if the value is not a valid Base64 text or the buffer is too short. */
+int json_getBase64( json_t const* property, void* out, unsigned int cap );
+
+/** Get the value of a json property parsed as an RFC 3339 timestamp,
+  * f.i. "2024-02-29T13:45:00.123456Z" or "2024-02-29T15:45:00+02:00".
+  * The fraction of second is truncated to nanoseconds.
+  * @param property A valid handler of a json property. Its type must be JSON_TEXT.
+  * @param ns Pointer to store the nanoseconds since 1970-01-01T00:00:00Z.
+  * @retval 0 if success.
+  * @retval -1 if the value is not a valid timestamp or it is out of the range
+  *         of int64_t, from the year 1677 to 2262. */
+int json_getTimestamp( json_t const* property, int64_t* ns );
+
+/** Get the value of a json property parsed as a UUID in its canonical form,
+  * f.i. "123e4567-e89b-12d3-a456-426614174000". Lowercase and uppercase
+  * hexadecimal digits are accepted.
+  * @param property A valid handler of a json property. Its type must be JSON_TEXT.
+  * @param out Buffer of 16 bytes to store the UUID in the order of the text.
+  * @retval 0 if success.
+  * @retval -1 if the value is not a valid UUID. */
+int json_getUUID( json_t const* property, uint8_t* out );
+
+/** Format an integer as a JSON number.
+  * @param value The integer.
+  * @param out Buffer to store the text with a null character. 21 characters
+  *            are always enough.
+  * @param cap Length of the buffer.
+  * @retval The number of characters without the null character.
+  * @retval -1 if the buffer is too short. */
+int json_formatInteger( int64_t value, char* out, unsigned int cap );
+
+/** Format a double as a JSON number with the fewest digits that read back as
+  * the same value with strtod(). The digits are generated with Grisu2, which
+  * finds the shortest ones for all but a tiny fraction of the values and
+  * always round-trips. Integral values keep ".0" so they are parsed as
+  * JSON_REAL again. The numbers of a parsed tree that were not modified do
+  * not need to be formatted again: the text of json_getValue() was already
+  * validated by the parser and can be copied to the output.
+  * @param value The number.
+  * @param out Buffer to store the text with a null character. 32 characters
+  *            are always enough.
+  * @param cap Length of the buffer.
+  * @retval The number of characters without the null character.
+  * @retval -1 if the buffer is too short or the value is infinite or NaN. */
+int json_formatReal( double value, char* out, unsigned int cap );
+
+#endif
+
 /** Structure to handle a heap of JSON properties. */
 typedef struct jsonPool_s jsonPool_t;
 struct jsonPool_s {
@@ -181,10 +403,242 @@ struct jsonPool_s {
   *         This property is always unnamed and its type is JSON_OBJ. */
 json_t const* json_createWithPool( CHAR_T* str, jsonPool_t* pool );
 
+/** Structure to handle a heap of JSON properties with lifecycle callbacks.
+  * The callbacks that are null pointers are not called. The field size must be
+  * sizeof( jsonPoolEx_t ) so that callbacks added at the end by later versions
+  * of the library are not read from the structures of older programs. */
+typedef struct jsonPoolEx_s jsonPoolEx_t;
+struct jsonPoolEx_s {
+    jsonPool_t pool;                       /**< The init and alloc callbacks.  */
+    size_t size;                           /**< sizeof( jsonPoolEx_t ).        */
+    void (*reset)( jsonPool_t* pool );     /**< Before each parse, to recycle the properties of the previous one. */
+    void (*release)( jsonPool_t* pool );   /**< Called by json_poolRelease().  */
+    void (*onFailure)( jsonPool_t* pool ); /**< After a parse that failed.     */
+};
+
+/** Parse a string to get a json with a pool that is reused for each document.
+  * The previous tree parsed with the pool must not be used any more.
+  * @param str String pointer with a JSON object. It will be modified.
+  * @param pool Custom json pool pointer with lifecycle callbacks.
+  * @retval Null pointer if any was wrong in the parse process.
+  * @retval If the parser process was successfully a valid handler of a json. */
+json_t const* json_createWithPoolEx( CHAR_T* str, jsonPoolEx_t* pool );
+
+/** Release the resources of a pool with lifecycle callbacks.
+  * @param pool Custom json pool pointer with lifecycle callbacks. */
+void json_poolRelease( jsonPoolEx_t* pool );
+
+/** Structure to handle a pool of an array of JSON properties that keeps the
+  * statistics of its use. */
+typedef struct jsonStatsPool_s {
+    json_t* mem;            /**< Pointer to array of json properties.         */
+    unsigned int qty;       /**< Length of the array of json properties.      */
+    unsigned int used;      /**< Properties used by the last document.        */
+    unsigned int peak;      /**< Maximum properties used by a document.       */
+    unsigned long parses;   /**< Number of documents parsed.                  */
+    unsigned long failures; /**< Number of documents that could not be parsed.*/
+    jsonPoolEx_t pool;
+} jsonStatsPool_t;
+
+/** Initialize a pool of an array of JSON properties that keeps statistics.
+  * @param spool The handler of the pool.
+  * @param mem Pointer to an array of json properties.
+  * @param qty Number of elements of the array.
+  * @return The pool to pass to json_createWithPoolEx(). */
+jsonPoolEx_t* json_statsPoolInit( jsonStatsPool_t* spool, json_t mem[], unsigned int qty );
+
+/** Structure to handle a region of JSON properties shared by several threads.
+  * Blocks of properties are taken from it with an atomic increment, so many
+  * threads can parse different documents into the same arena. */
+typedef struct jsonArena_s {
+    json_t* mem;           /**< Pointer to array of json properties.       */
+    unsigned int qty;      /**< Length of the array of json properties.    */
+    unsigned int nextFree; /**< The index of the next free json property.  */
+} jsonArena_t;
+
+/** Structure to handle the pool of a thread that allocates from an arena.
+  * It keeps a block of properties taken from the arena to avoid contention. */
+typedef struct jsonArenaPool_s {
+    jsonArena_t* arena;    /**< The shared arena.                          */
+    unsigned int block;    /**< Number of properties taken at a time.      */
+    json_t* next;          /**< The next free property of the block.       */
+    json_t* end;           /**< End of the block.                          */
+    jsonPool_t pool;
+} jsonArenaPool_t;
+
+/** Initialize an arena of json properties.
+  * @param arena The handler of the arena.
+  * @param mem Array of json properties to allocate.
+  * @param qty Number of elements of mem. */
+void json_arenaInit( jsonArena_t* arena, json_t mem[], unsigned int qty );
+
+/** Free all the json properties of an arena at once.
+  * It must not be called while a thread is parsing into the arena and the
+  * pools of the threads must be initialized again after it.
+  * @param arena The handler of the arena. */
+void json_arenaReset( jsonArena_t* arena );
+
+/** Get the number of json properties taken from an arena.
+  * @param arena The handler of the arena.
+  * @return The number of properties, including the cached ones. */
+unsigned int json_arenaUsed( jsonArena_t const* arena );
+
+/** Initialize the pool of a thread that allocates from an arena.
+  * The pool can be used to parse any number of documents. The properties of
+  * all of them are kept until the arena is reset.
+  * @param apool The handler of the pool of the thread.
+  * @param arena The shared arena.
+  * @param block Number of properties taken from the arena at a time.
+  *              Zero selects a default value.
+  * @return The pool to pass to json_createWithPool(). */
+jsonPool_t* json_arenaPoolInit( jsonArenaPool_t* apool, jsonArena_t* arena, unsigned int block );
+
+/** Structure to handle a parsed document that is shared by several threads.
+  * It owns the text and the pool of the document and it is destroyed when
+  * its last reference is released. A parsed document is never modified, so
+  * all the json_get functions can be called on it concurrently from any
+  * number of threads without locks. */
+typedef struct jsonDoc_s jsonDoc_t;
+struct jsonDoc_s {
+    json_t const* root;    /**< The root property of the document.         */
+    CHAR_T* str;           /**< The text of the document.                  */
+    jsonPool_t* pool;      /**< The pool of the properties.                */
+    unsigned int refs;     /**< Number of references to the document.      */
+    void (*destroy)( jsonDoc_t* doc ); /**< Frees the text and the pool.   */
+};
+
+/** Parse a string to get a shared document with one reference.
+  * @param doc The handler of the document.
+  * @param str String pointer with a JSON object. It will be modified.
+  * @param pool Custom json pool pointer.
+  * @param destroy Function called when the last reference is released,
+  *        to free str, pool and doc as needed. It can be a null pointer.
+  * @retval Null pointer if any was wrong in the parse process.
+  * @retval The root of the document if success. */
+json_t const* json_docCreate( jsonDoc_t* doc, CHAR_T* str, jsonPool_t* pool,
+                              void (*destroy)( jsonDoc_t* doc ) );
+
+/** Get the root of a shared document.
+  * @param doc The handler of the document.
+  * @return The root property of the document. */
+static inline json_t const* json_docRoot( jsonDoc_t const* doc ) {
+    return doc->root;
+}
+
+/** Add a reference to a shared document.
+  * It can be called from any thread that already holds a reference.
+  * To swap a published document for a new one, readers must hold a
+  * reference or the old one must be released after a grace period.
+  * @param doc The handler of the document. */
+void json_docRetain( jsonDoc_t* doc );
+
+/** Release a reference to a shared document.
+  * The document is destroyed when its last reference is released.
+  * @param doc The handler of the document. */
+void json_docRelease( jsonDoc_t* doc );
+
+/** Copy a json tree into a pool so the children of each object or array are
+  * allocated together, in breadth-first order. With a pool of consecutive
+  * properties, iterating the children of a property does not jump over the
+  * subtrees of its siblings. The strings are not copied, so the text of the
+  * original tree must be kept, but its pool can be reused. The spans of the
+  * copy refer to the original text and its descendants are not consecutive.
+  * @param json A valid handler of a json property. Its type must be JSON_OBJ or JSON_ARRAY.
+  * @param pool Custom json pool pointer for the copy.
+  * @retval Null pointer if the pool had not enough properties.
+  * @retval The handler of the copy if success. Its name is kept. */
+json_t const* json_compact( json_t const* json, jsonPool_t* pool );
+
+/** Get the number of bytes that json_extract() needs to copy a json property.
+  * @param json A valid handler of a json property.
+  * @return The size of its properties and strings in bytes. */
+size_t json_extractSize( json_t const* json );
+
+/** Copy a json property with all its properties and strings into a single
+  * block of memory, so the text and the pool of the original document can be
+  * released and only the block has to be kept. The properties are laid out as
+  * in json_compact() at the beginning of the block and the strings at the end.
+  * The spans of the copy are empty because the text of its objects and arrays
+  * is not copied.
+  * @param json A valid handler of a json property.
+  * @param out Block of memory with the alignment of a json_t, f.i. from malloc().
+  * @param cap Size of the block in bytes. See json_extractSize().
+  * @retval Null pointer if the block was too small.
+  * @retval The handler of the copy, at the beginning of the block, if success. */
+json_t const* json_extract( json_t const* json, void* out, size_t cap );
+
+#ifndef TINY_JSON_USE_WCHAR
+
+/** Parse a string with its structural index to get a json.
+  * The index holds the positions of every quotation mark that is not escaped
+  * and of every '{', '}', '[', ']', ':' and ',' out of strings, in ascending
+  * order. It accepts the same texts as json_createWithPool(), but strings
+  * without escape characters are terminated without scanning them.
+  * See tiny-json-index.h to build the index with several threads.
+  * @param str String pointer with a JSON object. It will be modified.
+  * @param index Positions of the structural characters of str.
+  * @param qty Number of positions of the index.
+  * @param pool Custom json pool pointer.
+  * @retval Null pointer if any was wrong in the parse process.
+  * @retval If the parser process was successfully a valid handler of a json.
+  *         This property is always unnamed and its type is JSON_OBJ. */
+json_t const* json_createWithIndex( char* str, size_t const* index, size_t qty, jsonPool_t* pool );
+
+#endif
+
 /** @ } */
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif	/* _TINY_JSON_H_ */
+/* The engine of the wide API keeps the names to build itself. */
+#if defined(TINY_JSON_WIDE_NAMES) && !defined(TINY_JSON_WIDE_ENGINE)
+#undef CHAR_T
+#undef json_s
+#undef json_t
+#undef jsonPool_s
+#undef jsonPool_t
+#undef json_create
+#undef json_createWithPool
+#undef json_getName
+#undef json_getValue
+#undef json_getType
+#undef json_getSibling
+#undef json_getProperty
+#undef json_getPropertyValue
+#undef json_getChild
+#undef json_getBoolean
+#undef json_getInteger
+#undef json_getReal
+#undef jsonArena_s
+#undef jsonArena_t
+#undef jsonArenaPool_s
+#undef jsonArenaPool_t
+#undef json_arenaInit
+#undef json_arenaReset
+#undef json_arenaUsed
+#undef json_arenaPoolInit
+#undef jsonDoc_s
+#undef jsonDoc_t
+#undef json_docCreate
+#undef json_docRoot
+#undef json_docRetain
+#undef json_docRelease
+#undef json_getParent
+#undef json_getDepth
+#undef json_getSpan
+#undef json_getDescendants
+#undef json_compact
+#undef json_extractSize
+#undef json_extract
+#undef jsonPoolEx_s
+#undef jsonPoolEx_t
+#undef json_createWithPoolEx
+#undef json_poolRelease
+#undef jsonStatsPool_s
+#undef jsonStatsPool_t
+#undef json_statsPoolInit
+#endif
+
+#endif	/* TINY_JSON_API_BODY */
@@ -0,0 +1,49 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSONW_H_
+#define	_TINY_JSONW_H_
+
+/* Wide character API of tiny-json. It declares the same types and functions
+ * as tiny-json.h with wchar_t strings and a W suffix in their names, e.g.
+ * jsonW_t, json_createW() or json_getPropertyW(). It can be included along
+ * with tiny-json.h and both parsers can be linked into the same binary.
+ * Do not define TINY_JSON_USE_WCHAR when using this header. */
+
+#ifdef TINY_JSON_USE_WCHAR
+#error "tiny-jsonw.h cannot be used when TINY_JSON_USE_WCHAR is defined."
+#endif
+
+#define TINY_JSON_USE_WCHAR
+#define TINY_JSON_WIDE_NAMES
+#include "tiny-json.h"
+#undef TINY_JSON_WIDE_NAMES
+#undef TINY_JSON_USE_WCHAR
+
+#endif	/* _TINY_JSONW_H_ */
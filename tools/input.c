@@ -0,0 +1,117 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "input.h"
+
+/** Number of characters that isNdjson() reads at most. */
+#define PROBE_SIZE ( 1024 * 1024 )
+
+/* Map a file in memory, or read the standard input if the name is "-". */
+char* loadInput( char const* name, size_t* len, bool* mapped ) {
+    *mapped = false;
+    if ( !strcmp( name, "-" ) ) {
+        size_t cap = 1 << 16;
+        char* text = (char*)malloc( cap );
+        *len = 0;
+        while( text ) {
+            *len += fread( text + *len, 1, cap - *len, stdin );
+            if ( *len < cap ) return text;
+            char* const bigger = (char*)realloc( text, cap *= 2 );
+            if ( !bigger ) free( text );
+            text = bigger;
+        }
+        return 0;
+    }
+    int const fd = open( name, O_RDONLY );
+    if ( fd < 0 ) return 0;
+    struct stat st;
+    char* text = 0;
+    if ( !fstat( fd, &st ) ) {
+        *len = (size_t)st.st_size;
+        if ( !*len ) text = (char*)malloc( 1 );
+        else {
+            void* const map = mmap( 0, *len, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if ( map != MAP_FAILED ) {
+                posix_madvise( map, *len, POSIX_MADV_SEQUENTIAL );
+                text = (char*)map;
+                *mapped = true;
+            }
+        }
+    }
+    close( fd );
+    return text;
+}
+
+/* Free a text returned by loadInput(). */
+void unloadInput( char* text, size_t len, bool mapped ) {
+    if ( mapped ) munmap( text, len );
+    else free( text );
+}
+
+/* Check whether the first value of a text ends its line. */
+bool isNdjson( char const* text, size_t len ) {
+    while( len && isspace( (unsigned char)*text ) ) ++text, --len;
+    if ( !len ) return true;
+    size_t const probe = len < PROBE_SIZE ? len : PROBE_SIZE;
+    unsigned int depth = 0;
+    bool string = false;
+    size_t i;
+    for( i = 0; i < probe; ++i ) {
+        char const ch = text[i];
+        if ( string ) {
+            if ( ch == '\\' ) ++i;
+            else if ( ch == '\"' ) string = false;
+            else if ( ch == '\n' ) return false;
+            if ( string || depth ) continue;
+            break;
+        }
+        if ( ch == '\n' ) return !depth;
+        if ( ch == '\"' ) string = true;
+        else if ( ch == '{' || ch == '[' ) ++depth;
+        else if ( ch == '}' || ch == ']' ) {
+            if ( !depth ) return false;
+            if ( !--depth ) break;
+        }
+        else if ( !depth && isspace( (unsigned char)ch ) ) break;
+    }
+    if ( i >= probe ) return probe == len && !depth && !string;
+    for( ++i; i < probe && text[i] != '\n'; ++i )
+        if ( !isspace( (unsigned char)text[i] ) ) return false;
+    return i < probe || probe == len;
+}
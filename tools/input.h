@@ -0,0 +1,56 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#ifndef _TINY_JSON_TOOLS_INPUT_H_
+#define	_TINY_JSON_TOOLS_INPUT_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/** Map a file in memory, or read the standard input if the name is "-".
+  * @param name The name of the file.
+  * @param len Pointer to store the length.
+  * @param mapped Pointer to store whether it was mapped or allocated.
+  * @return The text or null pointer if error. */
+char* loadInput( char const* name, size_t* len, bool* mapped );
+
+/** Free a text returned by loadInput().
+  * @param text The text.
+  * @param len Its length.
+  * @param mapped Whether it was mapped. */
+void unloadInput( char* text, size_t len, bool mapped );
+
+/** Check whether the first value of a text ends its line, which is taken as
+  * a stream of lines. The text is not parsed: the nesting of the brackets is
+  * followed, and only in the first megabyte, so a document whose first value
+  * is longer or spans several lines is taken as a single document. A blank
+  * text is taken as an empty stream of lines. */
+bool isNdjson( char const* text, size_t len );
+
+#endif	/* _TINY_JSON_TOOLS_INPUT_H_ */
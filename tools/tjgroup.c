@@ -0,0 +1,200 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+/*
+ * tjgroup counts the lines of NDJSON files by group with several threads:
+ *
+ *     tjgroup [-t threads] [-k path]... [-a aggregate]... [-p string]... [file...]
+ *
+ * Each -k adds a dotted path to the key of the groups and each -a adds an
+ * aggregate: count, sum:path, min:path, max:path or distinct:path. Lines that
+ * do not contain all the -p strings are skipped before parsing them. A line
+ * per group is written as a JSON object with the keys and the aggregates.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include <unistd.h>
+#include "../tiny-json.h"
+#include "../tiny-json-aggregate.h"
+#include "input.h"
+
+/** Names of the aggregates in the command line. */
+static char const* const names[] = { "count", "sum", "min", "max", "distinct" };
+
+/** Parse an aggregate of the command line, f.i. "sum:req.bytes".
+  * @retval 0 if success.
+  * @retval -1 if it is not valid. */
+static int parseAggregate( char const* arg, jsonAggregate_t* aggregate ) {
+    size_t const len = strcspn( arg, ":" );
+    unsigned int i;
+    for( i = 0; i < sizeof names / sizeof *names; ++i ) {
+        if ( strlen( names[i] ) != len || strncmp( arg, names[i], len ) ) continue;
+        aggregate->type = (jsonAggregateType_t)i;
+        aggregate->path = arg[ len ] ? arg + len + 1 : 0;
+        return aggregate->type == JSON_COUNT || aggregate->path ? 0 : -1;
+    }
+    return -1;
+}
+
+/** Append a null-terminated string to a buffer. */
+static int append( jsonBuffer_t* out, char const* str ) {
+    return json_bufferAppend( out, str, strlen( str ) );
+}
+
+/** Append a number, without decimals if it is an integer. */
+static int appendNumber( jsonBuffer_t* out, double value ) {
+    char text[32];
+    if ( isnan( value ) ) strcpy( text, "null" );
+    else if ( value == floor( value ) && fabs( value ) < 9007199254740992.0 )
+        json_formatInteger( (int64_t)value, text, sizeof text );
+    else json_formatReal( value, text, sizeof text );
+    return append( out, text );
+}
+
+/** Append the name of an aggregate as a JSON string, f.i. "sum(req.bytes)".
+  * @param label Buffer where the name is built before escaping it. */
+static int appendLabel( jsonBuffer_t* out, jsonBuffer_t* label, jsonAggregate_t const* aggregate ) {
+    label->len = 0;
+    if ( append( label, names[ aggregate->type ] ) ) return -1;
+    if ( aggregate->path && ( append( label, "(" ) || append( label, aggregate->path ) || append( label, ")" ) ) ) return -1;
+    return json_bufferAppendString( out, label->data, label->len );
+}
+
+/** Append a group as a JSON object in a line. */
+static int appendGroup( jsonBuffer_t* out, jsonBuffer_t* label, jsonGroups_t const* groups, size_t i, char* const* keys, jsonAggregate_t const* aggregates ) {
+    unsigned int k;
+    for( k = 0; k < groups->keyQty; ++k ) {
+        if ( append( out, k ? "," : "{" ) ) return -1;
+        if ( json_bufferAppendString( out, keys[k], strlen( keys[k] ) ) || append( out, ":" ) ) return -1;
+        char const* const value = json_groupKey( groups, i, k );
+        jsonType_t const type = groups->types[ i * groups->keyQty + k ];
+        int const error = !value ? append( out, "null" )
+                        : type == JSON_TEXT ? json_bufferAppendString( out, value, strlen( value ) )
+                        : append( out, value );
+        if ( error ) return -1;
+    }
+    for( k = 0; k < groups->aggregateQty; ++k ) {
+        if ( append( out, k || groups->keyQty ? "," : "{" ) ) return -1;
+        if ( appendLabel( out, label, aggregates + k ) || append( out, ":" ) ) return -1;
+        if ( appendNumber( out, json_groupValue( groups, i, k ) ) ) return -1;
+    }
+    return append( out, "}\n" );
+}
+
+/** Write the groups as JSON objects, one per line.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int writeGroups( jsonGroups_t const* groups, char* const* keys, jsonAggregate_t const* aggregates ) {
+    jsonBuffer_t line = { 0, 0, 0 };
+    jsonBuffer_t label = { 0, 0, 0 };
+    int result = 0;
+    size_t i;
+    for( i = 0; !result && i < groups->qty; ++i ) {
+        line.len = 0;
+        result = appendGroup( &line, &label, groups, i, keys, aggregates );
+        if ( !result ) fwrite( line.data, 1, line.len, stdout );
+    }
+    free( label.data );
+    free( line.data );
+    return result;
+}
+
+/** Print the usage of the tool. */
+static int usage( void ) {
+    fputs( "usage: tjgroup [-t threads] [-k path]... [-a aggregate]... [-p string]... [file...]\n"
+           "  -k  dotted path of a key of the groups, f.i. host or req.method\n"
+           "  -a  count, sum:path, min:path, max:path or distinct:path\n"
+           "  -p  skip the lines without this string before parsing them\n"
+           "  -t  number of threads\n", stderr );
+    return 2;
+}
+
+int main( int argc, char* argv[] ) {
+    char** const keys = (char**)malloc( argc * sizeof( char* ) );
+    char const** const patterns = (char const**)malloc( argc * sizeof( char* ) );
+    jsonAggregate_t* const aggregates = (jsonAggregate_t*)malloc( ( argc + 1 ) * sizeof( jsonAggregate_t ) );
+    if ( !keys || !patterns || !aggregates ) return 2;
+    jsonGroupBy_t config = { 0, (char const* const*)keys, 0, aggregates, 0, patterns, 0 };
+    long threads = sysconf( _SC_NPROCESSORS_ONLN );
+    int arg;
+    for( arg = 1; arg < argc && argv[ arg ][0] == '-' && argv[ arg ][1]; ++arg ) {
+        char const* const option = argv[ arg ];
+        if ( arg + 1 == argc || option[2] ) return usage();
+        char* const value = argv[ ++arg ];
+        if ( option[1] == 'k' ) keys[ config.keyQty++ ] = value;
+        else if ( option[1] == 'p' ) patterns[ config.patternQty++ ] = value;
+        else if ( option[1] == 't' ) threads = atol( value );
+        else if ( option[1] != 'a' || parseAggregate( value, aggregates + config.aggregateQty++ ) )
+            return usage();
+    }
+    if ( !config.aggregateQty ) aggregates[ config.aggregateQty++ ] = (jsonAggregate_t){ JSON_COUNT, 0 };
+    config.threads = threads < 1 ? 1 : (unsigned int)threads;
+    char* const stdinName[] = { "-" };
+    char* const* files = arg < argc ? argv + arg : stdinName;
+    int const qty = arg < argc ? argc - arg : 1;
+    int status = 0;
+    int i;
+    for( i = 0; i < qty; ++i ) {
+        size_t len;
+        bool mapped;
+        char* const text = loadInput( files[i], &len, &mapped );
+        if ( !text ) {
+            fprintf( stderr, "tjgroup: cannot read %s\n", files[i] );
+            status = 2;
+            continue;
+        }
+        jsonGroups_t groups;
+        if ( json_groupBy( &config, text, len, &groups ) ) {
+            fprintf( stderr, "tjgroup: error processing %s\n", files[i] );
+            status = 2;
+        }
+        else {
+            if ( writeGroups( &groups, keys, aggregates ) ) {
+                fprintf( stderr, "tjgroup: not enough memory to write %s\n", files[i] );
+                status = 2;
+            }
+            if ( groups.invalid ) {
+                fprintf( stderr, "tjgroup: %lu lines of %s are not valid JSON\n", groups.invalid, files[i] );
+                if ( !status ) status = 1;
+            }
+            json_groupsFree( &groups );
+        }
+        unloadInput( text, len, mapped );
+    }
+    free( aggregates );
+    free( patterns );
+    free( keys );
+    return status;
+}
@@ -0,0 +1,598 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+/*
+ * tjq evaluates simple jq-like expressions over JSON files and NDJSON streams:
+ *
+ *     tjq [-r] [-s] [-l | -d] [-t threads] filter [file...]
+ *
+ * The filter is a pipe of stages. A stage is a path like '.', '.a.b',
+ * '.items[0]', '.items[]' or '."a key"', or a 'select( path )' or
+ * 'select( path op literal )' with op one of == != < <= > >= and literal a
+ * string, a number, true, false or null. Files are mapped in memory and the
+ * lines of NDJSON files are processed by several threads, each with its own
+ * pool, and written in order. gzip and zstd files are decompressed by
+ * another thread while their lines are processed. The lines that lack a
+ * key or a compared string of the filter are skipped before parsing them
+ * unless -s is given.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <limits.h>
+#include <unistd.h>
+#include "../tiny-json.h"
+#include "../tiny-json-ndjson.h"
+#include "../tiny-json-index.h"
+#include "../tiny-json-inflate.h"
+#include "input.h"
+
+/** Kinds of steps of a path. */
+typedef enum { STEP_KEY, STEP_INDEX, STEP_EACH } stepType_t;
+
+/** A step of a path: '.key', '[index]' or '[]'. */
+typedef struct step_s {
+    stepType_t type;
+    char* key;
+    long index;
+} step_t;
+
+/** Comparison operators of a select stage. */
+typedef enum { OP_NONE, OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE } op_t;
+
+/** A stage of the filter: a path or a select. */
+typedef struct stage_s {
+    bool select;           /**< It is a select stage.                      */
+    step_t* steps;         /**< The steps of the path.                     */
+    unsigned int qty;      /**< Number of steps.                           */
+    op_t op;               /**< Comparison of a select.                    */
+    jsonType_t type;       /**< Type of the literal.                       */
+    char* text;            /**< Text of a string literal.                  */
+    double number;         /**< Value of a number literal.                 */
+} stage_t;
+
+/** A compiled filter and the options of the output. */
+typedef struct filter_s {
+    stage_t* stages;
+    unsigned int qty;
+    bool raw;              /**< Write strings without quotation marks.     */
+    char** patterns;       /**< Strings that a line needs to match.        */
+    unsigned int patternQty;
+    unsigned long invalid; /**< Number of lines that are not valid JSON.   */
+} filter_t;
+
+/** Skip blanks of an expression. */
+static char const* skipBlanks( char const* ptr ) {
+    while( isspace( (unsigned char)*ptr ) ) ++ptr;
+    return ptr;
+}
+
+/** Parse a quoted string of an expression.
+  * @param ptr Pointer to the opening quotation mark.
+  * @param text Pointer to store the string allocated with malloc().
+  * @return Pointer after the closing quotation mark or null pointer if error. */
+static char const* parseQuoted( char const* ptr, char** text ) {
+    char* const str = (char*)malloc( strlen( ptr ) + 1 );
+    if ( !str ) return 0;
+    size_t len = 0;
+    for( ++ptr; *ptr != '\"'; ++ptr ) {
+        if ( !*ptr ) {
+            free( str );
+            return 0;
+        }
+        if ( *ptr == '\\' && ptr[1] ) ++ptr;
+        str[ len++ ] = *ptr;
+    }
+    str[ len ] = '\0';
+    *text = str;
+    return ptr + 1;
+}
+
+/** Parse a path of an expression into a stage.
+  * @return Pointer after the path or null pointer if error. */
+static char const* parsePath( char const* ptr, stage_t* stage ) {
+    ptr = skipBlanks( ptr );
+    if ( *ptr != '.' ) return 0;
+    size_t const max = strlen( ptr );
+    stage->steps = (step_t*)malloc( ( max + 1 ) * sizeof( step_t ) );
+    if ( !stage->steps ) return 0;
+    stage->qty = 0;
+    if ( ptr[1] == '[' || !ptr[1] || isspace( (unsigned char)ptr[1] ) || strchr( "|)=!<>", ptr[1] ) ) ++ptr;
+    for(;;) {
+        step_t* const step = stage->steps + stage->qty;
+        step->key = 0;
+        if ( *ptr == '.' ) {
+            ++ptr;
+            step->type = STEP_KEY;
+            if ( *ptr == '\"' ) {
+                ptr = parseQuoted( ptr, &step->key );
+                if ( !ptr ) return 0;
+            }
+            else {
+                char const* const begin = ptr;
+                while( isalnum( (unsigned char)*ptr ) || *ptr == '_' || *ptr == '-' ) ++ptr;
+                if ( ptr == begin ) return 0;
+                step->key = (char*)malloc( (size_t)( ptr - begin ) + 1 );
+                if ( !step->key ) return 0;
+                memcpy( step->key, begin, (size_t)( ptr - begin ) );
+                step->key[ ptr - begin ] = '\0';
+            }
+        }
+        else if ( *ptr == '[' ) {
+            ptr = skipBlanks( ptr + 1 );
+            if ( *ptr == ']' ) step->type = STEP_EACH;
+            else {
+                char* end;
+                step->type = STEP_INDEX;
+                step->index = strtol( ptr, &end, 10 );
+                if ( end == ptr ) return 0;
+                ptr = skipBlanks( end );
+                if ( *ptr != ']' ) return 0;
+            }
+            ++ptr;
+        }
+        else return ptr;
+        ++stage->qty;
+    }
+}
+
+/** Parse a literal of a select stage.
+  * @return Pointer after the literal or null pointer if error. */
+static char const* parseLiteral( char const* ptr, stage_t* stage ) {
+    ptr = skipBlanks( ptr );
+    if ( *ptr == '\"' ) {
+        stage->type = JSON_TEXT;
+        return parseQuoted( ptr, &stage->text );
+    }
+    static struct { char const* word; jsonType_t type; } const words[] = {
+        { "true", JSON_BOOLEAN }, { "false", JSON_BOOLEAN }, { "null", JSON_NULL }
+    };
+    unsigned int i;
+    for( i = 0; i < sizeof words / sizeof *words; ++i ) {
+        size_t const len = strlen( words[i].word );
+        if ( !strncmp( ptr, words[i].word, len ) ) {
+            stage->type = words[i].type;
+            stage->number = *ptr == 't';
+            return ptr + len;
+        }
+    }
+    char* end;
+    stage->type = JSON_REAL;
+    stage->number = strtod( ptr, &end );
+    return end == ptr ? 0 : end;
+}
+
+/** Compile a filter expression.
+  * @retval 0 if success.
+  * @retval -1 if the expression is not valid. */
+static int compile( char const* expr, filter_t* filter ) {
+    size_t const max = strlen( expr ) + 1;
+    filter->stages = (stage_t*)calloc( max, sizeof( stage_t ) );
+    if ( !filter->stages ) return -1;
+    filter->qty = 0;
+    char const* ptr = expr;
+    for(;;) {
+        stage_t* const stage = filter->stages + filter->qty++;
+        ptr = skipBlanks( ptr );
+        if ( !strncmp( ptr, "select", 6 ) ) {
+            stage->select = true;
+            ptr = skipBlanks( ptr + 6 );
+            if ( *ptr++ != '(' ) return -1;
+            ptr = parsePath( ptr, stage );
+            if ( !ptr ) return -1;
+            ptr = skipBlanks( ptr );
+            static struct { char const* str; op_t op; } const ops[] = {
+                { "==", OP_EQ }, { "!=", OP_NE }, { "<=", OP_LE },
+                { ">=", OP_GE }, { "<", OP_LT }, { ">", OP_GT }
+            };
+            unsigned int i;
+            for( i = 0; i < sizeof ops / sizeof *ops; ++i ) {
+                size_t const len = strlen( ops[i].str );
+                if ( !strncmp( ptr, ops[i].str, len ) ) {
+                    stage->op = ops[i].op;
+                    ptr = parseLiteral( ptr + len, stage );
+                    if ( !ptr ) return -1;
+                    break;
+                }
+            }
+            ptr = skipBlanks( ptr );
+            if ( *ptr++ != ')' ) return -1;
+        }
+        else {
+            ptr = parsePath( ptr, stage );
+            if ( !ptr ) return -1;
+        }
+        ptr = skipBlanks( ptr );
+        if ( !*ptr ) return 0;
+        if ( *ptr++ != '|' ) return -1;
+    }
+}
+
+/** Check whether a string is written in the same way in any JSON text.
+  * Characters that may be escaped are not. */
+static bool isVerbatim( char const* str ) {
+    for( ; *str; ++str )
+        if ( *str < 0x20 || *str > 0x7e || *str == '\"' || *str == '\\' || *str == '/' )
+            return false;
+    return true;
+}
+
+/** Add a pattern to the prefilter of a filter if it is not already there.
+  * @param quoted Add quotation marks around the string.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int addPattern( filter_t* filter, char const* str, bool quoted ) {
+    size_t const len = strlen( str );
+    char* const pattern = (char*)malloc( len + 3 );
+    if ( !pattern ) return -1;
+    if ( quoted ) sprintf( pattern, "\"%s\"", str );
+    else strcpy( pattern, str );
+    unsigned int i;
+    for( i = 0; i < filter->patternQty; ++i ) {
+        if ( !strcmp( filter->patterns[i], pattern ) ) {
+            free( pattern );
+            return 0;
+        }
+    }
+    filter->patterns[ filter->patternQty++ ] = pattern;
+    return 0;
+}
+
+/** Get the strings that every line with results contains: the literals of
+  * the equalities first, as they are usually rarer, and then the keys of all
+  * the paths, as no result is written when a key is missing.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory. */
+static int prefilter( filter_t* filter ) {
+    unsigned int max = 0;
+    unsigned int i;
+    for( i = 0; i < filter->qty; ++i ) max += filter->stages[i].qty + 1;
+    filter->patterns = (char**)malloc( ( max + 1 ) * sizeof( char* ) );
+    if ( !filter->patterns ) return -1;
+    for( i = 0; i < filter->qty; ++i ) {
+        stage_t const* const stage = filter->stages + i;
+        if ( !stage->select || stage->op != OP_EQ ) continue;
+        if ( stage->type == JSON_TEXT && isVerbatim( stage->text ) ) {
+            if ( addPattern( filter, stage->text, true ) ) return -1;
+        }
+        else if ( stage->type == JSON_BOOLEAN || stage->type == JSON_NULL ) {
+            char const* const word = stage->type == JSON_NULL ? "null" : stage->number ? "true" : "false";
+            if ( addPattern( filter, word, false ) ) return -1;
+        }
+    }
+    for( i = 0; i < filter->qty; ++i ) {
+        stage_t const* const stage = filter->stages + i;
+        unsigned int j;
+        for( j = 0; j < stage->qty; ++j ) {
+            char const* const key = stage->steps[j].key;
+            if ( key && isVerbatim( key ) && addPattern( filter, key, true ) ) return -1;
+        }
+    }
+    return 0;
+}
+
+/** Free the memory of a compiled filter. */
+static void release( filter_t* filter ) {
+    unsigned int i;
+    for( i = 0; i < filter->patternQty; ++i )
+        free( filter->patterns[i] );
+    free( filter->patterns );
+    for( i = 0; i < filter->qty; ++i ) {
+        stage_t* const stage = filter->stages + i;
+        unsigned int j;
+        for( j = 0; stage->steps && j < stage->qty; ++j )
+            free( stage->steps[j].key );
+        free( stage->steps );
+        free( stage->text );
+    }
+    free( filter->stages );
+}
+
+/** Write a property as compact JSON. The numbers, booleans and nulls are
+  * copied from the text validated by the parser. */
+static int writeValue( jsonBuffer_t* out, json_t const* json ) {
+    jsonType_t const type = json_getType( json );
+    if ( type != JSON_OBJ && type != JSON_ARRAY ) {
+        char const* const value = json_getValue( json );
+        size_t const len = strlen( value );
+        return type == JSON_TEXT ? json_bufferAppendString( out, value, len ) : json_bufferAppend( out, value, len );
+    }
+    if ( json_bufferAppend( out, type == JSON_OBJ ? "{" : "[", 1 ) ) return -1;
+    json_t const* child;
+    for( child = json_getChild( json ); child; child = json_getSibling( child ) ) {
+        if ( child != json_getChild( json ) && json_bufferAppend( out, ",", 1 ) ) return -1;
+        if ( type == JSON_OBJ ) {
+            char const* const name = json_getName( child );
+            if ( json_bufferAppendString( out, name, strlen( name ) ) ) return -1;
+            if ( json_bufferAppend( out, ":", 1 ) ) return -1;
+        }
+        if ( writeValue( out, child ) ) return -1;
+    }
+    return json_bufferAppend( out, type == JSON_OBJ ? "}" : "]", 1 );
+}
+
+/** Write a result of the filter in a line. */
+static int writeResult( filter_t const* filter, jsonBuffer_t* out, json_t const* json ) {
+    if ( filter->raw && json_getType( json ) == JSON_TEXT ) {
+        char const* const value = json_getValue( json );
+        if ( json_bufferAppend( out, value, strlen( value ) ) ) return -1;
+    }
+    else if ( writeValue( out, json ) ) return -1;
+    return json_bufferAppend( out, "\n", 1 );
+}
+
+/** Compare a property with the literal of a select stage. */
+static bool compare( stage_t const* stage, json_t const* json ) {
+    jsonType_t const type = json_getType( json );
+    int order;
+    if ( stage->type == JSON_TEXT && type == JSON_TEXT )
+        order = strcmp( json_getValue( json ), stage->text );
+    else if ( stage->type == JSON_REAL && ( type == JSON_INTEGER || type == JSON_REAL ) ) {
+        double const value = json_getReal( json );
+        order = value < stage->number ? -1 : value > stage->number;
+    }
+    else if ( stage->type == type && type == JSON_BOOLEAN )
+        order = json_getBoolean( json ) - (int)stage->number;
+    else if ( stage->type == type && type == JSON_NULL ) order = 0;
+    else return stage->op == OP_NE;
+    switch( stage->op ) {
+        case OP_EQ: return order == 0;
+        case OP_NE: return order != 0;
+        case OP_LT: return order < 0;
+        case OP_LE: return order <= 0;
+        case OP_GT: return order > 0;
+        case OP_GE: return order >= 0;
+        default:    return true;
+    }
+}
+
+static int evalStage( filter_t* filter, unsigned int index, json_t const* json, jsonBuffer_t* out );
+
+/** Apply the steps of a path from a step and go on with the next stage. */
+static int evalPath( filter_t* filter, unsigned int index, unsigned int step,
+                     json_t const* json, jsonBuffer_t* out, bool* found ) {
+    stage_t const* const stage = filter->stages + index;
+    if ( step == stage->qty ) {
+        if ( !stage->select ) return evalStage( filter, index + 1, json, out );
+        *found = *found || ( stage->op == OP_NONE
+                             ? json_getType( json ) != JSON_NULL
+                               && ( json_getType( json ) != JSON_BOOLEAN || json_getBoolean( json ) )
+                             : compare( stage, json ) );
+        return 0;
+    }
+    step_t const* const s = stage->steps + step;
+    jsonType_t const type = json_getType( json );
+    if ( s->type == STEP_KEY ) {
+        if ( type != JSON_OBJ ) return 0;
+        json_t const* const child = json_getProperty( json, s->key );
+        return child ? evalPath( filter, index, step + 1, child, out, found ) : 0;
+    }
+    if ( type != JSON_ARRAY && ( s->type == STEP_INDEX || type != JSON_OBJ ) ) return 0;
+    long count = 0;
+    json_t const* child;
+    if ( s->type == STEP_INDEX && s->index < 0 )
+        for( child = json_getChild( json ); child; child = json_getSibling( child ) ) ++count;
+    long const target = s->index < 0 ? count + s->index : s->index;
+    long i = 0;
+    for( child = json_getChild( json ); child; child = json_getSibling( child ), ++i ) {
+        if ( s->type == STEP_INDEX && i != target ) continue;
+        if ( evalPath( filter, index, step + 1, child, out, found ) ) return -1;
+        if ( s->type == STEP_INDEX ) break;
+    }
+    return 0;
+}
+
+/** Evaluate the filter from a stage and write its results. */
+static int evalStage( filter_t* filter, unsigned int index, json_t const* json, jsonBuffer_t* out ) {
+    if ( index == filter->qty ) return writeResult( filter, out, json );
+    bool found = false;
+    if ( evalPath( filter, index, 0, json, out, &found ) ) return -1;
+    if ( filter->stages[ index ].select && found ) return evalStage( filter, index + 1, json, out );
+    return 0;
+}
+
+/** Process a line of an NDJSON text. It is called from the threads. */
+static int processLine( void* ctx, json_t const* json, char const* line, size_t len, jsonBuffer_t* out ) {
+    filter_t* const filter = (filter_t*)ctx;
+    (void)line;
+    (void)len;
+    if ( !json ) {
+        __atomic_fetch_add( &filter->invalid, 1, __ATOMIC_RELAXED );
+        return 0;
+    }
+    return evalStage( filter, 0, json, out );
+}
+
+/** Write the output of a batch of lines. */
+static int emitBatch( void* ctx, char const* data, size_t len ) {
+    (void)ctx;
+    return fwrite( data, 1, len, stdout ) == len ? 0 : -1;
+}
+
+/** Parse a document with its structural index. Valid JSON has a structural
+  * character before each property but the root, so the pool starts with the
+  * number of positions plus one. It grows up to the worst case, a property
+  * every two characters, when values are separated by blanks only.
+  * @param str Copy of the text with its null character. The parser writes in it,
+  *        so it is copied again from the text before every retry.
+  * @param mem Pointer to the array of properties, reallocated as needed.
+  * @return The root of the document or null pointer if it is not valid.
+  *         It is also null and *mem too if there was not enough memory. */
+static json_t const* parseDocument( char* str, char const* text, size_t len, jsonIndex_t const* index, json_t** mem ) {
+    size_t const worst = len / 2 + 2;
+    size_t qty = index->qty + 1;
+    for(;;) {
+        if ( qty > worst ) qty = worst;
+        if ( qty > UINT_MAX ) break;
+        json_t* const bigger = (json_t*)realloc( *mem, qty * sizeof( json_t ) );
+        if ( !bigger ) break;
+        *mem = bigger;
+        jsonArena_t arena;
+        jsonArenaPool_t apool;
+        json_arenaInit( &arena, *mem, (unsigned int)qty );
+        json_t const* const json = json_createWithIndex( str, index->pos, index->qty,
+                                       json_arenaPoolInit( &apool, &arena, 0 ) );
+        if ( json || qty == worst || json_arenaUsed( &arena ) < qty ) return json;
+        memcpy( str, text, len );
+        qty *= 2;
+    }
+    free( *mem );
+    *mem = 0;
+    return 0;
+}
+
+/** Process a text with a single document, indexed by several threads. */
+static int processDocument( filter_t* filter, char const* text, size_t len, unsigned int threads ) {
+    char* const str = (char*)malloc( len + 1 );
+    if ( !str ) return -1;
+    memcpy( str, text, len );
+    str[ len ] = '\0';
+    int result = -1;
+    jsonIndex_t index;
+    if ( !json_indexBuild( &index, str, len, threads ) ) {
+        json_t* mem = 0;
+        json_t const* const json = parseDocument( str, text, len, &index, &mem );
+        jsonBuffer_t out = { 0, 0, 0 };
+        if ( !mem ) result = -1;
+        else if ( !json ) {
+            ++filter->invalid;
+            result = 0;
+        }
+        else if ( !evalStage( filter, 0, json, &out ) && !emitBatch( 0, out.data, out.len ) ) result = 0;
+        free( out.data );
+        free( mem );
+        json_indexFree( &index );
+    }
+    free( str );
+    return result;
+}
+
+/** Compressed text read by the decompression thread. */
+typedef struct compressed_s {
+    char const* data;
+    size_t len;
+    size_t pos;
+} compressed_t;
+
+/** Read the next bytes of a compressed text. */
+static size_t readCompressed( void* ctx, void* buf, size_t cap ) {
+    compressed_t* const src = (compressed_t*)ctx;
+    size_t const len = src->len - src->pos < cap ? src->len - src->pos : cap;
+    memcpy( buf, src->data + src->pos, len );
+    src->pos += len;
+    return len;
+}
+
+/** Print the usage of the tool. */
+static int usage( void ) {
+    fputs( "usage: tjq [-r] [-s] [-l | -d] [-t threads] filter [file...]\n"
+           "  -r  write strings without quotation marks\n"
+           "  -s  parse every line, also those without the keys and strings of the filter\n"
+           "  -l  one document per line (NDJSON)\n"
+           "  -d  one document per file\n"
+           "  -t  number of threads\n", stderr );
+    return 2;
+}
+
+int main( int argc, char* argv[] ) {
+    filter_t filter = { 0, 0, false, 0, 0, 0 };
+    long threads = sysconf( _SC_NPROCESSORS_ONLN );
+    bool strict = false;
+    int mode = 0;
+    int arg;
+    for( arg = 1; arg < argc && argv[ arg ][0] == '-' && argv[ arg ][1]; ++arg ) {
+        char const* const option = argv[ arg ];
+        if ( !strcmp( option, "-r" ) ) filter.raw = true;
+        else if ( !strcmp( option, "-s" ) ) strict = true;
+        else if ( !strcmp( option, "-l" ) ) mode = 'l';
+        else if ( !strcmp( option, "-d" ) ) mode = 'd';
+        else if ( !strcmp( option, "-t" ) && arg + 1 < argc ) threads = atol( argv[ ++arg ] );
+        else return usage();
+    }
+    if ( arg == argc ) return usage();
+    if ( compile( argv[ arg++ ], &filter ) ) {
+        fprintf( stderr, "tjq: invalid filter: %s\n", argv[ arg - 1 ] );
+        release( &filter );
+        return 2;
+    }
+    if ( !strict && prefilter( &filter ) ) {
+        fputs( "tjq: not enough memory\n", stderr );
+        release( &filter );
+        return 2;
+    }
+    if ( threads < 1 ) threads = 1;
+    char* const stdinName[] = { "-" };
+    char* const* names = arg < argc ? argv + arg : stdinName;
+    int const qty = arg < argc ? argc - arg : 1;
+    int status = 0;
+    int i;
+    for( i = 0; i < qty; ++i ) {
+        size_t len;
+        bool mapped;
+        char* const text = loadInput( names[i], &len, &mapped );
+        if ( !text ) {
+            fprintf( stderr, "tjq: cannot read %s\n", names[i] );
+            status = 2;
+            continue;
+        }
+        jsonNdjson_t const ndjson = {
+            .threads = (unsigned int)threads,
+            .ctx = &filter,
+            .process = processLine,
+            .emit = emitBatch,
+            .patterns = (char const* const*)filter.patterns,
+            .patternQty = filter.patternQty
+        };
+        int result;
+        if ( json_inflateFormat( text, len ) != JSON_PLAIN ) {
+            compressed_t source = { text, len, 0 };
+            jsonInflate_t const config = { 0, &source, readCompressed };
+            result = json_inflateRun( &config, &ndjson );
+        }
+        else if ( mode == 'd' || ( !mode && !isNdjson( text, len ) ) )
+            result = processDocument( &filter, text, len, (unsigned int)threads );
+        else result = json_ndjsonRun( &ndjson, text, len );
+        if ( result ) {
+            fprintf( stderr, "tjq: error processing %s\n", names[i] );
+            status = 2;
+        }
+        unloadInput( text, len, mapped );
+    }
+    if ( filter.invalid ) {
+        fprintf( stderr, "tjq: %lu documents are not valid JSON\n", filter.invalid );
+        if ( !status ) status = 1;
+    }
+    release( &filter );
+    return status;
+}
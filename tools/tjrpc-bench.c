@@ -0,0 +1,283 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+/*
+ * tjrpc-bench is a load generator for JSON-RPC 2.0 servers that read a
+ * request per line, as tjrpc:
+ *
+ *     tjrpc-bench [-c connections] [-n requests] [-d depth] [-b batch]
+ *                 [-m method] [-P params] [-a address] [-p port | -u path]
+ *
+ * Each connection runs in a thread and keeps depth requests in flight until it
+ * has sent its requests. A request can be a batch of calls. The throughput and
+ * the percentiles of the latency of the requests are written at the end.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/** Configuration and results of a connection. */
+typedef struct conn_s {
+    char const* address;
+    char const* port;      /**< Port of TCP or null pointer for Unix.      */
+    char const* path;      /**< Path of the Unix socket.                   */
+    char const* request;   /**< Line of a request.                         */
+    size_t len;            /**< Length of the line.                        */
+    unsigned long qty;     /**< Number of requests to send.                */
+    unsigned long depth;   /**< Number of requests in flight.              */
+    double* latencies;     /**< Latency of each request in microseconds.   */
+    unsigned long done;    /**< Number of responses received.              */
+    unsigned long errors;  /**< Number of responses with errors.           */
+    int failed;            /**< The connection failed.                     */
+    pthread_t thread;
+} conn_t;
+
+/** Current time in microseconds. */
+static double now( void ) {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/** Connect to the server.
+  * @return The socket or -1 if failed. */
+static int connectTo( char const* address, char const* port, char const* path ) {
+    if ( !port ) {
+        struct sockaddr_un addr;
+        if ( strlen( path ) >= sizeof addr.sun_path ) return -1;
+        memset( &addr, 0, sizeof addr );
+        addr.sun_family = AF_UNIX;
+        strcpy( addr.sun_path, path );
+        int const fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+        if ( fd < 0 ) return -1;
+        if ( !connect( fd, (struct sockaddr*)&addr, sizeof addr ) ) return fd;
+        close( fd );
+        return -1;
+    }
+    struct addrinfo hints;
+    memset( &hints, 0, sizeof hints );
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* list;
+    if ( getaddrinfo( address, port, &hints, &list ) ) return -1;
+    int fd = -1;
+    struct addrinfo* info;
+    for( info = list; info && fd < 0; info = info->ai_next ) {
+        fd = socket( info->ai_family, info->ai_socktype, info->ai_protocol );
+        if ( fd < 0 ) continue;
+        if ( !connect( fd, info->ai_addr, info->ai_addrlen ) ) {
+            int const one = 1;
+            setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one );
+            break;
+        }
+        close( fd );
+        fd = -1;
+    }
+    freeaddrinfo( list );
+    return fd;
+}
+
+/** Send a request.
+  * @retval 0 if success.
+  * @retval -1 if failed. */
+static int sendRequest( int fd, char const* request, size_t len ) {
+    while( len ) {
+        ssize_t const n = send( fd, request, len, MSG_NOSIGNAL );
+        if ( n <= 0 ) return -1;
+        request += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/** Send the requests of a connection and wait for their responses. */
+static void* run( void* arg ) {
+    conn_t* const conn = (conn_t*)arg;
+    int const fd = connectTo( conn->address, conn->port, conn->path );
+    double* const sent = (double*)malloc( conn->qty * sizeof( double ) );
+    size_t cap = 65536;
+    char* buffer = (char*)malloc( cap );
+    conn->failed = fd < 0 || !sent || !buffer;
+    unsigned long qty = 0;
+    size_t len = 0;
+    while( !conn->failed && conn->done < conn->qty ) {
+        for( ; qty < conn->qty && qty - conn->done < conn->depth; ++qty ) {
+            sent[ qty ] = now();
+            if ( sendRequest( fd, conn->request, conn->len ) ) conn->failed = 1;
+        }
+        if ( len + 4096 > cap ) {
+            char* const bigger = (char*)realloc( buffer, 2 * cap );
+            if ( !bigger ) break;
+            buffer = bigger;
+            cap *= 2;
+        }
+        ssize_t const n = recv( fd, buffer + len, cap - len - 1, 0 );
+        if ( n <= 0 ) {
+            conn->failed = 1;
+            break;
+        }
+        double const time = now();
+        size_t const scanned = len;
+        len += (size_t)n;
+        buffer[ len ] = '\0';
+        char* line = buffer;
+        char* end;
+        for( end = (char*)memchr( buffer + scanned, '\n', len - scanned ); end;
+             end = (char*)memchr( end + 1, '\n', len - (size_t)( end + 1 - buffer ) ) ) {
+            *end = '\0';
+            if ( conn->done == conn->qty ) break;
+            if ( strstr( line, "\"error\"" ) ) ++conn->errors;
+            conn->latencies[ conn->done ] = time - sent[ conn->done ];
+            ++conn->done;
+            line = end + 1;
+        }
+        len -= (size_t)( line - buffer );
+        memmove( buffer, line, len );
+    }
+    free( buffer );
+    free( sent );
+    if ( fd >= 0 ) close( fd );
+    return 0;
+}
+
+/** Compare two latencies for qsort(). */
+static int compare( void const* a, void const* b ) {
+    double const x = *(double const*)a;
+    double const y = *(double const*)b;
+    return x < y ? -1 : x > y;
+}
+
+/** Print the usage of the tool. */
+static int usage( void ) {
+    fputs( "usage: tjrpc-bench [-c connections] [-n requests] [-d depth] [-b batch]\n"
+           "                   [-m method] [-P params] [-a address] [-p port | -u path]\n"
+           "  -c  number of connections, 4 by default\n"
+           "  -n  number of requests per connection, 10000 by default\n"
+           "  -d  number of requests in flight per connection, 16 by default\n"
+           "  -b  number of calls of a batch per request, a single call by default\n"
+           "  -m  method to call, ping by default\n"
+           "  -P  JSON text of the params\n"
+           "  -a  address of the TCP server, 127.0.0.1 by default\n"
+           "  -p  port of the TCP server, 4000 by default\n"
+           "  -u  path of a Unix socket instead of TCP\n", stderr );
+    return 2;
+}
+
+int main( int argc, char* argv[] ) {
+    conn_t config;
+    memset( &config, 0, sizeof config );
+    config.address = "127.0.0.1";
+    config.port = "4000";
+    config.qty = 10000;
+    config.depth = 16;
+    unsigned long connections = 4;
+    unsigned long batch = 0;
+    char const* method = "ping";
+    char const* params = 0;
+    int arg;
+    for( arg = 1; arg < argc; ++arg ) {
+        char const* const option = argv[ arg ];
+        if ( option[0] != '-' || !option[1] || option[2] || arg + 1 == argc ) return usage();
+        char const* const value = argv[ ++arg ];
+        switch( option[1] ) {
+            case 'c': connections = strtoul( value, 0, 10 ); break;
+            case 'n': config.qty = strtoul( value, 0, 10 ); break;
+            case 'd': config.depth = strtoul( value, 0, 10 ); break;
+            case 'b': batch = strtoul( value, 0, 10 ); break;
+            case 'm': method = value; break;
+            case 'P': params = value; break;
+            case 'a': config.address = value; break;
+            case 'p': config.port = value; break;
+            case 'u': config.path = value; break;
+            default: return usage();
+        }
+    }
+    if ( !connections || !config.qty || !config.depth ) return usage();
+    if ( config.path ) config.port = 0;
+    size_t const callLen = strlen( method ) + ( params ? strlen( params ) : 0 ) + 64;
+    size_t const calls = batch ? batch : 1;
+    char* const request = (char*)malloc( calls * ( callLen + 1 ) + 3 );
+    conn_t* const conns = (conn_t*)calloc( connections, sizeof( conn_t ) );
+    double* const latencies = (double*)malloc( connections * config.qty * sizeof( double ) );
+    if ( !request || !conns || !latencies ) return 2;
+    size_t len = 0;
+    if ( batch ) request[ len++ ] = '[';
+    size_t i;
+    for( i = 0; i < calls; ++i ) {
+        if ( i ) request[ len++ ] = ',';
+        len += (size_t)sprintf( request + len, "{\"jsonrpc\":\"2.0\",\"method\":\"%s\"%s%s,\"id\":%lu}",
+                                method, params ? ",\"params\":" : "", params ? params : "", (unsigned long)i + 1 );
+    }
+    if ( batch ) request[ len++ ] = ']';
+    request[ len++ ] = '\n';
+    config.request = request;
+    config.len = len;
+    double const start = now();
+    for( i = 0; i < connections; ++i ) {
+        conns[i] = config;
+        conns[i].latencies = latencies + i * config.qty;
+        if ( pthread_create( &conns[i].thread, 0, run, conns + i ) ) {
+            fputs( "tjrpc-bench: cannot create the threads\n", stderr );
+            return 2;
+        }
+    }
+    unsigned long done = 0, errors = 0;
+    int status = 0;
+    for( i = 0; i < connections; ++i ) {
+        pthread_join( conns[i].thread, 0 );
+        memmove( latencies + done, conns[i].latencies, conns[i].done * sizeof( double ) );
+        done += conns[i].done;
+        errors += conns[i].errors;
+        if ( conns[i].failed ) status = 1;
+    }
+    double const seconds = ( now() - start ) / 1e6;
+    if ( status ) fputs( "tjrpc-bench: a connection failed\n", stderr );
+    if ( done ) {
+        qsort( latencies, done, sizeof( double ), compare );
+        printf( "requests:   %lu in %.3f s, %lu errors\n", done, seconds, errors );
+        printf( "throughput: %.0f requests/s, %.0f calls/s\n", done / seconds, done * calls / seconds );
+        printf( "latency:    p50 %.0f us, p90 %.0f us, p99 %.0f us, max %.0f us\n",
+                latencies[ done / 2 ], latencies[ done * 9 / 10 ], latencies[ done * 99 / 100 ], latencies[ done - 1 ] );
+    }
+    free( latencies );
+    free( conns );
+    free( request );
+    return status;
+}
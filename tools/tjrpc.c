@@ -0,0 +1,216 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+/*
+ * tjrpc is an example of a JSON-RPC 2.0 server over TCP or Unix sockets:
+ *
+ *     tjrpc [-t threads] [-a address] [-p port | -u path]
+ *
+ * It reads a request or a batch per line and writes a response per line. Its
+ * methods are ping, that returns "pong", echo, that returns its params, and
+ * sum, that returns the sum of the numbers of its params. It runs until it
+ * gets SIGINT or SIGTERM.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "../tiny-json.h"
+#include "../tiny-json-rpc.h"
+
+/** It is set by the signals to stop the server. */
+static sig_atomic_t volatile stop = 0;
+
+/** Set the flag that stops the server. */
+static void onSignal( int signal ) {
+    (void)signal;
+    stop = 1;
+}
+
+/** Append a null-terminated string to a buffer. */
+static int append( jsonBuffer_t* out, char const* str ) {
+    return json_bufferAppend( out, str, strlen( str ) );
+}
+
+/** Append a null-terminated string to a buffer as a JSON string. */
+static int appendString( jsonBuffer_t* out, char const* str ) {
+    return json_bufferAppendString( out, str, strlen( str ) );
+}
+
+/** Write a property as compact JSON. */
+static int writeValue( jsonBuffer_t* out, json_t const* json ) {
+    jsonType_t const type = json_getType( json );
+    if ( type == JSON_TEXT ) return appendString( out, json_getValue( json ) );
+    if ( type != JSON_OBJ && type != JSON_ARRAY ) return append( out, json_getValue( json ) );
+    if ( append( out, type == JSON_OBJ ? "{" : "[" ) ) return -1;
+    json_t const* child;
+    for( child = json_getChild( json ); child; child = json_getSibling( child ) ) {
+        if ( child != json_getChild( json ) && append( out, "," ) ) return -1;
+        if ( type == JSON_OBJ && ( appendString( out, json_getName( child ) ) || append( out, ":" ) ) ) return -1;
+        if ( writeValue( out, child ) ) return -1;
+    }
+    return append( out, type == JSON_OBJ ? "}" : "]" );
+}
+
+/** Method ping: return "pong". */
+static int ping( void* ctx, json_t const* params, jsonBuffer_t* out ) {
+    (void)ctx;
+    (void)params;
+    return append( out, "\"pong\"" ) ? JSON_RPC_INTERNAL_ERROR : 0;
+}
+
+/** Method echo: return the params. */
+static int echo( void* ctx, json_t const* params, jsonBuffer_t* out ) {
+    (void)ctx;
+    if ( !params ) return 0;
+    return writeValue( out, params ) ? JSON_RPC_INTERNAL_ERROR : 0;
+}
+
+/** Method sum: return the sum of the numbers of the params. */
+static int sum( void* ctx, json_t const* params, jsonBuffer_t* out ) {
+    (void)ctx;
+    double total = 0;
+    json_t const* child;
+    for( child = params ? json_getChild( params ) : 0; child; child = json_getSibling( child ) ) {
+        jsonType_t const type = json_getType( child );
+        if ( type != JSON_INTEGER && type != JSON_REAL ) {
+            append( out, "The params must be numbers" );
+            return JSON_RPC_INVALID_PARAMS;
+        }
+        total += json_getReal( child );
+    }
+    char text[32];
+    int const len = json_formatReal( total, text, sizeof text );
+    if ( len < 0 ) return JSON_RPC_INTERNAL_ERROR;
+    return json_bufferAppend( out, text, (size_t)len ) ? JSON_RPC_INTERNAL_ERROR : 0;
+}
+
+/** The methods of the server. */
+static jsonRpcMethod_t const methods[] = {
+    { "ping", ping },
+    { "echo", echo },
+    { "sum",  sum  }
+};
+
+/** Create a listening socket.
+  * @param address Address of a TCP socket.
+  * @param port Port of a TCP socket or null pointer for a Unix socket.
+  * @param path Path of a Unix socket.
+  * @return The socket or -1 if failed. */
+static int listenOn( char const* address, char const* port, char const* path ) {
+    if ( !port ) {
+        struct sockaddr_un addr;
+        if ( strlen( path ) >= sizeof addr.sun_path ) return -1;
+        memset( &addr, 0, sizeof addr );
+        addr.sun_family = AF_UNIX;
+        strcpy( addr.sun_path, path );
+        unlink( path );
+        int const fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+        if ( fd < 0 ) return -1;
+        if ( !bind( fd, (struct sockaddr*)&addr, sizeof addr ) && !listen( fd, SOMAXCONN ) ) return fd;
+        close( fd );
+        return -1;
+    }
+    struct addrinfo hints;
+    memset( &hints, 0, sizeof hints );
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    struct addrinfo* list;
+    if ( getaddrinfo( address, port, &hints, &list ) ) return -1;
+    int fd = -1;
+    struct addrinfo* info;
+    for( info = list; info && fd < 0; info = info->ai_next ) {
+        fd = socket( info->ai_family, info->ai_socktype, info->ai_protocol );
+        if ( fd < 0 ) continue;
+        int const one = 1;
+        setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one );
+        if ( !bind( fd, info->ai_addr, info->ai_addrlen ) && !listen( fd, SOMAXCONN ) ) break;
+        close( fd );
+        fd = -1;
+    }
+    freeaddrinfo( list );
+    return fd;
+}
+
+/** Print the usage of the tool. */
+static int usage( void ) {
+    fputs( "usage: tjrpc [-t threads] [-a address] [-p port | -u path]\n"
+           "  -t  number of threads for the elements of batches\n"
+           "  -a  address of the TCP socket, 127.0.0.1 by default\n"
+           "  -p  port of the TCP socket, 4000 by default\n"
+           "  -u  path of a Unix socket instead of TCP\n", stderr );
+    return 2;
+}
+
+int main( int argc, char* argv[] ) {
+    char const* address = "127.0.0.1";
+    char const* port = "4000";
+    char const* path = 0;
+    long threads = sysconf( _SC_NPROCESSORS_ONLN );
+    int arg;
+    for( arg = 1; arg < argc; ++arg ) {
+        char const* const option = argv[ arg ];
+        if ( option[0] != '-' || !option[1] || option[2] || arg + 1 == argc ) return usage();
+        char const* const value = argv[ ++arg ];
+        if ( option[1] == 'a' ) address = value;
+        else if ( option[1] == 'p' ) port = value;
+        else if ( option[1] == 'u' ) path = value;
+        else if ( option[1] == 't' ) threads = atol( value );
+        else return usage();
+    }
+    int const listener = listenOn( address, path ? 0 : port, path );
+    if ( listener < 0 ) {
+        fprintf( stderr, "tjrpc: cannot listen on %s\n", path ? path : port );
+        return 2;
+    }
+    jsonRpc_t rpc;
+    if ( json_rpcInit( &rpc, methods, sizeof methods / sizeof *methods, threads < 1 ? 1 : (unsigned int)threads, 0 ) ) {
+        fputs( "tjrpc: cannot create the dispatcher\n", stderr );
+        return 2;
+    }
+    struct sigaction action;
+    memset( &action, 0, sizeof action );
+    action.sa_handler = onSignal;
+    sigaction( SIGINT, &action, 0 );
+    sigaction( SIGTERM, &action, 0 );
+    int const status = json_rpcServe( &rpc, listener, &stop ) ? 2 : 0;
+    if ( status ) fputs( "tjrpc: the server failed\n", stderr );
+    json_rpcFree( &rpc );
+    close( listener );
+    if ( path ) unlink( path );
+    return status;
+}
@@ -0,0 +1,127 @@
+
+/*
+
+<https://github.com/rafagafe/tiny-json>
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+  SPDX-License-Identifier: MIT
+  Copyright (c) 2016-2018 Rafa Garcia <rafagarcia77@gmail.com>.
+
+  Permission is hereby  granted, free of charge, to any  person obtaining a copy
+  of this software and associated  documentation files (the "Software"), to deal
+  in the Software  without restriction, including without  limitation the rights
+  to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+  copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+  IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+  FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+  AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+  LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+/*
+ * tjschema infers a JSON Schema from a corpus of NDJSON files or JSON files
+ * with a document each:
+ *
+ *     tjschema [-t threads] [file...]
+ *
+ * The lines of NDJSON files are summarized by several threads. The schema
+ * lists the fields and types found in each path with their counts, the
+ * ranges of lengths, numbers and number of elements, and the maximum number
+ * of properties of a document, which is the pool that fits any of them.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "../tiny-json.h"
+#include "../tiny-json-schema.h"
+#include "input.h"
+
+/** Add a text with a single document to a schema.
+  * @retval 0 if success.
+  * @retval -1 if there was not enough memory or the document is too large. */
+static int addDocument( jsonSchema_t* schema, char const* text, size_t len ) {
+    if ( len / 2 + 2 > UINT_MAX ) return -1;
+    char* const str = (char*)malloc( len + 1 );
+    json_t* const mem = (json_t*)malloc( ( len / 2 + 2 ) * sizeof( json_t ) );
+    int result = -1;
+    if ( str && mem ) {
+        memcpy( str, text, len );
+        str[ len ] = '\0';
+        json_t const* const json = json_create( str, mem, len / 2 + 2 );
+        if ( json ) result = json_schemaAdd( schema, json );
+        else {
+            ++schema->invalid;
+            result = 0;
+        }
+    }
+    free( mem );
+    free( str );
+    return result;
+}
+
+/** Print the usage of the tool. */
+static int usage( void ) {
+    fputs( "usage: tjschema [-t threads] [file...]\n"
+           "  -t  number of threads\n", stderr );
+    return 2;
+}
+
+int main( int argc, char* argv[] ) {
+    long threads = sysconf( _SC_NPROCESSORS_ONLN );
+    int arg;
+    for( arg = 1; arg < argc && argv[ arg ][0] == '-' && argv[ arg ][1]; ++arg ) {
+        if ( strcmp( argv[ arg ], "-t" ) || arg + 1 == argc ) return usage();
+        threads = atol( argv[ ++arg ] );
+    }
+    if ( threads < 1 ) threads = 1;
+    char* const stdinName[] = { "-" };
+    char* const* files = arg < argc ? argv + arg : stdinName;
+    int const qty = arg < argc ? argc - arg : 1;
+    jsonSchema_t schema;
+    json_schemaInit( &schema );
+    int status = 0;
+    int i;
+    for( i = 0; i < qty; ++i ) {
+        size_t len;
+        bool mapped;
+        char* const text = loadInput( files[i], &len, &mapped );
+        if ( !text ) {
+            fprintf( stderr, "tjschema: cannot read %s\n", files[i] );
+            status = 2;
+            continue;
+        }
+        int const result = isNdjson( text, len )
+                         ? json_schemaInfer( &schema, (unsigned int)threads, text, len )
+                         : addDocument( &schema, text, len );
+        if ( result ) {
+            fprintf( stderr, "tjschema: error processing %s\n", files[i] );
+            status = 2;
+        }
+        unloadInput( text, len, mapped );
+    }
+    jsonBuffer_t out = { 0, 0, 0 };
+    if ( json_schemaWrite( &schema, &out ) || json_bufferAppend( &out, "\n", 1 ) ) status = 2;
+    else fwrite( out.data, 1, out.len, stdout );
+    if ( schema.invalid ) {
+        fprintf( stderr, "tjschema: %lu documents are not valid JSON\n", schema.invalid );
+        if ( !status ) status = 1;
+    }
+    free( out.data );
+    json_schemaFree( &schema );
+    return status;
+}